@@ -288,7 +288,9 @@ public ProductUserId GetProductUserId()
             /// <returns></returns>
             public string GetProductId()
             {
-                return Config.Get<ProductConfig>().ProductId.ToString("N").ToLowerInvariant();
+                return TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                    ? ToLowerCaseGuidString(nativeConfig.ProductId)
+                    : Config.Get<ProductConfig>().ProductId.ToString("N").ToLowerInvariant();
             }
 
             //-------------------------------------------------------------------------
@@ -298,7 +300,9 @@ public string GetProductId()
             /// <returns></returns>
             public string GetSandboxId()
             {
-                return PlatformManager.GetPlatformConfig().deployment.SandboxId.ToString();
+                return TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                    ? nativeConfig.SandboxId
+                    : PlatformManager.GetPlatformConfig().deployment.SandboxId.ToString();
             }
 
             //-------------------------------------------------------------------------
@@ -308,7 +312,9 @@ public string GetSandboxId()
             /// <returns></returns>
             public string GetDeploymentID()
             {
-                return PlatformManager.GetPlatformConfig().deployment.DeploymentId.ToString("N").ToLowerInvariant();
+                return TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                    ? ToLowerCaseGuidString(nativeConfig.DeploymentId)
+                    : PlatformManager.GetPlatformConfig().deployment.DeploymentId.ToString("N").ToLowerInvariant();
             }
 
             //-------------------------------------------------------------------------
@@ -318,7 +324,20 @@ public string GetDeploymentID()
             /// <returns></returns>
             public bool IsEncryptionKeyValid()
             {
-                return PlatformManager.GetPlatformConfig().clientCredentials.IsEncryptionKeyValid();
+                return TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                    ? EOSClientCredentials.IsEncryptionKeyValid(nativeConfig.EncryptionKey)
+                    : PlatformManager.GetPlatformConfig().clientCredentials.IsEncryptionKeyValid();
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Formats an id the way the managed configs format their Guids
+            /// (lower case, without dashes), so that the ids read from the
+            /// native config snapshot look the same as the managed ones.
+            /// </summary>
+            private static string ToLowerCaseGuidString(string id)
+            {
+                return Guid.TryParse(id, out Guid guid) ? guid.ToString("N").ToLowerInvariant() : id;
             }
 
             //-------------------------------------------------------------------------
@@ -340,8 +359,12 @@ public bool HasLoggedInWithConnect()
             //-------------------------------------------------------------------------
             public bool ShouldOverlayReceiveInput()
             {
+                bool alwaysSendInputToOverlay = TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                    ? nativeConfig.AlwaysSendInputToOverlay
+                    : PlatformManager.GetPlatformConfig().alwaysSendInputToOverlay;
+
                 return (s_isOverlayVisible && s_DoesOverlayHaveExcusiveInput)
-                       || PlatformManager.GetPlatformConfig().alwaysSendInputToOverlay
+                       || alwaysSendInputToOverlay
                     ;
             }
 
@@ -485,7 +508,9 @@ private void InitializeOverlay(IEOSCoroutineOwner coroutineOwner)
                 // Sets the button for the bringing up the overlay
                 var friendToggle = new SetToggleFriendsButtonOptions
                 {
-                    ButtonCombination = PlatformManager.GetPlatformConfig().toggleFriendsButtonCombination
+                    ButtonCombination = TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                        ? nativeConfig.ToggleFriendsButtonCombination
+                        : PlatformManager.GetPlatformConfig().toggleFriendsButtonCombination
                 };
                 UIInterface uiInterface = Instance.GetEOSPlatformInterface().GetUIInterface();
                 uiInterface.SetToggleFriendsButton(ref friendToggle);
@@ -869,7 +894,9 @@ private static void SimplePrintCallbackWithCallstack(LogMessage message)
                 return new LoginOptions
                 {
                     Credentials = loginCredentials,
-                    ScopeFlags = PlatformManager.GetPlatformConfig().authScopeOptionsFlags,
+                    ScopeFlags = TryGetNativeConfigSnapshot(out NativeConfigSnapshot nativeConfig)
+                        ? nativeConfig.AuthScopeFlags
+                        : PlatformManager.GetPlatformConfig().authScopeOptionsFlags,
                 };
             }
 
@@ -1565,6 +1592,7 @@ public void RemovePersistentToken()
             public void Tick()
             {
                 ExecuteQueuedMainThreadTasks();
+                DrainNativeLog();
                 if (GetEOSPlatformInterface() != null)
                 {
                     // Poll for any application constrained state change that didn't
@@ -1575,8 +1603,17 @@ public void Tick()
 
                     if (s_state != EOSState.Suspended)
                     {
-                        // Only tick if awake?
-                        GetEOSPlatformInterface().Tick();
+                        // Only tick if awake. The native plugin may tick the
+                        // platform itself, either from its tick driver thread
+                        // or by running this frame's ticks within the frame
+                        // budget.
+                        if (!IsNativeTickDriverRunning() && !TryTickWithinFrameBudget())
+                        {
+                            GetEOSPlatformInterface().Tick();
+                            PumpNativeP2PPackets();
+                        }
+                        DrainNativeNotifications();
+                        DrainNativeP2PPackets();
                         if (s_state == EOSState.Suspending)
                         {
                             // do anything needed to inform EOS systems they need to suspend
@@ -1607,9 +1644,17 @@ public void OnShutdown()
 
                     foreach (var epicUserID in loggedInAccountIDs)
                     {
+                        // The shutdown ticks the platform until the logouts
+                        // complete, or until its deadline passes.
+                        if (!BeginPendingRequest())
+                        {
+                            break;
+                        }
+
                         logoutOptions.LocalUserId = epicUserID;
                         EOSAuthInterface.Logout(ref logoutOptions, null, (ref LogoutCallbackInfo data) =>
                         {
+                            EndPendingRequest();
                             if (data.ResultCode != Result.Success)
                             {
                                 Log("failed to logout ");
@@ -1642,13 +1687,16 @@ public void OnApplicationShutdown()
                     Log("Waiting for pending finalizers.");
                     System.GC.WaitForPendingFinalizers();
 #endif
-                    Log("Releasing the EOS Platform Interface.");
-                    GetEOSPlatformInterface()?.Release();
-
-                    if (s_eosUnloadSDKOnShutdown)
+                    if (!TryShutdownNatively(s_eosUnloadSDKOnShutdown))
                     {
-                        Log("Shutting down the platform interface.");
-                        ShutdownPlatformInterface();
+                        Log("Releasing the EOS Platform Interface.");
+                        GetEOSPlatformInterface()?.Release();
+
+                        if (s_eosUnloadSDKOnShutdown)
+                        {
+                            Log("Shutting down the platform interface.");
+                            ShutdownPlatformInterface();
+                        }
                     }
 
                     SetEOSPlatformInterface(null);
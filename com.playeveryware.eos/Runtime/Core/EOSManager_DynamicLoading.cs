@@ -33,6 +33,7 @@
 using System.Collections;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Text;
 using System;
 
 #if !EOS_DISABLE
@@ -52,6 +53,10 @@ public partial class EOSSingleton
 #if !EOS_DISABLE
             static private PlatformInterface s_eosPlatformInterface;
 
+            // Copied from the native plugin on first use, see
+            // TryGetNativeConfigSnapshot.
+            static private NativeConfigSnapshot s_nativeConfigSnapshot;
+
             public const string EOSBinaryName = Epic.OnlineServices.Config.LibraryName;
 
 #if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
@@ -72,12 +77,440 @@ public partial class EOSSingleton
             [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
             static extern IntPtr EOS_GetPlatformInterface();
 
-            [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
-            delegate void PrintDelegateType(string str);
             [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
-            static extern void global_log_flush_with_function(IntPtr ptr);
+            static extern void global_log_peek_batch(out IntPtr data, out UIntPtr length);
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void global_log_consume_batch(UIntPtr length);
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern IntPtr PEW_EOS_GetConfigSnapshot();
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            static extern bool PEW_EOS_IsTickDriverRunning();
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            static extern bool PEW_EOS_TickWithinFrameBudget();
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_EOS_SetLoadingScreenActive([MarshalAs(UnmanagedType.I1)] bool isLoading);
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern ulong PEW_EOS_QueuePeerConnectionRequests(IntPtr localUserId, [MarshalAs(UnmanagedType.LPUTF8Str)] string socketName);
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern ulong PEW_EOS_QueueLobbyNotifications();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern ulong PEW_EOS_QueuePresenceNotifications();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern ulong PEW_EOS_QueueRTCParticipantStatus(IntPtr localUserId, [MarshalAs(UnmanagedType.LPUTF8Str)] string roomName);
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_EOS_RemoveQueuedNotifications(ulong subscriptionId);
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_EOS_DrainNotifications(out NativeNotificationQueue.Batch batch);
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            static extern bool PEW_P2P_StartReceivePump(IntPtr localUserId);
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_P2P_StopReceivePump();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_P2P_PumpAfterTick();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_P2P_DrainBatch(out NativeP2PReceiver.Batch batch);
+
+            /// <summary>
+            /// Mirrors the ShutdownReport struct of the native plugin.
+            /// </summary>
+            [StructLayout(LayoutKind.Sequential)]
+            private struct NativeShutdownReport
+            {
+                public uint TimedOut;
+                public uint PendingRequestCount;
+                public uint DrainTickCount;
+                public uint SDKShutDown;
+                public ulong StopRequestsMicroseconds;
+                public ulong DrainMicroseconds;
+                public ulong FlushLogMicroseconds;
+                public ulong ReleasePlatformsMicroseconds;
+                public ulong ShutdownSDKMicroseconds;
+                public ulong TotalMicroseconds;
+            }
+
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            static extern bool PEW_EOS_BeginPendingRequest();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            static extern void PEW_EOS_EndPendingRequest();
+            [DllImport(GfxPluginNativeRenderPath,CallingConvention = CallingConvention.StdCall)]
+            [return: MarshalAs(UnmanagedType.I1)]
+            static extern bool PEW_EOS_Shutdown(uint deadlineInMilliseconds, [MarshalAs(UnmanagedType.I1)] bool shutdownSDK, out NativeShutdownReport report);
+
+            /// <summary>
+            /// The longest time the native shutdown waits for pending
+            /// requests, such as logouts, to complete.
+            /// </summary>
+            private const uint NativeShutdownDeadlineMilliseconds = 500;
+
+            // Set once the native P2P receive pump has been started. Packets
+            // are drained from then on, also after the pump is stopped.
+            static private bool s_isNativeP2PReceivePumpStarted;
+
+            // Reused between drains so that forwarding the native log does not
+            // allocate a new buffer every frame.
+            static private byte[] s_nativeLogBuffer = new byte[4096];
+#endif
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Forwards any messages logged by the native plugin to the Unity
+            /// console. The native side buffers messages as length-prefixed UTF-8
+            /// records; each batch is copied out with a single call and decoded
+            /// here, instead of calling back into managed code once per message.
+            /// </summary>
+            static private void DrainNativeLog()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                while (true)
+                {
+                    global_log_peek_batch(out IntPtr batch, out UIntPtr batchLengthPtr);
+                    int batchLength = (int)batchLengthPtr.ToUInt64();
+                    if (batch == IntPtr.Zero || batchLength == 0)
+                    {
+                        break;
+                    }
+
+                    if (s_nativeLogBuffer.Length < batchLength)
+                    {
+                        s_nativeLogBuffer = new byte[Math.Max(batchLength, s_nativeLogBuffer.Length * 2)];
+                    }
+                    Marshal.Copy(batch, s_nativeLogBuffer, 0, batchLength);
+
+                    // Record layout: 32-bit length, text, null terminator,
+                    // then padding up to a multiple of four bytes.
+                    int offset = 0;
+                    while (offset + sizeof(int) <= batchLength)
+                    {
+                        int lineLength = BitConverter.ToInt32(s_nativeLogBuffer, offset);
+                        SimplePrintStringCallback(Encoding.UTF8.GetString(s_nativeLogBuffer, offset + sizeof(int), lineLength));
+                        offset += (sizeof(int) + lineLength + 1 + 3) & ~3;
+                    }
+
+                    global_log_consume_batch(batchLengthPtr);
+                }
+#endif
+            }
+
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Gets the config values that the native plugin used to create
+            /// the platform, so that they do not have to be read from the
+            /// config files again. The snapshot is copied on the first call.
+            /// </summary>
+            /// <param name="snapshot">The config values.</param>
+            /// <returns>
+            /// True if the native plugin is in use and provided its configs.
+            /// </returns>
+            static private bool TryGetNativeConfigSnapshot(out NativeConfigSnapshot snapshot)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                if (s_nativeConfigSnapshot == null)
+                {
+                    NativeConfigSnapshot.TryCopy(PEW_EOS_GetConfigSnapshot(), out s_nativeConfigSnapshot);
+                }
+#endif
+                snapshot = s_nativeConfigSnapshot;
+                return snapshot != null;
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Determines whether the native plugin ticks the platform from a
+            /// thread of its own ("nativeTickRate" in the platform config), in
+            /// which case it must not also be ticked from managed code.
+            /// </summary>
+            static private bool IsNativeTickDriverRunning()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_IsTickDriverRunning();
+#else
+                return false;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Lets the native plugin run this frame's ticks, if the platform
+            /// config sets a frame budget ("frameBudgetInMilliseconds"). The
+            /// plugin then decides how many ticks to run from the measured
+            /// frame time.
+            /// </summary>
+            /// <returns>
+            /// True if the platform was ticked, false if it still needs to be.
+            /// </returns>
+            static private bool TryTickWithinFrameBudget()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_TickWithinFrameBudget();
+#else
+                return false;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Tells the native plugin whether a loading screen is up. While
+            /// it is, the plugin lets EOS use the whole frame budget instead
+            /// of holding the long frames against it.
+            /// </summary>
+            /// <param name="isLoading">Whether a loading screen is up.</param>
+            public void SetLoadingScreenActive(bool isLoading)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                PEW_EOS_SetLoadingScreenActive(isLoading);
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Has the native plugin queue incoming P2P connection requests,
+            /// which are then raised by NativeNotificationQueue.
+            /// </summary>
+            /// <param name="localUserId">The user to queue requests for.</param>
+            /// <param name="socketName">
+            /// The socket to queue requests for, or null for every socket.
+            /// </param>
+            /// <returns>
+            /// The id to pass to RemoveQueuedNotifications, or zero if the
+            /// requests cannot be queued.
+            /// </returns>
+            public ulong QueuePeerConnectionRequests(ProductUserId localUserId, string socketName)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_QueuePeerConnectionRequests(localUserId.InnerHandle, socketName);
+#else
+                return 0;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Has the native plugin queue lobby, lobby member and lobby
+            /// member status updates, which are then raised by
+            /// NativeNotificationQueue.
+            /// </summary>
+            /// <returns>
+            /// The id to pass to RemoveQueuedNotifications, or zero if the
+            /// updates cannot be queued.
+            /// </returns>
+            public ulong QueueLobbyNotifications()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_QueueLobbyNotifications();
+#else
+                return 0;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Has the native plugin queue presence changes, which are then
+            /// raised by NativeNotificationQueue.
+            /// </summary>
+            /// <returns>
+            /// The id to pass to RemoveQueuedNotifications, or zero if the
+            /// changes cannot be queued.
+            /// </returns>
+            public ulong QueuePresenceNotifications()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_QueuePresenceNotifications();
+#else
+                return 0;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Has the native plugin queue participant status changes in an
+            /// RTC room, which are then raised by NativeNotificationQueue.
+            /// </summary>
+            /// <param name="localUserId">The user in the room.</param>
+            /// <param name="roomName">The room.</param>
+            /// <returns>
+            /// The id to pass to RemoveQueuedNotifications, or zero if the
+            /// changes cannot be queued.
+            /// </returns>
+            public ulong QueueRTCParticipantStatus(ProductUserId localUserId, string roomName)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_QueueRTCParticipantStatus(localUserId.InnerHandle, roomName);
+#else
+                return 0;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Stops queuing the notifications of one of the Queue methods.
+            /// </summary>
+            /// <param name="subscriptionId">The id the method returned.</param>
+            public void RemoveQueuedNotifications(ulong subscriptionId)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                PEW_EOS_RemoveQueuedNotifications(subscriptionId);
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Raises the notifications that the native plugin queued since
+            /// the previous frame.
+            /// </summary>
+            static private void DrainNativeNotifications()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                PEW_EOS_DrainNotifications(out NativeNotificationQueue.Batch batch);
+                NativeNotificationQueue.Dispatch(batch);
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Lets the native plugin receive the P2P packets sent to the given
+            /// user, and raise them through NativeP2PReceiver.PacketReceived
+            /// once per frame. Packets must then no longer be received through
+            /// the P2P interface.
+            /// </summary>
+            /// <param name="localUserId">The user to receive packets for.</param>
+            /// <returns>
+            /// True if the native pump was started.
+            /// </returns>
+            public bool StartNativeP2PReceivePump(ProductUserId localUserId)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                s_isNativeP2PReceivePumpStarted = PEW_P2P_StartReceivePump(localUserId.InnerHandle);
+                return s_isNativeP2PReceivePumpStarted;
+#else
+                return false;
 #endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Stops receiving P2P packets natively. Packets that were already
+            /// received are still raised.
+            /// </summary>
+            public void StopNativeP2PReceivePump()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                PEW_P2P_StopReceivePump();
+#endif
+            }
 
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Lets the native plugin receive the P2P packets after the platform
+            /// was ticked from managed code. Must be called right after the
+            /// tick, since the SDK may only be called from the ticking thread.
+            /// </summary>
+            static private void PumpNativeP2PPackets()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                if (s_isNativeP2PReceivePumpStarted)
+                {
+                    PEW_P2P_PumpAfterTick();
+                }
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Raises the P2P packets that the native plugin received since the
+            /// previous frame.
+            /// </summary>
+            static private void DrainNativeP2PPackets()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                if (!s_isNativeP2PReceivePumpStarted)
+                {
+                    return;
+                }
+
+                PEW_P2P_DrainBatch(out NativeP2PReceiver.Batch batch);
+                NativeP2PReceiver.Dispatch(batch);
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Marks a request as pending, so that the native shutdown waits
+            /// for its callback before releasing the platform. Call
+            /// EndPendingRequest from the callback.
+            /// </summary>
+            /// <returns>
+            /// False if the shutdown has started, in which case the request
+            /// should not be made.
+            /// </returns>
+            static private bool BeginPendingRequest()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                return PEW_EOS_BeginPendingRequest();
+#else
+                return true;
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Marks a request that was passed to BeginPendingRequest as
+            /// completed.
+            /// </summary>
+            static private void EndPendingRequest()
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                PEW_EOS_EndPendingRequest();
+#endif
+            }
+
+            //-------------------------------------------------------------------------
+            /// <summary>
+            /// Lets the native plugin release every platform (and shut the SDK
+            /// down, if asked to) after ticking them until the pending requests
+            /// complete, or the deadline passes.
+            /// </summary>
+            /// <param name="shutdownSDK">Whether to call EOS_Shutdown.</param>
+            /// <returns>
+            /// True if the native shutdown ran and released the platforms, in
+            /// which case they must not be released from managed code. False if
+            /// the native plugin is not used, if another shutdown is in progress,
+            /// or if the SDK has already been shut down.
+            /// </returns>
+            private bool TryShutdownNatively(bool shutdownSDK)
+            {
+#if USE_EOS_GFX_PLUGIN_NATIVE_RENDER
+                bool hasShutdown = PEW_EOS_Shutdown(NativeShutdownDeadlineMilliseconds, shutdownSDK, out NativeShutdownReport report);
+                if (hasShutdown)
+                {
+                    if (report.TimedOut != 0)
+                    {
+                        Log($"{report.PendingRequestCount} pending request(s) were abandoned by the shutdown.", UnityEngine.LogType.Warning);
+                    }
+
+                    Log($"Native shutdown took {report.TotalMicroseconds / 1000.0:F1} ms " +
+                        $"(draining {report.DrainMicroseconds / 1000.0:F1} ms over {report.DrainTickCount} tick(s), " +
+                        $"releasing platforms {report.ReleasePlatformsMicroseconds / 1000.0:F1} ms, " +
+                        $"shutting down the SDK {report.ShutdownSDKMicroseconds / 1000.0:F1} ms).");
+                }
+
+                // Forward what the native plugin logged while shutting down.
+                DrainNativeLog();
+                return hasShutdown;
+#else
+                return false;
+#endif
+            }
 
             //-------------------------------------------------------------------------
             public PlatformInterface GetEOSPlatformInterface()
@@ -86,9 +519,8 @@ public PlatformInterface GetEOSPlatformInterface()
                 if (s_eosPlatformInterface == null && s_state != EOSState.Shutdown)
                 {
                     // Try to log any messages stored when starting up the Plugin.
-                    IntPtr logErrorFunctionPointer = Marshal.GetFunctionPointerForDelegate(new PrintDelegateType(SimplePrintStringCallback));
                     SimplePrintStringCallback("Start of Early EOS LOG:");
-                    global_log_flush_with_function(logErrorFunctionPointer);
+                    DrainNativeLog();
                     SimplePrintStringCallback("End of Early EOS LOG");
 
                     if (EOS_GetPlatformInterface() == IntPtr.Zero)
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#if !EOS_DISABLE
+
+namespace PlayEveryWare.EpicOnlineServices
+{
+    using Epic.OnlineServices.Auth;
+    using Epic.OnlineServices.IntegratedPlatform;
+    using Epic.OnlineServices.Platform;
+    using Epic.OnlineServices.UI;
+    using System;
+    using System.Runtime.InteropServices;
+    using System.Text;
+
+    /// <summary>
+    /// The product and platform config values that the native plugin parsed
+    /// and used to create the EOS platform, copied out of the snapshot that
+    /// PEW_EOS_GetConfigSnapshot returns. Reading these avoids loading and
+    /// parsing the same config files again in managed code.
+    /// </summary>
+    public sealed class NativeConfigSnapshot
+    {
+        /// <summary>
+        /// The version of the native layout that this class can read. Must
+        /// match CONFIG_SNAPSHOT_VERSION in config_snapshot.h.
+        /// </summary>
+        public const uint SupportedVersion = 1;
+
+        /// <summary>
+        /// Reference to a null-terminated UTF-8 string stored after the
+        /// snapshot header.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        private struct SnapshotString
+        {
+            public uint Offset;
+            public uint Length;
+        }
+
+        /// <summary>
+        /// Mirror of the native ConfigSnapshot struct.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        private struct SnapshotHeader
+        {
+            public uint Version;
+            public uint TotalSize;
+
+            public SnapshotString ProductName;
+            public SnapshotString ProductVersion;
+            public SnapshotString ProductId;
+            public SnapshotString SandboxId;
+            public SnapshotString DeploymentId;
+            public SnapshotString ClientId;
+            public SnapshotString ClientSecret;
+            public SnapshotString EncryptionKey;
+            public SnapshotString CacheDirectory;
+            public SnapshotString OverrideCountryCode;
+            public SnapshotString OverrideLocaleCode;
+
+            public uint IsServer;
+            public int PlatformOptionsFlags;
+            public int AuthScopeFlags;
+            public int IntegratedPlatformManagementFlags;
+            public int TickBudgetInMilliseconds;
+            public uint HasThreadAffinity;
+            public double TaskNetworkTimeoutSeconds;
+
+            public ulong NetworkWork;
+            public ulong StorageIo;
+            public ulong WebSocketIo;
+            public ulong P2PIo;
+            public ulong HttpRequestIo;
+            public ulong RTCIo;
+            public ulong EmbeddedOverlayMainThread;
+            public ulong EmbeddedOverlayWorkerThreads;
+
+            public uint AlwaysSendInputToOverlay;
+            public float InitialButtonDelayForOverlay;
+            public float RepeatButtonDelayForOverlay;
+            public int ToggleFriendsButtonCombination;
+        }
+
+        public string ProductName { get; private set; }
+        public string ProductVersion { get; private set; }
+        public string ProductId { get; private set; }
+        public string SandboxId { get; private set; }
+        public string DeploymentId { get; private set; }
+        public string ClientId { get; private set; }
+        public string ClientSecret { get; private set; }
+        public string EncryptionKey { get; private set; }
+        public string CacheDirectory { get; private set; }
+        public string OverrideCountryCode { get; private set; }
+        public string OverrideLocaleCode { get; private set; }
+
+        public bool IsServer { get; private set; }
+        public PlatformFlags PlatformOptionsFlags { get; private set; }
+        public AuthScopeFlags AuthScopeFlags { get; private set; }
+        public IntegratedPlatformManagementFlags IntegratedPlatformManagementFlags { get; private set; }
+        public uint TickBudgetInMilliseconds { get; private set; }
+        public double TaskNetworkTimeoutSeconds { get; private set; }
+
+        /// <summary>
+        /// The thread affinity the SDK was initialized with, or null if the
+        /// native plugin left it to the SDK.
+        /// </summary>
+        public InitializeThreadAffinity? ThreadAffinity { get; private set; }
+
+        public bool AlwaysSendInputToOverlay { get; private set; }
+        public float InitialButtonDelayForOverlay { get; private set; }
+        public float RepeatButtonDelayForOverlay { get; private set; }
+        public InputStateButtonFlags ToggleFriendsButtonCombination { get; private set; }
+
+        private NativeConfigSnapshot() { }
+
+        /// <summary>
+        /// Copies a snapshot returned by PEW_EOS_GetConfigSnapshot. The copy
+        /// has to be made before the native function is called again.
+        /// </summary>
+        /// <param name="snapshotPointer">
+        /// The pointer returned by PEW_EOS_GetConfigSnapshot.
+        /// </param>
+        /// <param name="snapshot">The copied values.</param>
+        /// <returns>
+        /// True if the snapshot was copied, false if the pointer is null or
+        /// the snapshot has a layout this version cannot read.
+        /// </returns>
+        public static bool TryCopy(IntPtr snapshotPointer, out NativeConfigSnapshot snapshot)
+        {
+            snapshot = null;
+
+            if (snapshotPointer == IntPtr.Zero)
+            {
+                return false;
+            }
+
+            SnapshotHeader header = Marshal.PtrToStructure<SnapshotHeader>(snapshotPointer);
+            int headerSize = Marshal.SizeOf<SnapshotHeader>();
+            if (header.Version != SupportedVersion || header.TotalSize < headerSize)
+            {
+                return false;
+            }
+
+            // All of the strings are copied with a single call.
+            byte[] contents = new byte[header.TotalSize];
+            Marshal.Copy(snapshotPointer, contents, 0, contents.Length);
+
+            string GetString(SnapshotString value)
+            {
+                return Encoding.UTF8.GetString(contents, (int)value.Offset, (int)value.Length);
+            }
+
+            snapshot = new NativeConfigSnapshot()
+            {
+                ProductName = GetString(header.ProductName),
+                ProductVersion = GetString(header.ProductVersion),
+                ProductId = GetString(header.ProductId),
+                SandboxId = GetString(header.SandboxId),
+                DeploymentId = GetString(header.DeploymentId),
+                ClientId = GetString(header.ClientId),
+                ClientSecret = GetString(header.ClientSecret),
+                EncryptionKey = GetString(header.EncryptionKey),
+                CacheDirectory = GetString(header.CacheDirectory),
+                OverrideCountryCode = GetString(header.OverrideCountryCode),
+                OverrideLocaleCode = GetString(header.OverrideLocaleCode),
+
+                IsServer = header.IsServer != 0,
+                PlatformOptionsFlags = (PlatformFlags)header.PlatformOptionsFlags,
+                AuthScopeFlags = (AuthScopeFlags)header.AuthScopeFlags,
+                IntegratedPlatformManagementFlags = (IntegratedPlatformManagementFlags)header.IntegratedPlatformManagementFlags,
+                TickBudgetInMilliseconds = (uint)Math.Max(0, header.TickBudgetInMilliseconds),
+                TaskNetworkTimeoutSeconds = header.TaskNetworkTimeoutSeconds,
+
+                AlwaysSendInputToOverlay = header.AlwaysSendInputToOverlay != 0,
+                InitialButtonDelayForOverlay = header.InitialButtonDelayForOverlay,
+                RepeatButtonDelayForOverlay = header.RepeatButtonDelayForOverlay,
+                ToggleFriendsButtonCombination = (InputStateButtonFlags)header.ToggleFriendsButtonCombination,
+            };
+
+            if (header.HasThreadAffinity != 0)
+            {
+                snapshot.ThreadAffinity = new InitializeThreadAffinity()
+                {
+                    NetworkWork = header.NetworkWork,
+                    StorageIo = header.StorageIo,
+                    WebSocketIo = header.WebSocketIo,
+                    P2PIo = header.P2PIo,
+                    HttpRequestIo = header.HttpRequestIo,
+                    RTCIo = header.RTCIo,
+                    EmbeddedOverlayMainThread = header.EmbeddedOverlayMainThread,
+                    EmbeddedOverlayWorkerThreads = header.EmbeddedOverlayWorkerThreads,
+                };
+            }
+
+            return true;
+        }
+    }
+}
+
+#endif
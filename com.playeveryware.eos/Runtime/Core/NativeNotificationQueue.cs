@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#if !EOS_DISABLE
+
+namespace PlayEveryWare.EpicOnlineServices
+{
+    using Epic.OnlineServices;
+    using Epic.OnlineServices.Lobby;
+    using Epic.OnlineServices.P2P;
+    using Epic.OnlineServices.Presence;
+    using Epic.OnlineServices.RTC;
+    using System;
+    using System.Runtime.InteropServices;
+    using System.Text;
+
+    /// <summary>
+    /// Raises the EOS notifications that the native plugin queued since the
+    /// previous frame. The plugin records each notification into one buffer
+    /// instead of calling back into managed code for it, so a frame with many
+    /// lobby, presence or voice updates costs a single copy out of native
+    /// memory instead of one transition per notification. The events are
+    /// raised on the main thread, even when the platform is ticked by the
+    /// native tick driver.
+    /// </summary>
+    public static class NativeNotificationQueue
+    {
+        /// <summary>
+        /// Mirror of the native NotificationBatch struct.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct Batch
+        {
+            public IntPtr Data;
+            public uint Length;
+            public uint Count;
+            public ulong DroppedCount;
+        }
+
+        /// <summary>
+        /// Mirror of the native NotificationType enum.
+        /// </summary>
+        private enum NotificationType : uint
+        {
+            PeerConnectionRequest = 1,
+            LobbyUpdate = 2,
+            LobbyMemberUpdate = 3,
+            LobbyMemberStatus = 4,
+            RTCParticipantStatus = 5,
+            PresenceChanged = 6,
+        }
+
+        /// <summary>
+        /// Size of the header that every record starts with: the type and
+        /// the size of the record, both 32-bit.
+        /// </summary>
+        private const int HeaderSize = 8;
+
+        public static event Action<OnIncomingConnectionRequestInfo> PeerConnectionRequested;
+        public static event Action<LobbyUpdateReceivedCallbackInfo> LobbyUpdateReceived;
+        public static event Action<LobbyMemberUpdateReceivedCallbackInfo> LobbyMemberUpdateReceived;
+        public static event Action<LobbyMemberStatusReceivedCallbackInfo> LobbyMemberStatusReceived;
+        public static event Action<ParticipantStatusChangedCallbackInfo> ParticipantStatusChanged;
+        public static event Action<PresenceChangedCallbackInfo> PresenceChanged;
+
+        /// <summary>
+        /// The number of notifications the native plugin dropped because
+        /// its queue was full, since the plugin was loaded.
+        /// </summary>
+        public static ulong DroppedCount { get; private set; }
+
+        // Reused between drains so that copying the records does not
+        // allocate a new buffer every frame.
+        private static byte[] s_records = new byte[4096];
+
+        /// <summary>
+        /// Reads the fields of one record in the order they are laid out.
+        /// Every field after the header is naturally aligned, so reading
+        /// them one after the other matches the native layout for both
+        /// 32-bit and 64-bit handles.
+        /// </summary>
+        private struct RecordReader
+        {
+            private readonly int _recordStart;
+            private int _offset;
+
+            public RecordReader(int recordStart)
+            {
+                _recordStart = recordStart;
+                _offset = recordStart + HeaderSize;
+            }
+
+            public IntPtr ReadHandle()
+            {
+                IntPtr handle = IntPtr.Size == 8
+                    ? new IntPtr(BitConverter.ToInt64(s_records, _offset))
+                    : new IntPtr(BitConverter.ToInt32(s_records, _offset));
+                _offset += IntPtr.Size;
+                return handle;
+            }
+
+            public uint ReadUInt()
+            {
+                uint value = BitConverter.ToUInt32(s_records, _offset);
+                _offset += sizeof(uint);
+                return value;
+            }
+
+            public int ReadInt()
+            {
+                return (int)ReadUInt();
+            }
+
+            /// <summary>
+            /// Reads a NotificationString, and returns the offset of its
+            /// contents in the buffer along with its length.
+            /// </summary>
+            public void ReadStringRange(out int start, out int length)
+            {
+                start = _recordStart + (int)ReadUInt();
+                length = (int)ReadUInt();
+            }
+
+            public string ReadString()
+            {
+                ReadStringRange(out int start, out int length);
+                return Encoding.UTF8.GetString(s_records, start, length);
+            }
+        }
+
+        /// <summary>
+        /// Copies the records of a batch drained from the native plugin and
+        /// raises an event for each of them. The batch has to be dispatched
+        /// before the native queue is drained again.
+        /// </summary>
+        internal static void Dispatch(Batch batch)
+        {
+            DroppedCount = batch.DroppedCount;
+
+            int length = (int)batch.Length;
+            if (batch.Data == IntPtr.Zero || length == 0)
+            {
+                return;
+            }
+
+            if (s_records.Length < length)
+            {
+                s_records = new byte[Math.Max(length, s_records.Length * 2)];
+            }
+            Marshal.Copy(batch.Data, s_records, 0, length);
+
+            int offset = 0;
+            while (offset + HeaderSize <= length)
+            {
+                NotificationType type = (NotificationType)BitConverter.ToUInt32(s_records, offset);
+                int size = (int)BitConverter.ToUInt32(s_records, offset + sizeof(uint));
+                if (size < HeaderSize)
+                {
+                    break;
+                }
+
+                Dispatch(type, new RecordReader(offset));
+                offset += size;
+            }
+        }
+
+        private static void Dispatch(NotificationType type, RecordReader reader)
+        {
+            switch (type)
+            {
+                case NotificationType.PeerConnectionRequest:
+                {
+                    var info = new OnIncomingConnectionRequestInfo()
+                    {
+                        LocalUserId = new ProductUserId(reader.ReadHandle()),
+                        RemoteUserId = new ProductUserId(reader.ReadHandle()),
+                    };
+                    info.SocketId = new SocketId() { SocketName = reader.ReadString() };
+                    PeerConnectionRequested?.Invoke(info);
+                    break;
+                }
+                case NotificationType.LobbyUpdate:
+                {
+                    LobbyUpdateReceived?.Invoke(new LobbyUpdateReceivedCallbackInfo()
+                    {
+                        LobbyId = reader.ReadString(),
+                    });
+                    break;
+                }
+                case NotificationType.LobbyMemberUpdate:
+                {
+                    var info = new LobbyMemberUpdateReceivedCallbackInfo()
+                    {
+                        TargetUserId = new ProductUserId(reader.ReadHandle()),
+                    };
+                    info.LobbyId = reader.ReadString();
+                    LobbyMemberUpdateReceived?.Invoke(info);
+                    break;
+                }
+                case NotificationType.LobbyMemberStatus:
+                {
+                    var info = new LobbyMemberStatusReceivedCallbackInfo()
+                    {
+                        TargetUserId = new ProductUserId(reader.ReadHandle()),
+                    };
+                    info.LobbyId = reader.ReadString();
+                    info.CurrentStatus = (LobbyMemberStatus)reader.ReadInt();
+                    LobbyMemberStatusReceived?.Invoke(info);
+                    break;
+                }
+                case NotificationType.RTCParticipantStatus:
+                {
+                    var info = new ParticipantStatusChangedCallbackInfo()
+                    {
+                        LocalUserId = new ProductUserId(reader.ReadHandle()),
+                        ParticipantId = new ProductUserId(reader.ReadHandle()),
+                    };
+                    info.RoomName = reader.ReadString();
+                    info.ParticipantStatus = (RTCParticipantStatus)reader.ReadInt();
+                    info.ParticipantInBlocklist = reader.ReadUInt() != 0;
+
+                    // The keys and values follow each other, each one
+                    // followed by a null terminator.
+                    reader.ReadStringRange(out int metadataStart, out _);
+                    uint metadataCount = reader.ReadUInt();
+                    if (metadataCount > 0)
+                    {
+                        var metadata = new ParticipantMetadata[metadataCount];
+                        for (int index = 0; index < metadata.Length; ++index)
+                        {
+                            metadata[index].Key = ReadNullTerminated(ref metadataStart);
+                            metadata[index].Value = ReadNullTerminated(ref metadataStart);
+                        }
+                        info.ParticipantMetadata = metadata;
+                    }
+
+                    ParticipantStatusChanged?.Invoke(info);
+                    break;
+                }
+                case NotificationType.PresenceChanged:
+                {
+                    PresenceChanged?.Invoke(new PresenceChangedCallbackInfo()
+                    {
+                        LocalUserId = new EpicAccountId(reader.ReadHandle()),
+                        PresenceUserId = new EpicAccountId(reader.ReadHandle()),
+                    });
+                    break;
+                }
+            }
+        }
+
+        private static string ReadNullTerminated(ref int offset)
+        {
+            int end = Array.IndexOf(s_records, (byte)0, offset);
+            string value = Encoding.UTF8.GetString(s_records, offset, end - offset);
+            offset = end + 1;
+            return value;
+        }
+    }
+}
+
+#endif
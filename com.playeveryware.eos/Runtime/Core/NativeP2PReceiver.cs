@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#if !EOS_DISABLE
+
+namespace PlayEveryWare.EpicOnlineServices
+{
+    using Epic.OnlineServices;
+    using System;
+    using System.Collections.Generic;
+    using System.Runtime.InteropServices;
+    using System.Text;
+
+    /// <summary>
+    /// Raises the P2P packets that the native plugin received since the
+    /// previous frame. Once the native receive pump is started for a local
+    /// user, the plugin receives every packet after each tick, so a frame
+    /// costs one call and two copies out of native memory instead of two
+    /// calls and a buffer per packet. Packets are raised in the order they
+    /// were received within each channel, but not across channels.
+    /// </summary>
+    public static class NativeP2PReceiver
+    {
+        /// <summary>
+        /// A packet received by the native pump.
+        /// </summary>
+        public struct Packet
+        {
+            public ProductUserId PeerId;
+            public string SocketName;
+            public byte Channel;
+
+            /// <summary>
+            /// The payload. The array is reused for the packets of the
+            /// next frame, so copy anything that is needed after the event.
+            /// </summary>
+            public ArraySegment<byte> Data;
+        }
+
+        /// <summary>
+        /// Mirror of the native PacketBatch struct.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct Batch
+        {
+            public IntPtr Descriptors;
+            public uint DescriptorCount;
+            public uint PayloadSize;
+            public IntPtr PayloadArena;
+        }
+
+        /// <summary>
+        /// Size of the native PacketDescriptor struct: the peer handle,
+        /// followed by three 32-bit offsets and sizes and the channel, padded
+        /// to the alignment of the handle.
+        /// </summary>
+        private static readonly int DescriptorSize = IntPtr.Size + 16;
+
+        public static event Action<Packet> PacketReceived;
+
+        // Reused between drains so that copying the packets does not
+        // allocate new buffers every frame.
+        private static byte[] s_descriptors = new byte[4096];
+        private static byte[] s_payloads = new byte[16384];
+
+        // The same peers and sockets show up frame after frame, so their
+        // handles and names are only created once.
+        private static readonly Dictionary<IntPtr, ProductUserId> s_peerIds = new Dictionary<IntPtr, ProductUserId>();
+        private static readonly List<KeyValuePair<byte[], string>> s_socketNames = new List<KeyValuePair<byte[], string>>();
+
+        /// <summary>
+        /// Copies the packets of a batch drained from the native plugin and
+        /// raises an event for each of them. The batch has to be dispatched
+        /// before the native pump is drained again.
+        /// </summary>
+        internal static void Dispatch(Batch batch)
+        {
+            int count = (int)batch.DescriptorCount;
+            if (batch.Descriptors == IntPtr.Zero || count == 0)
+            {
+                return;
+            }
+
+            int descriptorsLength = count * DescriptorSize;
+            if (s_descriptors.Length < descriptorsLength)
+            {
+                s_descriptors = new byte[Math.Max(descriptorsLength, s_descriptors.Length * 2)];
+            }
+            Marshal.Copy(batch.Descriptors, s_descriptors, 0, descriptorsLength);
+
+            int payloadLength = (int)batch.PayloadSize;
+            if (s_payloads.Length < payloadLength)
+            {
+                s_payloads = new byte[Math.Max(payloadLength, s_payloads.Length * 2)];
+            }
+            Marshal.Copy(batch.PayloadArena, s_payloads, 0, payloadLength);
+
+            for (int index = 0; index < count; ++index)
+            {
+                int offset = index * DescriptorSize;
+                IntPtr peerHandle = IntPtr.Size == 8
+                    ? new IntPtr(BitConverter.ToInt64(s_descriptors, offset))
+                    : new IntPtr(BitConverter.ToInt32(s_descriptors, offset));
+                offset += IntPtr.Size;
+
+                int payloadOffset = (int)BitConverter.ToUInt32(s_descriptors, offset);
+                int payloadSize = (int)BitConverter.ToUInt32(s_descriptors, offset + 4);
+                int socketNameOffset = (int)BitConverter.ToUInt32(s_descriptors, offset + 8);
+                byte channel = s_descriptors[offset + 12];
+
+                PacketReceived?.Invoke(new Packet()
+                {
+                    PeerId = GetPeerId(peerHandle),
+                    SocketName = GetSocketName(socketNameOffset),
+                    Channel = channel,
+                    Data = new ArraySegment<byte>(s_payloads, payloadOffset, payloadSize),
+                });
+            }
+        }
+
+        private static ProductUserId GetPeerId(IntPtr handle)
+        {
+            if (!s_peerIds.TryGetValue(handle, out ProductUserId peerId))
+            {
+                peerId = new ProductUserId(handle);
+                s_peerIds.Add(handle, peerId);
+            }
+            return peerId;
+        }
+
+        private static string GetSocketName(int offset)
+        {
+            int length = Array.IndexOf(s_payloads, (byte)0, offset) - offset;
+
+            // Compare the bytes with the names seen before, so that a name
+            // is only decoded the first time it is received.
+            foreach (var knownSocketName in s_socketNames)
+            {
+                byte[] bytes = knownSocketName.Key;
+                if (bytes.Length != length)
+                {
+                    continue;
+                }
+
+                int index = 0;
+                while (index < length && bytes[index] == s_payloads[offset + index])
+                {
+                    ++index;
+                }
+
+                if (index == length)
+                {
+                    return knownSocketName.Value;
+                }
+            }
+
+            var socketNameBytes = new byte[length];
+            Array.Copy(s_payloads, offset, socketNameBytes, 0, length);
+            string socketName = Encoding.UTF8.GetString(socketNameBytes);
+            s_socketNames.Add(new KeyValuePair<byte[], string>(socketNameBytes, socketName));
+            return socketName;
+        }
+    }
+}
+
+#endif
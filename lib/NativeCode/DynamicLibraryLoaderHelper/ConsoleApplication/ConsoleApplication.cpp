@@ -20,11 +20,225 @@
  * SOFTWARE.
  */
 
+#include <pch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/config_blob.h"
+#include "include/config_snapshot.h"
 #include "include/eos_helpers.h"
+#include "include/flight_recorder.h"
 #include "include/logging.h"
+#include "include/platform_registry.h"
+#include "include/shutdown.h"
+#include "include/tick_driver.h"
+
+using namespace pew::eos;
+
+// Set when the process is asked to exit. Written from a signal handler (or,
+// on Windows, from the thread that runs console control handlers).
+static std::atomic<bool> s_exit_requested = false;
+
+#if PLATFORM_WINDOWS
+static BOOL WINAPI on_console_control(DWORD control_type)
+{
+    switch (control_type)
+    {
+    case CTRL_C_EVENT:
+    case CTRL_BREAK_EVENT:
+    case CTRL_CLOSE_EVENT:
+    case CTRL_SHUTDOWN_EVENT:
+        s_exit_requested = true;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+#else
+static void on_exit_signal(int)
+{
+    s_exit_requested = true;
+}
+#endif
+
+static void handle_exit_signals()
+{
+#if PLATFORM_WINDOWS
+    SetConsoleCtrlHandler(on_console_control, TRUE);
+#else
+    std::signal(SIGINT, on_exit_signal);
+    std::signal(SIGTERM, on_exit_signal);
+    std::signal(SIGHUP, on_exit_signal);
+#endif
+}
 
-int main()
+/**
+ * @brief Releases the log lines the plugin buffered for managed code. The
+ * host has the lines mirrored to stdout as they are logged, so nothing else
+ * reads the buffer, and once it is full every further line would be counted
+ * as dropped.
+ */
+static void release_buffered_log()
 {
+    const char* data = nullptr;
+    size_t length = 0;
+    do
+    {
+        logging::global_log_peek_batch(&data, &length);
+        logging::global_log_consume_batch(length);
+    } while (length > 0);
+}
+
+/**
+ * @brief Runs EOS server platforms without Unity, until the process is asked
+ * to exit.
+ *
+ * The default platform is created as a server platform from the native
+ * configs, and every further instance is created from a snapshot of the same
+ * configs. All of them are ticked by the platform registry at a fixed rate,
+ * on this thread, so the process runs no threads of its own besides the
+ * ones of the SDK.
+ *
+ * @param ticks_per_second The rate to tick every platform at.
+ * @param instance_count The number of server platforms to run.
+ * @return The exit code of the process.
+ */
+static int run_headless_host(uint32_t ticks_per_second, uint32_t instance_count)
+{
+    handle_exit_signals();
+
+    // The registry ticks the default platform along with the others, so the
+    // tick driver must not tick it as well: neither when the platform is
+    // created, nor when the platform config changes later on.
+    tick_driver::PEW_EOS_AllowTickDriver(false);
+
+    PEW_EOS_LoadAsServer();
+    if (EOS_GetPlatformInterface() == nullptr)
+    {
+        std::cerr << "The EOS platform could not be created." << std::endl;
+        UnityPluginUnload();
+        return 1;
+    }
+
+    platform_registry::PEW_EOS_SetPlatformTickRate(platform_registry::DEFAULT_PLATFORM_ID, ticks_per_second);
+
+    std::vector<platform_registry::PlatformId> platform_ids;
+    if (instance_count > 1)
+    {
+        // Copied, since the snapshot is only valid until it is requested
+        // again.
+        const config_snapshot::ConfigSnapshot* snapshot = config_snapshot::PEW_EOS_GetConfigSnapshot();
+        if (snapshot != nullptr)
+        {
+            std::vector<uint64_t> server_snapshot((snapshot->total_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            memcpy(server_snapshot.data(), snapshot, snapshot->total_size);
+            reinterpret_cast<config_snapshot::ConfigSnapshot*>(server_snapshot.data())->is_server = 1;
+
+            for (uint32_t instance = 1; instance < instance_count; ++instance)
+            {
+                const auto platform_id = platform_registry::PEW_EOS_CreatePlatform(
+                    reinterpret_cast<const config_snapshot::ConfigSnapshot*>(server_snapshot.data()), ticks_per_second);
+                if (platform_id != 0)
+                {
+                    platform_ids.push_back(platform_id);
+                }
+            }
+        }
+    }
+
+    // Printed directly, since the logging functions are not exported from
+    // the plugin.
+    std::cout << "Running " << (platform_ids.size() + 1) << " server platform(s) at " <<
+        ticks_per_second << " ticks per second." << std::endl;
+
+    // Wake up at least this often to notice a request to exit.
+    constexpr uint32_t MAX_WAIT_MICROSECONDS = 100'000;
+
+    while (!s_exit_requested)
+    {
+        const uint32_t wait_microseconds = platform_registry::PEW_EOS_TickPlatforms();
+        release_buffered_log();
+        std::this_thread::sleep_for(std::chrono::microseconds(std::min(wait_microseconds, MAX_WAIT_MICROSECONDS)));
+    }
+
+    std::cout << "Exit requested, shutting down." << std::endl;
+
+    // Releases every platform and shuts the SDK down. The stage timings are
+    // logged by the shutdown itself.
+    constexpr uint32_t SHUTDOWN_DEADLINE_MILLISECONDS = 2000;
+    shutdown::PEW_EOS_Shutdown(SHUTDOWN_DEADLINE_MILLISECONDS, true, nullptr);
+
+    UnityPluginUnload();
+    return 0;
+}
+
+/**
+ * @brief Parses an optional positive number argument.
+ *
+ * @return The number, the default value if the argument is absent, or zero
+ * if it is not a positive number.
+ */
+static uint32_t parse_count_argument(int argc, char* argv[], int index, uint32_t default_value)
+{
+    if (index >= argc)
+    {
+        return default_value;
+    }
+
+    char* end = nullptr;
+    const unsigned long value = strtoul(argv[index], &end, 10);
+    return (end != argv[index] && *end == '\0' && value > 0 && value <= UINT32_MAX) ? static_cast<uint32_t>(value) : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // Print the contents of a flight recorder file (for instance one left
+    // behind by a crashed process) instead of running the plugin.
+    if (argc == 3 && strcmp(argv[1], "--dump-flight-recorder") == 0)
+    {
+        const bool dumped = pew::eos::flight_recorder::PEW_EOS_FlightRecorder_Dump(argv[2],
+            [](const char* line) { std::cout << line << std::endl; });
+        if (!dumped)
+        {
+            std::cerr << "\"" << argv[2] << "\" is not a flight recorder file." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Compile the config files into a config blob, which the plugin reads
+    // instead of parsing the config files.
+    if (argc == 3 && strcmp(argv[1], "--compile-config") == 0)
+    {
+        pew::eos::logging::set_mirror_to_stdout(true);
+        return pew::eos::config_blob::PEW_EOS_CompileConfigBlob(argv[2]) ? 0 : 1;
+    }
+
+    // Run server platforms without Unity:
+    //   --headless [ticks per second (default 30)] [instance count (default 1)]
+    if (argc >= 2 && argc <= 4 && strcmp(argv[1], "--headless") == 0)
+    {
+        const uint32_t ticks_per_second = parse_count_argument(argc, argv, 2, 30);
+        const uint32_t instance_count = parse_count_argument(argc, argv, 3, 1);
+        if (ticks_per_second == 0 || instance_count == 0)
+        {
+            std::cerr << "Usage: " << argv[0] << " --headless [ticks per second] [instance count]" << std::endl;
+            return 1;
+        }
+
+        pew::eos::logging::set_mirror_to_stdout(true);
+        return run_headless_host(ticks_per_second, instance_count);
+    }
+
     pew::eos::logging::set_mirror_to_stdout(true);
     pew::eos::UnityPluginLoad(nullptr);
 
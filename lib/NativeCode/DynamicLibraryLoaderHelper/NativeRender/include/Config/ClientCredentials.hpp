@@ -27,6 +27,7 @@
 
 #include <string>
 
+#include "config_blob.h"
 #include "Serializable.hpp"
 
 namespace pew::eos::config
@@ -41,24 +42,50 @@ namespace pew::eos::config
         std::string client_secret;
         std::string encryption_key;
 
+        /**
+         * \brief Converts the credentials to their config blob record.
+         */
+        config_blob::ClientCredentialsRecord to_record(config_blob::BlobWriter& writer) const
+        {
+            return { writer.add_string(client_id), writer.add_string(client_secret), writer.add_string(encryption_key) };
+        }
+
+        /**
+         * \brief Reads the credentials from their config blob record.
+         */
+        void from_record(const config_blob::Section& section, const config_blob::ClientCredentialsRecord& record)
+        {
+            client_id = section.get_string(record.client_id);
+            client_secret = section.get_string(record.client_secret);
+            encryption_key = section.get_string(record.encryption_key);
+        }
+
     protected:
-        void parse_json_element(const std::string& name, json_value_s& value) override
+        void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
         {
-            if (name == "Value")
-            {
-                from_json(value);
-            }
-            else if (name == "ClientId")
-            {
-                client_id = json_value_as_string(&value)->string;
-            }
-            else if (name == "ClientSecret")
-            {
-                client_secret = json_value_as_string(&value)->string;
-            }
-            else if (name == "EncryptionKey")
+            static constexpr auto element_parsers = make_static_string_map<JsonElementParser<ClientCredentials>>({
+                { "Value", [](ClientCredentials& credentials, json_helpers::JsonReader& reader)
+                {
+                    credentials.from_json(reader);
+                }},
+                { "ClientId", [](ClientCredentials& credentials, json_helpers::JsonReader& reader)
+                {
+                    credentials.client_id = parse_string(reader);
+                }},
+                { "ClientSecret", [](ClientCredentials& credentials, json_helpers::JsonReader& reader)
+                {
+                    credentials.client_secret = parse_string(reader);
+                }},
+                { "EncryptionKey", [](ClientCredentials& credentials, json_helpers::JsonReader& reader)
+                {
+                    credentials.encryption_key = parse_string(reader);
+                }},
+            });
+
+            const auto parser = element_parsers.find(name);
+            if (parser != nullptr)
             {
-                encryption_key = json_value_as_string(&value)->string;
+                (*parser)(*this, reader);
             }
         }
 
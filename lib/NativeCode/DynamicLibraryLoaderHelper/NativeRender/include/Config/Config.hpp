@@ -26,13 +26,17 @@
 #pragma once
 
 #include <filesystem>
-#include <fstream>
-#include <sstream>
 #include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 
-#include "json.h"
+#include "config_blob.h"
+#include "config_watcher.h"
 #include "logging.h"
+#include "file_view.h"
 #include "io_helpers.h"
 #include "Config/Serializable.hpp"
 #include "Config/Version.hpp"
@@ -52,31 +56,158 @@ namespace pew::eos::config
         /**
          * \brief Gets the config class and values indicated by the template
          * parameter given.
+         *
+         * The file backing each config type is read and parsed once, and the
+         * result is shared by every caller until the file's modification time
+         * or size changes, at which point the next call reads it again.
+         * Snapshots are immutable, so a snapshot that is held on to stays
+         * valid (and unchanged) after the cache has moved on to a newer one.
+         *
          * \tparam T The Config-type-derived class that is being retrieved.
-         * \return An instance of a class derived from Config that contains all
+         * \return A snapshot of a class derived from Config that contains all
          * values.
          */
         template <typename T>
-        static std::enable_if_t<std::is_base_of_v<Config, T>, std::unique_ptr<T>> get()
+        static std::enable_if_t<std::is_base_of_v<Config, T>, std::shared_ptr<const T>> get()
+        {
+            return read_snapshot<T>(false, nullptr);
+        }
+
+        /**
+         * \brief Reads the config file of the config type indicated by the
+         * template parameter again, even if it does not appear to have changed,
+         * and makes the result the snapshot returned by get.
+         *
+         * \tparam T The Config-type-derived class that is being reloaded.
+         * \return The new snapshot, or nullptr if the file could not be read,
+         * in which case the previous snapshot is kept.
+         */
+        template <typename T>
+        static std::enable_if_t<std::is_base_of_v<Config, T>, std::shared_ptr<const T>> reload()
+        {
+            return read_snapshot<T>(true, nullptr);
+        }
+
+        /**
+         * \brief Reloads the config type indicated by the template parameter
+         * whenever its file changes, and passes the previous and the new
+         * snapshot to the given function. The file is read, and the function
+         * called, on the thread of the config watcher.
+         *
+         * \tparam T The Config-type-derived class to watch.
+         * \param on_changed The function to call with the previous and the
+         * new snapshot.
+         * \return The id of the subscription, which can be passed to
+         * config_watcher::unsubscribe, or zero if the file cannot be watched.
+         */
+        template <typename T>
+        static std::enable_if_t<std::is_base_of_v<Config, T>, config_watcher::SubscriptionId> subscribe(
+            std::function<void(const std::shared_ptr<const T>&, const std::shared_ptr<const T>&)> on_changed)
+        {
+            const auto file_path = get<T>()->_file_path;
+
+            return config_watcher::subscribe(file_path, [on_changed = std::move(on_changed)]()
+            {
+                std::shared_ptr<const T> previous;
+                const auto current = read_snapshot<T>(true, &previous);
+                if (current != nullptr)
+                {
+                    on_changed(previous, current);
+                }
+            });
+        }
+
+        /**
+         * \brief Parses the JSON file of the config type indicated by the
+         * template parameter, and adds its values to a config blob. The config
+         * blob itself is never used as the source.
+         * \tparam T The Config-type-derived class to compile.
+         * \param writer The writer of the config blob.
+         * \return True if the JSON file existed and was added, false
+         * otherwise.
+         */
+        template <typename T>
+        static std::enable_if_t<std::is_base_of_v<Config, T>, bool> compile_to_blob(config_blob::BlobWriter& writer)
         {
-            // Create the config class. The reason that "new" is used inside
-            // unique_ptr instead of using make_unique is because the
-            // constructor for Config-derived classes is protected and/or
-            // private - so it cannot be called by the internals of make_unique.
-            // This solution maintains all of the benefits of unique_ptr save
-            // one, which is that exceptions that might originate from within
-            // the constructor will not be as elegantly caught as they would if
-            // make_unique was utilized. For our purposes, this is acceptable.
             auto config = std::unique_ptr<T>(new T());
 
-            // Read the values from the file
-            config->read();
+            io_helpers::FileView source;
+            if (!source.open(config->_file_path) || !config->read_json(source.contents()))
+            {
+                return false;
+            }
 
-            return config;
+            config->to_blob(writer, source.contents());
+            return true;
         }
 
     private:
 
+        /**
+         * \brief The most recently read values of a config type.
+         */
+        template <typename T>
+        struct Snapshot
+        {
+            std::mutex mutex;
+            std::shared_ptr<const T> config;
+            io_helpers::FileStamp stamp;
+        };
+
+        /**
+         * \brief Gets the snapshot of the config type indicated by the
+         * template parameter, reading the config file if it has changed since
+         * the snapshot was taken.
+         *
+         * \param force_read Read the config file even if it has not changed.
+         * \param previous If not null, receives the snapshot that was
+         * replaced.
+         * \return The snapshot, or nullptr if force_read is set and the file
+         * could not be read.
+         */
+        template <typename T>
+        static std::shared_ptr<const T> read_snapshot(bool force_read, std::shared_ptr<const T>* previous)
+        {
+            // Each config type has its own cache, so reading one config while
+            // another is being read (for instance from on_read) is fine.
+            static Snapshot<T> s_snapshot;
+
+            std::lock_guard lock(s_snapshot.mutex);
+
+            if (!force_read && s_snapshot.config != nullptr && s_snapshot.stamp == io_helpers::get_file_stamp(s_snapshot.config->_file_path))
+            {
+                return s_snapshot.config;
+            }
+
+            // Create the config class. The reason that "new" is used instead
+            // of make_shared is because the constructor for Config-derived
+            // classes is protected and/or private - so it cannot be called by
+            // the internals of make_shared.
+            auto config = std::shared_ptr<T>(new T());
+
+            // The stamp is taken before reading, so that a file that changes
+            // while it is being read is read again on the next call.
+            s_snapshot.stamp = io_helpers::get_file_stamp(config->_file_path);
+
+            // Read the values from the file. If a config that has been read
+            // before cannot be read now (for instance because it is being
+            // edited), its previous values remain in effect.
+            if (!config->read() && s_snapshot.config != nullptr)
+            {
+                logging::log_warn("Keeping the previous values of config file \"" + config->_file_path.string() + "\".");
+                return force_read ? nullptr : s_snapshot.config;
+            }
+            config->on_read();
+
+            if (previous != nullptr)
+            {
+                *previous = s_snapshot.config;
+            }
+
+            s_snapshot.config = std::move(config);
+            return s_snapshot.config;
+        }
+
         // Depending on the configuration (debug or release) these are the possible relative paths to the config directory
         static constexpr std::array<std::string_view, 4> s_possible_config_directories = {
             // This is the relative path for the config files when in release
@@ -117,18 +248,6 @@ namespace pew::eos::config
             return s_config_directory;
         }
 
-        /**
-         * \brief Function internal to Config that is used to call the required
-         * implementation from the more derived class.
-         *
-         * \param json The json value to use for parsing.
-         */
-        void from_json_internal(const json_object_s& json)
-        {
-            // Call the deriving class' from_json function.
-            from_json(json);
-        }
-
     protected:
         /**
          * \brief The fully qualified path to the file that backs the
@@ -160,43 +279,114 @@ namespace pew::eos::config
         Config& operator=(Config&&) noexcept = default;
 
         /**
-         * \brief Reads the configuration values from the file.
+         * \brief Called after the values have been read from the file, before
+         * the config is handed out. Deriving classes can override this to
+         * adjust values that do not come from the file (for instance values
+         * that can be overridden on the command line), since the config is
+         * immutable afterwards.
          */
-        void read()
+        virtual void on_read()
         {
-            if (!exists(_file_path))
+        }
+
+        /**
+         * \brief Reads the values of the config from the section of the config
+         * blob that was compiled from the config file. Deriving classes that
+         * can be stored in the config blob override this.
+         * \param section The section of the config blob.
+         * \return True if the values were read, false if the config file
+         * needs to be parsed instead.
+         */
+        virtual bool from_blob([[maybe_unused]] const config_blob::Section& section)
+        {
+            return false;
+        }
+
+        /**
+         * \brief Adds the values of the config to a config blob. Deriving
+         * classes that can be stored in the config blob override this.
+         * \param writer The writer of the config blob.
+         * \param source_contents The contents of the config file that the
+         * values were parsed from.
+         */
+        virtual void to_blob([[maybe_unused]] config_blob::BlobWriter& writer, [[maybe_unused]] std::string_view source_contents) const
+        {
+        }
+
+        /**
+         * \brief Gets the file name of the config file, which is also the
+         * name of its section in the config blob.
+         */
+        std::string get_file_name() const
+        {
+            return _file_path.filename().string();
+        }
+
+        /**
+         * \brief Reads the configuration values, from the config blob if it
+         * has an up-to-date section for the config file, and from the config
+         * file otherwise.
+         * \return True if the values were read, false otherwise.
+         */
+        bool read()
+        {
+            const auto blob = config_blob::ConfigBlob::open_shared(get_config_directory() / EOS_CONFIG_BLOB_FILENAME);
+            if (blob != nullptr)
             {
-                logging::log_error("Config file \"" + _file_path.string() + "\" does not exist.");
-                return;
+                const auto section = blob->find_section(get_file_name());
+                if (section != nullptr && section->is_current(_file_path) && from_blob(*section))
+                {
+                    return true;
+                }
             }
 
-            std::ifstream file;
+            return read_json();
+        }
 
-            // Platform-specific handling of file opening
-#ifdef _WIN32
-            // On Windows, use wide-character API for Unicode support
-            file.open(_file_path.wstring(), std::ios::in);
-#else
-            // On Linux/macOS, open the file normally (UTF-8 is native)
-            file.open(_file_path, std::ios::in);
-#endif
+        /**
+         * \brief Reads the configuration values from the config file.
+         * \return True if the file was read, false otherwise.
+         */
+        bool read_json()
+        {
+            if (!exists(_file_path))
+            {
+                logging::log_error("Config file \"" + _file_path.string() + "\" does not exist.");
+                return false;
+            }
 
-            if (!file.is_open())
+            // The file is mapped rather than read into a buffer, so that the
+            // parser works directly on the contents of the file.
+            io_helpers::FileView file;
+            if (!file.open(_file_path))
             {
                 logging::log_error("Failed to open existing file: \"" + _file_path.string() + "\"");
-                return;
+                return false;
             }
 
-            std::ostringstream buffer;
-            buffer << file.rdbuf();
-            const std::string json_content = buffer.str();
+            return read_json(file.contents());
+        }
 
-            json_value_s* json_value = json_parse(json_content.c_str(), json_content.length());
-            const auto json_object = static_cast<json_object_s*>(json_value->payload);
+        /**
+         * \brief Reads the configuration values from the contents of a config
+         * file.
+         * \param json_content The contents of the config file.
+         * \return True if the contents could be parsed, false otherwise.
+         */
+        bool read_json(std::string_view json_content)
+        {
+            // Values are read straight from the text as the reader reaches
+            // them, instead of from a document tree parsed beforehand.
+            json_helpers::JsonReader reader(json_content);
+            from_json(reader);
 
-            from_json(*json_object);
+            if (!reader.finish())
+            {
+                logging::log_error("Failed to parse config file: \"" + _file_path.string() + "\" (at offset " + std::to_string(reader.offset()) + ")");
+                return false;
+            }
 
-            free(json_value);
+            return true;
         }
     };
 }
@@ -24,7 +24,7 @@
  */
 
 #pragma once
-#include <map>
+#include "static_string_map.h"
 
 namespace pew::eos
 {
@@ -32,7 +32,7 @@ namespace pew::eos
      * \brief Maps string values to specific auth scope flags defined within the
      * EOS SDK.
      */
-    const std::map<std::string, EOS_EAuthScopeFlags> AUTH_SCOPE_FLAGS_STRINGS_TO_ENUM = {
+    inline constexpr auto AUTH_SCOPE_FLAGS_STRINGS_TO_ENUM = make_static_string_map<EOS_EAuthScopeFlags>({
         { "NoFlags",           EOS_EAuthScopeFlags::EOS_AS_NoFlags           },
         { "BasicProfile",      EOS_EAuthScopeFlags::EOS_AS_BasicProfile      },
         { "FriendsList",       EOS_EAuthScopeFlags::EOS_AS_FriendsList       },
@@ -40,7 +40,7 @@ namespace pew::eos
         { "FriendsManagement", EOS_EAuthScopeFlags::EOS_AS_FriendsManagement },
         { "Email",             EOS_EAuthScopeFlags::EOS_AS_Email             },
         { "Country",           EOS_EAuthScopeFlags::EOS_AS_Country           },
-    };
+    });
 
     /**
      * \brief Maps string values to values for platform options flags. Note that
@@ -48,7 +48,7 @@ namespace pew::eos
      * provide backwards-compatibility for versions where the member names of
      * the enum have changed or were being serialized differently.
      */
-    static const std::map<std::string, int> PLATFORM_CREATION_FLAGS_STRINGS_TO_ENUM = {
+    inline constexpr auto PLATFORM_CREATION_FLAGS_STRINGS_TO_ENUM = make_static_string_map<int>({
         {"EOS_PF_LOADING_IN_EDITOR",                          EOS_PF_LOADING_IN_EDITOR},
         {"LoadingInEditor",                                   EOS_PF_LOADING_IN_EDITOR},
 
@@ -75,14 +75,14 @@ namespace pew::eos
 
         {"EOS_PF_NONE",                                       0},
         {"None",                                              0},
-    };
+    });
 
     /**
     * \brief Maps string values to values within the EOS_UI_EInputStateButtonFlags enum. Note that there are multiple
     * keys that can be mapped to the same value. This is to provide backwards-compatibility for versions where the member names of the
     * enum have changed or were being serialized differently.
     */
-    const std::map<std::string, EOS_UI_EInputStateButtonFlags> INPUT_STATE_BUTTON_FLAGS_STRINGS_TO_ENUM = {
+    inline constexpr auto INPUT_STATE_BUTTON_FLAGS_STRINGS_TO_ENUM = make_static_string_map<EOS_UI_EInputStateButtonFlags>({
         { "None",              EOS_UI_EInputStateButtonFlags::EOS_UISBF_None              },
 
         { "DPad_Left",         EOS_UI_EInputStateButtonFlags::EOS_UISBF_DPad_Left         },
@@ -125,7 +125,7 @@ namespace pew::eos
 
         { "LeftThumbstick",    EOS_UI_EInputStateButtonFlags::EOS_UISBF_LeftThumbstick    },
         { "RightThumbstick",   EOS_UI_EInputStateButtonFlags::EOS_UISBF_RightThumbstick   },
-    };
+    });
 }
 
 #endif
@@ -0,0 +1,70 @@
+#ifndef LINUX_CONFIG_HPP
+#define LINUX_CONFIG_HPP
+
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <filesystem>
+
+#include "include/Config/PlatformConfig.hpp"
+
+namespace pew::eos::config
+{
+    struct LinuxConfig final : PlatformConfig
+    {
+        void set_cache_directory() override
+        {
+            if (cache_directory.empty())
+            {
+                std::error_code error;
+                const auto temp_directory = std::filesystem::temp_directory_path(error);
+                if (error)
+                {
+                    logging::log_warn("Could not determine the temp directory, EOS will use its default cache directory.");
+                    return;
+                }
+
+                cache_directory = temp_directory.string();
+            }
+        }
+
+        void set_platform_specific_rtc_options() override
+        {
+            // The SDK has no platform specific rtc options on Linux.
+            platform_specific_rtc_options = nullptr;
+        }
+
+    private:
+
+        explicit LinuxConfig() : PlatformConfig(EOS_LINUX_CONFIG_FILENAME)
+        {
+            initialize();
+        }
+
+        // Makes the LinuxConfig constructor accessible to the Config class.
+        friend struct Config;
+    };
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef NATIVE_PLATFORM_CONFIG_HPP
+#define NATIVE_PLATFORM_CONFIG_HPP
+
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#if PLATFORM_WINDOWS
+#include "include/Config/WindowsConfig.hpp"
+#elif PLATFORM_LINUX
+#include "include/Config/LinuxConfig.hpp"
+#endif
+
+namespace pew::eos::config
+{
+    /**
+     * \brief The platform config for the platform the plugin is built for.
+     */
+#if PLATFORM_WINDOWS
+    using NativePlatformConfig = WindowsConfig;
+#elif PLATFORM_LINUX
+    using NativePlatformConfig = LinuxConfig;
+#endif
+}
+
+#endif
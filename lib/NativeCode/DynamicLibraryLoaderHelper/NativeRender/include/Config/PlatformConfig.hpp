@@ -25,7 +25,7 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <string_view>
 #include "config_legacy.h"
 #include "EnumMappings.h"
 #include "eos_init.h"
@@ -35,6 +35,7 @@
 #include "ProductionEnvironments.hpp"
 #include "Config/ClientCredentials.hpp"
 #include "Config/Config.hpp"
+#include "Config/ProductConfig.hpp"
 
 namespace pew::eos::config
 {
@@ -81,6 +82,21 @@ namespace pew::eos::config
          */
         int tick_budget_in_milliseconds;
 
+        /**
+         * \brief If not zero ("nativeTickRate"), the number of times per
+         * second the plugin ticks the platform from a thread of its own (see
+         * tick_driver.h), instead of leaving the ticking to managed code.
+         * Only used by hosts that allow the tick driver to run.
+         */
+        uint32_t native_tick_rate;
+
+        /**
+         * \brief If not zero ("frameBudgetInMilliseconds"), the frame time
+         * that the tick controller (see tick_controller.h) targets when it
+         * decides how many ticks to run each frame.
+         */
+        float frame_budget_in_milliseconds;
+
         /**
          * \brief Indicates the maximum number of seconds that (before first
          * coming only) the EOS SDK will allow network calls to run before
@@ -95,6 +111,15 @@ namespace pew::eos::config
          */
         EOS_Initialize_ThreadAffinity thread_affinity;
 
+        /**
+         * \brief If true ("Auto" in the threadAffinity element), the
+         * affinities of the network, P2P, RTC and HTTP threads that are left
+         * at zero are chosen from the CPU topology when the SDK is
+         * initialized, so that they stay off the cores of the game's main and
+         * render threads.
+         */
+        bool auto_thread_affinity;
+
         /**
          * \brief If true, the plugin will always send input to the overlay from
          * the C# side to native side, and handle showing the overlay. This
@@ -170,123 +195,270 @@ namespace pew::eos::config
              is_server(false),
              platform_options_flags(0),
              tick_budget_in_milliseconds(0),
+             native_tick_rate(0),
+             frame_budget_in_milliseconds(0),
              task_network_timeout_seconds(0),
              thread_affinity(),
+             auto_thread_affinity(false),
              always_send_input_to_overlay(false),
              initial_button_delay_for_overlay(0),
              repeat_button_delay_for_overlay(0)
         {
         }
 
-        void parse_json_element(const std::string& name, json_value_s& value) override
+        void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
         {
-            if (name == "deployment")
-            {
-                deployment.from_json(value);
-            }
-            else if (name == "clientCredentials")
-            {
-                client_credentials.from_json(value);
-            }
-            else if (name == "isServer")
-            {
-                is_server = parse_bool(value);
-            }
-            else if (name == "platformOptionsFlags")
-            {
-                platform_options_flags = parse_flags<int>(
-                    &PLATFORM_CREATION_FLAGS_STRINGS_TO_ENUM, 
-                    0, 
-                    &value);
-            }
-            else if (name == "authScopeOptionsFlags")
-            {
-                auth_scope_flags = parse_flags<EOS_EAuthScopeFlags>(
-                    &AUTH_SCOPE_FLAGS_STRINGS_TO_ENUM, 
-                    EOS_EAuthScopeFlags::EOS_AS_NoFlags, 
-                    &value);
-            }
-            else if (name == "integratedPlatformManagementFlags")
-            {
-                integrated_platform_management_flags = 
-                    parse_flags<EOS_EIntegratedPlatformManagementFlags>(
-                        &config_legacy::INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM, 
-                        EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled, 
-                        &value);
-            }
-            else if (name == "tickBudgetInMilliseconds")
+            static constexpr auto element_parsers = make_static_string_map<JsonElementParser<PlatformConfig>>({
+                { "deployment", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.deployment.from_json(reader);
+                }},
+                { "clientCredentials", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.client_credentials.from_json(reader);
+                }},
+                { "isServer", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.is_server = parse_bool(reader);
+                }},
+                { "platformOptionsFlags", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.platform_options_flags = parse_flags<int>(
+                        &PLATFORM_CREATION_FLAGS_STRINGS_TO_ENUM, 
+                        0, 
+                        reader);
+                }},
+                { "authScopeOptionsFlags", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.auth_scope_flags = parse_flags<EOS_EAuthScopeFlags>(
+                        &AUTH_SCOPE_FLAGS_STRINGS_TO_ENUM, 
+                        EOS_EAuthScopeFlags::EOS_AS_NoFlags, 
+                        reader);
+                }},
+                { "integratedPlatformManagementFlags", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.integrated_platform_management_flags = 
+                        parse_flags<EOS_EIntegratedPlatformManagementFlags>(
+                            &config_legacy::INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM, 
+                            EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled, 
+                            reader);
+                }},
+                { "tickBudgetInMilliseconds", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.tick_budget_in_milliseconds = parse_number<int>(reader);
+                }},
+                { "nativeTickRate", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.native_tick_rate = parse_number<uint32_t>(reader);
+                }},
+                { "frameBudgetInMilliseconds", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.frame_budget_in_milliseconds = parse_number<float>(reader);
+                }},
+                { "taskNetworkTimeoutSeconds", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.task_network_timeout_seconds = parse_number<double>(reader);
+                }},
+                { "threadAffinity", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.parse_thread_affinity(reader);
+                }},
+                { "alwaysSendInputToOverlay", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.always_send_input_to_overlay = parse_bool(reader);
+                }},
+                { "initialButtonDelayForOverlay", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.initial_button_delay_for_overlay = parse_number<float>(reader);
+                }},
+                { "repeatButtonDelayForOverlay", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.repeat_button_delay_for_overlay = parse_number<float>(reader);
+                }},
+                { "toggleFriendsButtonCombination", [](PlatformConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.toggle_friends_button_combination = parse_flags<EOS_UI_EInputStateButtonFlags>(
+                        &INPUT_STATE_BUTTON_FLAGS_STRINGS_TO_ENUM,
+                        EOS_UI_EInputStateButtonFlags::EOS_UISBF_None,
+                        reader);
+                }},
+            });
+
+            const auto parser = element_parsers.find(name);
+            if (parser != nullptr)
             {
-                tick_budget_in_milliseconds = parse_number<int>(value);
+                (*parser)(*this, reader);
             }
-            else if (name == "taskNetworkTimeoutSeconds")
+        }
+
+        /**
+         * \brief Parses the threadAffinity element of the config.
+         * \param reader The reader, positioned at the value of the
+         * threadAffinity element.
+         */
+        void parse_thread_affinity(json_helpers::JsonReader& reader)
+        {
+            // A null threadAffinity (or anything else that is not an object)
+            // leaves the thread affinity unset.
+            if (!reader.begin_object())
             {
-                task_network_timeout_seconds = parse_number<double>(value);
+                reader.skip_value();
+                return;
             }
-            else if (name == "threadAffinity")
+
+            static constexpr auto affinity_members = make_static_string_map<uint64_t EOS_Initialize_ThreadAffinity::*>({
+                { "NetworkWork",                  &EOS_Initialize_ThreadAffinity::NetworkWork },
+                { "StorageIo",                    &EOS_Initialize_ThreadAffinity::StorageIo },
+                { "WebSocketIo",                  &EOS_Initialize_ThreadAffinity::WebSocketIo },
+                { "P2PIo",                        &EOS_Initialize_ThreadAffinity::P2PIo },
+                { "HttpRequestIo",                &EOS_Initialize_ThreadAffinity::HttpRequestIo },
+                { "RTCIo",                        &EOS_Initialize_ThreadAffinity::RTCIo },
+                { "EmbeddedOverlayMainThread",    &EOS_Initialize_ThreadAffinity::EmbeddedOverlayMainThread },
+                { "EmbeddedOverlayWorkerThreads", &EOS_Initialize_ThreadAffinity::EmbeddedOverlayWorkerThreads },
+            });
+
+            std::string_view element_name;
+            while (reader.next_member(element_name))
             {
-                if (value.payload == 0)
+                if (element_name == "Auto")
                 {
-                    // A payload of 0 means that threadAffinity should be null
-                    // Don't set it in this case
-                    return;
+                    auto_thread_affinity = parse_bool(reader);
+                    continue;
                 }
 
-                const auto thread_affinity_json_object = *static_cast<json_object_s*>(value.payload);
-                auto thread_affinity_iterator = thread_affinity_json_object.start;
-
-                // TODO: Figure out how to implement this clean approach with
-                //       all the properties of any class deriving from
-                //       Serializable.
-                std::unordered_map<std::string, uint64_t*> affinity_map = {
-                    {"NetworkWork", &thread_affinity.NetworkWork},
-                    {"StorageIo", &thread_affinity.StorageIo},
-                    {"WebSocketIo", &thread_affinity.WebSocketIo},
-                    {"P2PIo", &thread_affinity.P2PIo},
-                    {"HttpRequestIo", &thread_affinity.HttpRequestIo},
-                    {"RTCIo", &thread_affinity.RTCIo},
-                    {"EmbeddedOverlayMainThread", &thread_affinity.EmbeddedOverlayMainThread},
-                    {"EmbeddedOverlayWorkerThreads", &thread_affinity.EmbeddedOverlayWorkerThreads},
-                };
-
-                while(thread_affinity_iterator)
+                const auto member = affinity_members.find(element_name);
+                if (member != nullptr)
                 {
-                    const std::string element_name = thread_affinity_iterator->name->string;
+                    thread_affinity.*(*member) = parse_number<uint64_t>(reader);
+                }
+                else
+                {
+                    reader.skip_value();
+                }
+            }
 
-                    if (affinity_map.find(element_name) != affinity_map.end() && thread_affinity_iterator->value != nullptr)
-                    {
-                        auto element = *(thread_affinity_iterator->value);
-                        *affinity_map[element_name] = parse_number<uint64_t>(element);
-                    }
+            // TODO: Confirm that setting this version to the latest every
+            //       time won't be a problem for users if their config was
+            //       serialized with an older version.
+            thread_affinity.ApiVersion = EOS_INITIALIZE_THREADAFFINITY_API_LATEST;
+        }
 
-                    thread_affinity_iterator = thread_affinity_iterator->next;
-                }
+        /**
+         * \brief Applies any command line arguments that may have been
+         * provided. The product config is used to warn the user if the
+         * provided sandbox id or deployment id is not defined in the product
+         * config. If they are not defined, they will still be applied.
+         */
+        void on_read() override
+        {
+            //support sandbox and deployment id override via command line arguments
+            const std::vector<std::string> argument_strings = io_helpers::get_command_line_arguments();
 
-                // TODO: Confirm that setting this version to the latest every
-                //       time won't be a problem for users if their config was
-                //       serialized with an older version.
-                thread_affinity.ApiVersion = EOS_INITIALIZE_THREADAFFINITY_API_LATEST;
-                
-            }
-            else if (name == "alwaysSendInputToOverlay")
+            std::string sandbox_id_override;
+            if (io_helpers::try_get_command_line_argument(argument_strings, sandbox_id_override, "epicsandboxid", "eossandboxid"))
             {
-                always_send_input_to_overlay = parse_bool(value);
+                if (!Config::get<ProductConfig>()->environments.is_sandbox_defined(sandbox_id_override))
+                {
+                    logging::log_warn(
+                      "Sandbox Id \"" + sandbox_id_override + "\" was provided on the "
+                      "command line, but is not found in the product config. Attempting "
+                      "to use it regardless.");
+                }
+                deployment.sandbox.id = sandbox_id_override;
             }
-            else if (name == "initialButtonDelayForOverlay")
+
+            std::string deployment_id_override;
+            if (io_helpers::try_get_command_line_argument(argument_strings, deployment_id_override, "eosdeploymentid", "epicdeploymentid"))
             {
-                initial_button_delay_for_overlay = parse_number<float>(value);
+                if (!Config::get<ProductConfig>()->environments.is_deployment_defined(deployment_id_override))
+                {
+                    logging::log_warn(
+                      "Deployment Id \"" + deployment_id_override + "\" was provided on the "
+                      "command line, but is not found in the product config. Attempting "
+                      "to use it regardless.");
+                }
+                deployment.id = deployment_id_override;
             }
-            else if (name == "repeatButtonDelayForOverlay")
+        }
+
+        bool from_blob(const config_blob::Section& section) override
+        {
+            const auto record = section.get_record<config_blob::PlatformConfigRecord>();
+            if (record == nullptr)
             {
-                repeat_button_delay_for_overlay = parse_number<float>(value);
+                return false;
             }
-            else if (name == "toggleFriendsButtonCombination")
+
+            deployment.from_record(section, record->deployment);
+            client_credentials.from_record(section, record->client_credentials);
+            is_server = record->is_server != 0;
+            platform_options_flags = record->platform_options_flags;
+            auth_scope_flags = static_cast<EOS_EAuthScopeFlags>(record->auth_scope_flags);
+            integrated_platform_management_flags = static_cast<EOS_EIntegratedPlatformManagementFlags>(record->integrated_platform_management_flags);
+            tick_budget_in_milliseconds = record->tick_budget_in_milliseconds;
+            native_tick_rate = record->native_tick_rate;
+            frame_budget_in_milliseconds = record->frame_budget_in_milliseconds;
+            task_network_timeout_seconds = record->task_network_timeout_seconds;
+
+            if (record->has_thread_affinity != 0)
             {
-                // Handle toggleFriendsButtonCombination
-                toggle_friends_button_combination = parse_flags<EOS_UI_EInputStateButtonFlags>(
-                    &INPUT_STATE_BUTTON_FLAGS_STRINGS_TO_ENUM,
-                    EOS_UI_EInputStateButtonFlags::EOS_UISBF_None,
-                    &value);
+                thread_affinity.ApiVersion = EOS_INITIALIZE_THREADAFFINITY_API_LATEST;
+                thread_affinity.NetworkWork = record->thread_affinity[0];
+                thread_affinity.StorageIo = record->thread_affinity[1];
+                thread_affinity.WebSocketIo = record->thread_affinity[2];
+                thread_affinity.P2PIo = record->thread_affinity[3];
+                thread_affinity.HttpRequestIo = record->thread_affinity[4];
+                thread_affinity.RTCIo = record->thread_affinity[5];
+                thread_affinity.EmbeddedOverlayMainThread = record->thread_affinity[6];
+                thread_affinity.EmbeddedOverlayWorkerThreads = record->thread_affinity[7];
             }
+            auto_thread_affinity = record->auto_thread_affinity != 0;
+
+            always_send_input_to_overlay = record->always_send_input_to_overlay != 0;
+            initial_button_delay_for_overlay = record->initial_button_delay_for_overlay;
+            repeat_button_delay_for_overlay = record->repeat_button_delay_for_overlay;
+            toggle_friends_button_combination = static_cast<EOS_UI_EInputStateButtonFlags>(record->toggle_friends_button_combination);
+            overrideCountryCode = section.get_string(record->override_country_code);
+            overrideLocaleCode = section.get_string(record->override_locale_code);
+
+            return true;
+        }
+
+        void to_blob(config_blob::BlobWriter& writer, std::string_view source_contents) const override
+        {
+            config_blob::PlatformConfigRecord record = {};
+            record.deployment = deployment.to_record(writer);
+            record.client_credentials = client_credentials.to_record(writer);
+            record.is_server = is_server ? 1 : 0;
+            record.platform_options_flags = platform_options_flags;
+            record.auth_scope_flags = static_cast<int32_t>(auth_scope_flags);
+            record.integrated_platform_management_flags = static_cast<int32_t>(integrated_platform_management_flags);
+            record.tick_budget_in_milliseconds = tick_budget_in_milliseconds;
+            record.native_tick_rate = native_tick_rate;
+            record.frame_budget_in_milliseconds = frame_budget_in_milliseconds;
+            record.task_network_timeout_seconds = task_network_timeout_seconds;
+
+            // The api version is only set when the config defines a thread
+            // affinity.
+            record.has_thread_affinity = (thread_affinity.ApiVersion != 0) ? 1 : 0;
+            record.thread_affinity[0] = thread_affinity.NetworkWork;
+            record.thread_affinity[1] = thread_affinity.StorageIo;
+            record.thread_affinity[2] = thread_affinity.WebSocketIo;
+            record.thread_affinity[3] = thread_affinity.P2PIo;
+            record.thread_affinity[4] = thread_affinity.HttpRequestIo;
+            record.thread_affinity[5] = thread_affinity.RTCIo;
+            record.thread_affinity[6] = thread_affinity.EmbeddedOverlayMainThread;
+            record.thread_affinity[7] = thread_affinity.EmbeddedOverlayWorkerThreads;
+            record.auto_thread_affinity = auto_thread_affinity ? 1 : 0;
+
+            record.always_send_input_to_overlay = always_send_input_to_overlay ? 1 : 0;
+            record.initial_button_delay_for_overlay = initial_button_delay_for_overlay;
+            record.repeat_button_delay_for_overlay = repeat_button_delay_for_overlay;
+            record.toggle_friends_button_combination = static_cast<int32_t>(toggle_friends_button_combination);
+            record.override_country_code = writer.add_string(overrideCountryCode);
+            record.override_locale_code = writer.add_string(overrideLocaleCode);
+
+            writer.add_section(get_file_name(), source_contents, record);
         }
 
         friend struct Config;
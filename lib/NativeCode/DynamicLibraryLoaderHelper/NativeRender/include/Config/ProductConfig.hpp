@@ -67,31 +67,100 @@ namespace pew::eos::config
         // Makes the ProductConfig constructor accessible to the Config class.
         friend struct Config;
         ProductConfig() : Config("eos_product_config.json") {}
-        
-        void parse_json_element(const std::string& name, json_value_s& value) override
+
+        bool from_blob(const config_blob::Section& section) override
         {
-            if (name == "ProductName")
+            const auto record = section.get_record<config_blob::ProductConfigRecord>();
+            if (record == nullptr)
+            {
+                return false;
+            }
+
+            product_name = section.get_string(record->product_name);
+            product_id = section.get_string(record->product_id);
+            product_version = section.get_string(record->product_version);
+
+            for (const auto& deployment_record : section.get_array<config_blob::DeploymentRecord>(record->deployments))
+            {
+                environments.deployments.emplace_back().from_record(section, deployment_record);
+            }
+
+            for (const auto& sandbox_id : section.get_strings(record->sandboxes))
+            {
+                environments.sandboxes.emplace_back().id = sandbox_id;
+            }
+
+            for (const auto& client_record : section.get_array<config_blob::ClientCredentialsRecord>(record->clients))
             {
-                product_name = json_value_as_string(&value)->string;
+                clients.emplace_back().from_record(section, client_record);
             }
-            else if (name == "ProductId")
+
+            return true;
+        }
+
+        void to_blob(config_blob::BlobWriter& writer, std::string_view source_contents) const override
+        {
+            config_blob::ProductConfigRecord record = {};
+            record.product_name = writer.add_string(product_name);
+            record.product_id = writer.add_string(product_id);
+            record.product_version = writer.add_string(product_version);
+
+            std::vector<config_blob::DeploymentRecord> deployment_records;
+            for (const auto& deployment : environments.deployments)
             {
-                product_id = json_value_as_string(&value)->string;
+                deployment_records.push_back(deployment.to_record(writer));
             }
-            else if (name == "ProductVersion")
+            record.deployments = writer.add_array(deployment_records);
+
+            std::vector<std::string> sandbox_ids;
+            for (const auto& sandbox : environments.sandboxes)
             {
-                product_version = json_value_as_string(&value)->string;
+                sandbox_ids.push_back(sandbox.id);
             }
-            else if (name == "Clients")
+            record.sandboxes = writer.add_strings(sandbox_ids);
+
+            std::vector<config_blob::ClientCredentialsRecord> client_records;
+            for (const auto& client : clients)
             {
-                clients = parse_json_array<ClientCredentials>(value);
+                client_records.push_back(client.to_record(writer));
             }
-            else if (name == "Environments")
+            record.clients = writer.add_array(client_records);
+
+            writer.add_section(get_file_name(), source_contents, record);
+        }
+        
+        void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
+        {
+            static constexpr auto element_parsers = make_static_string_map<JsonElementParser<ProductConfig>>({
+                { "ProductName", [](ProductConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.product_name = parse_string(reader);
+                }},
+                { "ProductId", [](ProductConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.product_id = parse_string(reader);
+                }},
+                { "ProductVersion", [](ProductConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.product_version = parse_string(reader);
+                }},
+                { "Clients", [](ProductConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.clients = parse_json_array<ClientCredentials>(reader);
+                }},
+                { "Environments", [](ProductConfig& config, json_helpers::JsonReader& reader)
+                {
+                    // Parse environments
+                    auto parsed_environments = ProductionEnvironments();
+                    parsed_environments.from_json(reader);
+                    config.environments = parsed_environments;
+                }},
+            });
+
+            const auto parser = element_parsers.find(name);
+            if (parser != nullptr)
             {
-                // Parse environments
-                auto parsed_environments = ProductionEnvironments();
-                parsed_environments.from_json(value);
-                environments = parsed_environments;
+                (*parser)(*this, reader);
             }
         }
     };
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "config_blob.h"
 #include "Serializable.hpp"
 
 namespace pew::eos::config
@@ -46,18 +47,15 @@ namespace pew::eos::config
             std::string id;
 
         protected:
-            void parse_json_element(const std::string& name, json_value_s& value) override
+            void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
             {
                 if (name == "Value")
                 {
-                    const auto json_string = json_value_as_string(&value);
-                    if (nullptr == json_string)
+                    // The value is either the id itself, or an object that
+                    // contains it.
+                    if (!reader.read_string(id))
                     {
-                        from_json(value);
-                    }
-                    else
-                    {
-                        id = json_string->string;
+                        from_json(reader);
                     }
                 }
             }
@@ -71,22 +69,47 @@ namespace pew::eos::config
             std::string id;
             Sandbox sandbox;
 
+            /**
+             * \brief Converts the deployment to its config blob record.
+             */
+            config_blob::DeploymentRecord to_record(config_blob::BlobWriter& writer) const
+            {
+                return { writer.add_string(id), writer.add_string(sandbox.id) };
+            }
+
+            /**
+             * \brief Reads the deployment from its config blob record.
+             */
+            void from_record(const config_blob::Section& section, const config_blob::DeploymentRecord& record)
+            {
+                id = section.get_string(record.id);
+                sandbox.id = section.get_string(record.sandbox_id);
+            }
+
         protected:
-            void parse_json_element(const std::string& name, json_value_s& value) override
+            void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
             {
-                if (name == "Value")
-                {
-                    from_json(value);
-                }
-                else if (name == "DeploymentId")
-                {
-                    id = json_value_as_string(&value)->string;
-                }
-                else if (name == "SandboxId")
+                static constexpr auto element_parsers = make_static_string_map<JsonElementParser<Deployment>>({
+                    { "Value", [](Deployment& deployment, json_helpers::JsonReader& reader)
+                    {
+                        deployment.from_json(reader);
+                    }},
+                    { "DeploymentId", [](Deployment& deployment, json_helpers::JsonReader& reader)
+                    {
+                        deployment.id = parse_string(reader);
+                    }},
+                    { "SandboxId", [](Deployment& deployment, json_helpers::JsonReader& reader)
+                    {
+                        auto sandbox_temp = Sandbox();
+                        sandbox_temp.from_json(reader);
+                        deployment.sandbox = sandbox_temp;
+                    }},
+                });
+
+                const auto parser = element_parsers.find(name);
+                if (parser != nullptr)
                 {
-                    auto sandbox_temp = Sandbox();
-                    sandbox_temp.from_json(value);
-                    sandbox = sandbox_temp;
+                    (*parser)(*this, reader);
                 }
             }
         };
@@ -132,15 +155,23 @@ namespace pew::eos::config
     protected:
         friend struct ProductConfig;
 
-        void parse_json_element(const std::string& name, json_value_s& value) override
+        void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
         {
-            if (name == "Deployments")
-            {
-                deployments = parse_json_array<Deployment>(value);
-            }
-            else if (name == "Sandboxes")
+            static constexpr auto element_parsers = make_static_string_map<JsonElementParser<ProductionEnvironments>>({
+                { "Deployments", [](ProductionEnvironments& environments, json_helpers::JsonReader& reader)
+                {
+                    environments.deployments = parse_json_array<Deployment>(reader);
+                }},
+                { "Sandboxes", [](ProductionEnvironments& environments, json_helpers::JsonReader& reader)
+                {
+                    environments.sandboxes = parse_json_array<Sandbox>(reader);
+                }},
+            });
+
+            const auto parser = element_parsers.find(name);
+            if (parser != nullptr)
             {
-                sandboxes = parse_json_array<Sandbox>(value);
+                (*parser)(*this, reader);
             }
         }
     };
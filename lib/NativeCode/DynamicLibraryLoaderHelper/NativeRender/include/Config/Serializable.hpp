@@ -25,11 +25,13 @@
 
 #pragma once
 
-#include <iostream>
-#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include "json.h"
+#include "json_reader.h"
 #include "logging.h"
+#include "static_string_map.h"
 #include "string_helpers.h"
 
 namespace pew::eos::config
@@ -37,6 +39,11 @@ namespace pew::eos::config
     /**
      * \brief Used to describe the functions needed to make an object both
      * serializable and deserializable from JSON.
+     *
+     * Objects are read straight from the JSON text with a
+     * json_helpers::JsonReader: each member of the object is handed to
+     * parse_json_element as it is reached, without a document tree being
+     * built first.
      */
     struct Serializable
     {
@@ -46,106 +53,78 @@ namespace pew::eos::config
         /**
          * \brief Function that is called when an element inside the json object
          * passed to from_json is being parsed.
-         * \param name The name of the JSON element.
-         * \param value The value of the JSON element.
+         * \param name The name of the JSON element. Only valid until the value
+         * is read.
+         * \param reader The reader, positioned at the value of the JSON
+         * element. The value is skipped if it is not read.
          */
-        virtual void parse_json_element(const std::string& name, json_value_s& value) = 0;
+        virtual void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) = 0;
+
+        /**
+         * \brief Function that parses a JSON element into a member of T.
+         * Deriving classes map their element names to these with
+         * make_static_string_map, so that finding the function for an
+         * element takes a single hash lookup instead of a string comparison
+         * per member.
+         */
+        template <typename T>
+        using JsonElementParser = void (*)(T&, json_helpers::JsonReader&);
 
         /**
          * \brief Parses a JSON array into an std::vector of a specified type T.
          * \tparam T The type for to parse a vector of from the given json value.
-         * \param array_value The JSON value containing the JSON array.
+         * \param reader The reader, positioned at the JSON array.
          * \return An std::vector<T>
          */
         template<typename T>
         static std::enable_if_t<
             std::is_base_of_v<Serializable, T> || 
             std::is_same_v<std::string, T>
-        , std::vector<T>> parse_json_array(json_value_s& array_value)
+        , std::vector<T>> parse_json_array(json_helpers::JsonReader& reader)
         {
             std::vector<T> elements;
 
-            const auto array = json_value_as_array(&array_value);
-
-            if (array == nullptr)
+            if (!reader.begin_array())
             {
+                reader.skip_value();
                 return elements;
             }
 
-            auto array_iterator = array->start;
-
-            while(array_iterator)
+            while (reader.next_element())
             {
                 auto element = T();
 
                 if constexpr(std::is_same_v<T, std::string>)
                 {
-                    const auto temp_string = json_value_as_string(array_iterator->value);
-                    element = (temp_string == nullptr) ? "" : temp_string->string;
-                }
-                else if constexpr(std::is_base_of_v<Serializable, T>)
-                {
-                    element.from_json(*(array_iterator->value));
+                    element = parse_string(reader);
                 }
                 else
                 {
-                    throw;
+                    element.from_json(reader);
                 }
 
-                elements.push_back(element);
-
-                array_iterator = array_iterator->next;
+                elements.push_back(std::move(element));
             }
 
             return elements;
         }
 
         /**
-         * \brief Parses a number from json into a specific type. 
-         * \tparam T The type to parse the number into. Supports int, double,
-         * long, float, uint64_t, and uint32_t
-         * \param json_value The json value that contains a number.
-         * \return The result of parsing the json value into the specified number type.
+         * \brief Parses a number from json into a specific type. The number is
+         * converted in place with json_helpers::parse_number.
+         * \tparam T The type to parse the number into.
+         * \param reader The reader, positioned at a number.
+         * \return The result of parsing the json value into the specified
+         * number type, or zero if the value is not a number or does not fit
+         * in the type.
          */
-        template <typename T, typename = std::enable_if_t<
-                      std::is_same_v<T, int> || 
-                      std::is_same_v<T, double> || 
-                      std::is_same_v<T, long> ||
-                      std::is_same_v<T, float> ||
-                      std::is_same_v<T, uint64_t> ||
-                      std::is_same_v<T, uint32_t>
-                  >>
-        static T parse_number(json_value_s& json_value)
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+        static T parse_number(json_helpers::JsonReader& reader)
         {
             T number_value = 0;
-            const auto number = json_value_as_number(&json_value);
-
-            if constexpr (std::is_same_v<T, int>)
-            {
-                number_value = (number == nullptr) ? 0 : std::atoi(number->number);
-            }
-            else if constexpr (std::is_same_v<T, long>)
+            if (!reader.read_number(number_value))
             {
-                number_value = (number == nullptr) ? 0L : std::strtol(number->number, nullptr, 10);
-            }
-            else if constexpr (std::is_same_v<T, double>)
-            {
-                number_value = (number == nullptr) ? 0.0 : std::strtod(number->number, nullptr);
-            }
-            else if constexpr(std::is_same_v<T, float>)
-            {
-                char* end;
-                number_value = (number == nullptr) ? 0.0f : std::strtof(number->number, &end);
-            }
-            else if constexpr(std::is_same_v<T, uint64_t>)
-            {
-                char* end;
-                number_value = (number == nullptr) ? 0 : std::strtoull(number->number, &end, 10);
-            }
-            else if constexpr (std::is_same_v<T, uint32_t>)
-            {
-                char* end;
-                number_value = (number == nullptr) ? 0 : static_cast<uint32_t>(std::strtoul(number->number, &end, 10));
+                reader.skip_value();
             }
 
             return number_value;
@@ -155,24 +134,36 @@ namespace pew::eos::config
          * \brief Parses a json value into true or false. If the type of the
          * json value is determined to neither be true nor false, the returned
          * value is false, and a warning is logged.
-         * \param json_value The json value that contains either true or false.
+         * \param reader The reader, positioned at either true or false.
          * \return True or false, depending on the contents of the given JSON.
          */
-        static bool parse_bool(const json_value_s& json_value)
+        static bool parse_bool(json_helpers::JsonReader& reader)
         {
-            if (json_value_is_true(&json_value))
-            {
-                return true;
-            }
-            else if (json_value_is_false(&json_value))
+            bool value = false;
+            if (!reader.read_bool(value))
             {
-                return false;
+                logging::log_warn("Value expected to be a boolean, but was neither true nor false. Setting to false.");
+                reader.skip_value();
             }
-            else
+
+            return value;
+        }
+
+        /**
+         * \brief Parses a json string. If the value is not a string, an empty
+         * string is returned.
+         * \param reader The reader, positioned at a string.
+         * \return The contents of the string.
+         */
+        static std::string parse_string(json_helpers::JsonReader& reader)
+        {
+            std::string value;
+            if (!reader.read_string(value))
             {
-                logging::log_warn("Value expected to be a boolean, but was neither true nor false. Setting to false.");
-                return false;
+                reader.skip_value();
             }
+
+            return value;
         }
 
         /**
@@ -188,88 +179,81 @@ namespace pew::eos::config
          * \param default_value If no value is provided or can be determined,
          * this is the returned value.
          *
-         * \param value The JSON value that contains the strings used to parse
-         * into the value.
+         * \param reader The reader, positioned at the string that contains
+         * the comma-delimited flag names.
          *
          * \return The value (flag) determined by parsing the JSON.
          */
-        template<typename T, typename = std::enable_if_t< 
+        template<typename T, size_t N, typename = std::enable_if_t< 
                      std::is_same_v<T, int> ||
                      std::is_same_v<T, EOS_EAuthScopeFlags> ||
                      std::is_same_v<T, EOS_EIntegratedPlatformManagementFlags> ||
                      std::is_same_v<T, EOS_UI_EInputStateButtonFlags>
                  >>
-        static T parse_flags(const std::map<std::string, T>* strings_to_enum_values, T default_value, json_value_s* value)
+        static T parse_flags(const StaticStringMap<T, N>* strings_to_enum_values, T default_value, json_helpers::JsonReader& reader)
         {
             T flags_to_return = static_cast<T>(0);
             bool flag_set = false;
 
-            const auto json_value_string = json_value_as_string(value);
-            if (json_value_string == nullptr)
+            std::string_view flags_str;
+            if (!reader.read_string_view(flags_str))
             {
+                reader.skip_value();
                 return default_value;
             }
 
-            const std::string flags_str = json_value_string->string;
-
-            const std::vector<std::string> string_values = string_helpers::split_and_trim(flags_str);
-
             // Iterate through the string values
-            for (const auto str : string_values)
+            string_helpers::for_each_token(flags_str, ',', [&](std::string_view str)
             {
                 // Skip if the string is not in the map
-                if (strings_to_enum_values->find(str) == strings_to_enum_values->end())
+                const T* enum_value = strings_to_enum_values->find(str);
+                if (enum_value == nullptr)
                 {
-                    continue;
+                    return;
                 }
 
                 // Otherwise, append the enum value
-                flags_to_return |= strings_to_enum_values->at(str);
+                flags_to_return |= *enum_value;
                 flag_set = true;
-            }
+            });
 
             return (flag_set) ? flags_to_return : default_value;
         }
 
     public:
 
-        virtual void from_json(const json_value_s& json_value)
-        {
-            // Convert the value to json object
-            const auto json_object = static_cast<json_object_s*>(json_value.payload);
-            // Use the object to parse
-            from_json(*json_object);
-        }
-
         /**
-         * \brief Parses each element of the json object that is provided.
-         * \param json The json object.
+         * \brief Parses each element of the json object that the reader is
+         * positioned at. If the value is not an object, it is skipped.
+         * \param reader The reader, positioned at a json object.
          */
-        virtual void from_json(const json_object_s& json)
+        virtual void from_json(json_helpers::JsonReader& reader)
         {
-            auto json_object_iterator = json.start;
+            if (!reader.begin_object())
+            {
+                reader.skip_value();
+                return;
+            }
+
+            std::string_view element_name;
 
             // While there are still items to parse
-            while(json_object_iterator)
+            while (reader.next_member(element_name))
             {
-                auto element = *(json_object_iterator->value);
-                const std::string element_name = json_object_iterator->name->string;
+                const size_t value_offset = reader.offset();
 
                 // Use the deriving class' parse_json_element function to parse
                 // the value.
-                parse_json_element(json_object_iterator->name->string, *(json_object_iterator->value));
+                parse_json_element(element_name, reader);
 
-                if (json_object_iterator == nullptr)
+                // Skip elements that the deriving class does not know about.
+                if (reader.offset() == value_offset)
                 {
-                    break;
+                    reader.skip_value();
                 }
-
-                // Move to the next element
-                json_object_iterator = json_object_iterator->next;
             }
         }
     };
 }
 
 #endif
-#pragma once
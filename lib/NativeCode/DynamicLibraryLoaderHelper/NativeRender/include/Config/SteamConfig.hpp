@@ -110,40 +110,83 @@ namespace pew::eos::config
             _library_path = io_helpers::get_path_relative_to_current_module(STEAM_SDK_DLL_NAME);
         }
 
-        void parse_json_element(const std::string& name, json_value_s& value) override
+        bool from_blob(const config_blob::Section& section) override
         {
-            if (name == "overrideLibraryPath")
+            const auto record = section.get_record<config_blob::SteamConfigRecord>();
+            if (record == nullptr)
             {
-                const auto override_library_path_element = json_value_as_string(&value);
-                if (override_library_path_element == nullptr)
-                {
-                    return;
-                }
-                const char* path = override_library_path_element->string;
-                if (!string_helpers::is_empty_or_whitespace(path))
-                {
-                    _library_path = path;
-                }
+                return false;
             }
-            else if (name == "steamSDKMajorVersion")
-            {
-                steam_sdk_major_version = parse_number<uint32_t>(value);
-            }
-            else if (name == "steamSDKMinorVersion")
-            {
-                steam_sdk_minor_version = parse_number<uint32_t>(value);
-            }
-            else if (name == "steamApiInterfaceVersionsArray")
+
+            steam_sdk_major_version = record->steam_sdk_major_version;
+            steam_sdk_minor_version = record->steam_sdk_minor_version;
+            integrated_platform_management_flags = static_cast<EOS_EIntegratedPlatformManagementFlags>(record->integrated_platform_management_flags);
+
+            const auto library_path = section.get_string(record->library_path);
+            if (!library_path.empty())
             {
-                _steam_api_interface_versions_array = parse_json_array<std::string>(value);
+                _library_path = std::string(library_path);
             }
-            else if (name == "integratedPlatformManagementFlags")
+
+            _steam_api_interface_versions_array = section.get_strings(record->steam_api_interface_versions);
+
+            return true;
+        }
+
+        void to_blob(config_blob::BlobWriter& writer, std::string_view source_contents) const override
+        {
+            config_blob::SteamConfigRecord record = {};
+            record.steam_sdk_major_version = steam_sdk_major_version;
+            record.steam_sdk_minor_version = steam_sdk_minor_version;
+            record.integrated_platform_management_flags = static_cast<int32_t>(integrated_platform_management_flags);
+
+            // The default library path is relative to wherever the plugin is
+            // loaded from, so only a path from the config file is stored.
+            const auto default_library_path = io_helpers::get_path_relative_to_current_module(STEAM_SDK_DLL_NAME);
+            record.library_path = writer.add_string(_library_path != default_library_path ? _library_path.string() : std::string());
+
+            record.steam_api_interface_versions = writer.add_strings(_steam_api_interface_versions_array);
+
+            writer.add_section(get_file_name(), source_contents, record);
+        }
+
+        void parse_json_element(std::string_view name, json_helpers::JsonReader& reader) override
+        {
+            static constexpr auto element_parsers = make_static_string_map<JsonElementParser<SteamConfig>>({
+                { "overrideLibraryPath", [](SteamConfig& config, json_helpers::JsonReader& reader)
+                {
+                    const std::string path = parse_string(reader);
+                    if (!string_helpers::is_empty_or_whitespace(path.c_str()))
+                    {
+                        config._library_path = path;
+                    }
+                }},
+                { "steamSDKMajorVersion", [](SteamConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.steam_sdk_major_version = parse_number<uint32_t>(reader);
+                }},
+                { "steamSDKMinorVersion", [](SteamConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.steam_sdk_minor_version = parse_number<uint32_t>(reader);
+                }},
+                { "steamApiInterfaceVersionsArray", [](SteamConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config._steam_api_interface_versions_array = parse_json_array<std::string>(reader);
+                }},
+                { "integratedPlatformManagementFlags", [](SteamConfig& config, json_helpers::JsonReader& reader)
+                {
+                    config.integrated_platform_management_flags =
+                        parse_flags<EOS_EIntegratedPlatformManagementFlags>(
+                            &config_legacy::INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM,
+                            EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled,
+                            reader);
+                }},
+            });
+
+            const auto parser = element_parsers.find(name);
+            if (parser != nullptr)
             {
-                integrated_platform_management_flags =
-                    parse_flags<EOS_EIntegratedPlatformManagementFlags>(
-                        &config_legacy::INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM,
-                        EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled,
-                        &value);
+                (*parser)(*this, reader);
             }
         }
 
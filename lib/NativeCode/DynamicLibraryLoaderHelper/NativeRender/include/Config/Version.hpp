@@ -25,8 +25,10 @@
 
 #pragma once
 
-#include <sstream>
-#include <string>
+#include <charconv>
+#include <string_view>
+
+#include "string_helpers.h"
 
 namespace pew::eos::config
 {
@@ -63,56 +65,52 @@ namespace pew::eos::config
             return !(*this < other);
         }
 
-        static bool try_parse(const std::string& str, Version& version)
+        static bool try_parse(std::string_view str, Version& version)
         {
-            // Temporary variables to hold parsed values
-            int temp_major = 0;
-            int temp_minor = 0;
-            int temp_part = 0;
-
-            // Stream to parse the input
-            std::istringstream stream(str);
-            std::string segment;
+            // Only the major, minor and patch segments are read; anything
+            // after them is ignored.
+            const auto segments = string_helpers::split_view<3>(str, '.');
 
-            // Read major version
-            if (!std::getline(stream, segment, '.') || !try_parse_int(segment, temp_major))
-                return false;
-
-            // Check for minor version
-            if (std::getline(stream, segment, '.'))
+            // Temporary variables to hold parsed values
+            int parts[3] = { 0, 0, 0 };
+            const size_t segment_count = segments.size() < 3 ? segments.size() : 3;
+            for (size_t index = 0; index < segment_count; ++index)
             {
-                if (!try_parse_int(segment, temp_minor))
-                    return false;
+                // A trailing dot (as in "1.2.") leaves the remaining parts at
+                // zero.
+                if (index > 0 && index == segments.size() - 1 && segments[index].empty())
+                {
+                    break;
+                }
 
-                // Check for part version
-                if (std::getline(stream, segment, '.'))
+                if (!try_parse_int(segments[index], parts[index]))
                 {
-                    if (!try_parse_int(segment, temp_part))
-                        return false;
+                    return false;
                 }
             }
 
             // Update the output if parsing was successful
-            version.major = temp_major;
-            version.minor = temp_minor;
-            version.patch = temp_part;
+            version.major = parts[0];
+            version.minor = parts[1];
+            version.patch = parts[2];
             return true;
         }
     private:
         friend struct Config;
 
-        static bool try_parse_int(const std::string& str, int& value)
+        static bool try_parse_int(std::string_view str, int& value)
         {
-            try
+            // Like std::stoi, accept leading whitespace and a plus sign, but
+            // require the entire string to be a number.
+            str = string_helpers::trim_view(str);
+            if (!str.empty() && str.front() == '+')
             {
-                size_t pos = 0;
-                value = std::stoi(str, &pos);
-                return pos == str.size(); // Ensure the entire string was parsed
-            }
-            catch (...)
-            {
-                return false;
+                str.remove_prefix(1);
             }
+
+            const char* const end = str.data() + str.size();
+            const auto [parsed_end, error] = std::from_chars(str.data(), end, value);
+            return error == std::errc() && parsed_end == end && !str.empty();
         }
     };
 }
@@ -52,6 +52,10 @@
  * \param return_value Syntax to affect the exposure of the method to callers
  * external to the DLL.
  */
+#ifdef _WIN32
 #define PEW_EOS_API_FUNC(return_value) extern "C" PEW_EOS_API return_value __stdcall
+#else
+#define PEW_EOS_API_FUNC(return_value) extern "C" PEW_EOS_API return_value
+#endif
 
 #endif
@@ -0,0 +1,344 @@
+#ifndef CONFIG_BLOB_H
+#define CONFIG_BLOB_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "PEW_EOS_Defines.h"
+#include "file_view.h"
+
+ /**
+  * @file config_blob.h
+  * @brief Precompiled binary form of the JSON config files.
+  *
+  * The config blob holds the already-parsed values of every config file in a
+  * single flat file that is memory-mapped and read in place. It is laid out as
+  * a BlobHeader, followed by the records of each section (one per source JSON
+  * file), the arrays and strings they reference, and finally the table of
+  * BlobSection entries. All offsets are relative to the start of the blob, and
+  * every string is stored null-terminated, so it can be used directly from the
+  * mapping.
+  *
+  * Each section records the size and a hash of the JSON file it was compiled
+  * from. When the JSON file is present and no longer matches, the section is
+  * considered stale and the JSON file is parsed instead.
+  */
+
+namespace pew::eos::config_blob
+{
+    /**
+     * @brief Identifies a config blob file.
+     */
+    constexpr char BLOB_MAGIC[8] = { 'P', 'E', 'W', 'C', 'F', 'G', 'B', '\0' };
+
+    /**
+     * @brief Version of the blob layout. Increment whenever BlobHeader,
+     * BlobSection, or any of the record structs change.
+     */
+    constexpr uint32_t BLOB_VERSION = 4;
+
+    /**
+     * @brief Reference to a null-terminated string stored in the blob.
+     */
+    struct BlobString
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /**
+     * @brief Reference to an array of records stored in the blob.
+     */
+    struct BlobArray
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    struct BlobHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t total_size;
+        uint32_t section_table_offset;
+        uint32_t section_count;
+    };
+
+    struct BlobSection
+    {
+        /**
+         * @brief File name of the JSON file the section was compiled from
+         * (e.g. "eos_product_config.json").
+         */
+        BlobString source_name;
+        uint32_t record_offset;
+        uint32_t record_size;
+        uint64_t source_size;
+        uint64_t source_hash;
+    };
+
+    struct ClientCredentialsRecord
+    {
+        BlobString client_id;
+        BlobString client_secret;
+        BlobString encryption_key;
+    };
+
+    struct DeploymentRecord
+    {
+        BlobString id;
+        BlobString sandbox_id;
+    };
+
+    struct ProductConfigRecord
+    {
+        BlobString product_name;
+        BlobString product_id;
+        BlobString product_version;
+        BlobArray deployments;   // DeploymentRecord
+        BlobArray sandboxes;     // BlobString
+        BlobArray clients;       // ClientCredentialsRecord
+    };
+
+    struct PlatformConfigRecord
+    {
+        DeploymentRecord deployment;
+        ClientCredentialsRecord client_credentials;
+        uint32_t is_server;
+        int32_t platform_options_flags;
+        int32_t auth_scope_flags;
+        int32_t integrated_platform_management_flags;
+        int32_t tick_budget_in_milliseconds;
+        uint32_t has_thread_affinity;
+        double task_network_timeout_seconds;
+        uint64_t thread_affinity[8];
+        uint32_t always_send_input_to_overlay;
+        float initial_button_delay_for_overlay;
+        float repeat_button_delay_for_overlay;
+        int32_t toggle_friends_button_combination;
+        uint32_t auto_thread_affinity;
+        uint32_t native_tick_rate;
+        float frame_budget_in_milliseconds;
+        BlobString override_country_code;
+        BlobString override_locale_code;
+    };
+
+    struct SteamConfigRecord
+    {
+        uint32_t steam_sdk_major_version;
+        uint32_t steam_sdk_minor_version;
+        int32_t integrated_platform_management_flags;
+        uint32_t reserved;
+        BlobString library_path;                    // Empty if not overridden
+        BlobArray steam_api_interface_versions;     // BlobString
+    };
+
+    struct LogLevelConfigRecord
+    {
+        BlobArray categories;   // BlobString
+        BlobArray levels;       // BlobString
+    };
+
+    /**
+     * @brief Computes the hash that identifies the contents of a source JSON
+     * file (64-bit FNV-1a).
+     */
+    uint64_t hash_contents(std::string_view contents);
+
+    /**
+     * @brief Builds a config blob in memory.
+     */
+    class BlobWriter
+    {
+    public:
+        BlobWriter();
+
+        /**
+         * @brief Adds a string to the blob.
+         */
+        BlobString add_string(std::string_view value);
+
+        /**
+         * @brief Adds an array of records to the blob.
+         */
+        template <typename T>
+        BlobArray add_array(const std::vector<T>& items)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Blob records must be trivially copyable.");
+            return { append(items.data(), sizeof(T) * items.size()), static_cast<uint32_t>(items.size()) };
+        }
+
+        /**
+         * @brief Adds an array of strings to the blob.
+         */
+        BlobArray add_strings(const std::vector<std::string>& values);
+
+        /**
+         * @brief Adds a section to the blob.
+         *
+         * @param source_name The file name of the JSON file that the section
+         * was compiled from.
+         * @param source_contents The contents of that JSON file.
+         * @param record The record holding the values of the section.
+         */
+        template <typename T>
+        void add_section(const std::string& source_name, std::string_view source_contents, const T& record)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Blob records must be trivially copyable.");
+            add_section(source_name, source_contents, &record, sizeof(T));
+        }
+
+        /**
+         * @brief Writes the section table and header, and returns the finished
+         * blob. The writer must not be used afterwards.
+         */
+        std::vector<char> finish();
+
+    private:
+        uint32_t append(const void* data, size_t size);
+        void add_section(const std::string& source_name, std::string_view source_contents, const void* record, size_t record_size);
+
+        std::vector<char> _buffer;
+        std::vector<BlobSection> _sections;
+    };
+
+    /**
+     * @brief A section of a config blob, as read from the mapped file.
+     */
+    class Section
+    {
+    public:
+        Section(const char* blob, size_t blob_size, const BlobSection& section);
+
+        /**
+         * @brief Gets the record of the section, or `nullptr` if the section
+         * does not hold a record of the given type.
+         */
+        template <typename T>
+        const T* get_record() const
+        {
+            return (_section.record_size == sizeof(T)) ? get<T>(_section.record_offset, 1) : nullptr;
+        }
+
+        /**
+         * @brief Gets a string stored in the blob. Returns an empty string if
+         * the reference is out of bounds.
+         */
+        std::string_view get_string(const BlobString& value) const;
+
+        /**
+         * @brief Gets an array of records stored in the blob. Returns an empty
+         * vector if the reference is out of bounds.
+         */
+        template <typename T>
+        std::vector<T> get_array(const BlobArray& value) const
+        {
+            const T* items = get<T>(value.offset, value.count);
+            return (items == nullptr) ? std::vector<T>() : std::vector<T>(items, items + value.count);
+        }
+
+        /**
+         * @brief Gets an array of strings stored in the blob.
+         */
+        std::vector<std::string> get_strings(const BlobArray& value) const;
+
+        /**
+         * @brief Determines whether the section still matches the JSON file it
+         * was compiled from. A section whose JSON file does not exist (for
+         * instance because only the blob was deployed) is current.
+         */
+        bool is_current(const std::filesystem::path& source_path) const;
+
+    private:
+        template <typename T>
+        const T* get(uint64_t offset, uint64_t count) const
+        {
+            if (offset % alignof(T) != 0 || offset + sizeof(T) * count > _blob_size)
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<const T*>(_blob + offset);
+        }
+
+        const char* _blob;
+        size_t _blob_size;
+        BlobSection _section;
+    };
+
+    /**
+     * @brief A config blob file, mapped into memory.
+     */
+    class ConfigBlob
+    {
+    public:
+        /**
+         * @brief Gets the config blob at the given path. The blob is mapped
+         * once and shared by every caller asking for the same path, until the
+         * file changes.
+         *
+         * @return The blob, or `nullptr` if the file does not exist or is not
+         * a valid config blob.
+         */
+        static std::shared_ptr<const ConfigBlob> open_shared(const std::filesystem::path& path);
+
+        /**
+         * @brief Stops sharing the blob mapped from the given path, so that
+         * the file can be replaced. Callers that still hold the blob keep it
+         * until they release it.
+         */
+        static void release_shared(const std::filesystem::path& path);
+
+        /**
+         * @brief Finds the section compiled from the JSON file with the given
+         * file name.
+         *
+         * @return The section, or `nullptr` if the blob has no such section.
+         */
+        std::unique_ptr<Section> find_section(std::string_view source_name) const;
+
+    private:
+        bool open(const std::filesystem::path& path);
+
+        io_helpers::FileView _view;
+        const BlobHeader* _header = nullptr;
+    };
+
+    /**
+     * @brief Compiles every config file in the config directory into a config
+     * blob at the given path. Config files that do not exist are skipped.
+     *
+     * @param output_path The path to write the blob to.
+     * @return `true` if the blob was written, `false` otherwise.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_CompileConfigBlob(const char* output_path);
+}
+#endif
@@ -26,11 +26,12 @@
 #pragma once
 
 #include <filesystem>
-#include <map>
 #include <vector>
 #include <optional>
 
+#include "config_blob.h"
 #include "json.h"
+#include "static_string_map.h"
 #include "eos_sdk.h"
 
 struct json_value_s;
@@ -49,7 +50,7 @@ namespace pew::eos::config_legacy
      * \brief Maps string values to values within the
      * EOS_EIntegratedPlatformManagementFlags enum.
      */
-    static const std::map<std::string, EOS_EIntegratedPlatformManagementFlags> INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM = {
+    inline constexpr auto INTEGRATED_PLATFORM_MANAGEMENT_FLAGS_STRINGS_TO_ENUM = make_static_string_map<EOS_EIntegratedPlatformManagementFlags>({
         {"EOS_IPMF_Disabled",                        EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled },
         {"Disabled",                                 EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled },
 
@@ -85,15 +86,7 @@ namespace pew::eos::config_legacy
 
         {"EOS_IPMF_ApplicationManagedIdentityLogin", EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_ApplicationManagedIdentityLogin },
         {"ApplicationManagedIdentityLogin",          EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_ApplicationManagedIdentityLogin}
-    };
-
-    /**
-     * @brief Typedef for a function pointer that retrieves the configuration as a JSON string.
-     *
-     * This function pointer type represents a function that, when called,
-     * returns the configuration data as a JSON-formatted string.
-     */
-    typedef const char* (*GetConfigAsJSONString_t)();
+    });
 
     /**
      * @brief Holds configuration for log levels and categories.
@@ -136,14 +129,35 @@ namespace pew::eos::config_legacy
     };
 
     /**
-     * @brief Parses a JSON configuration object to create a log level configuration.
+     * @brief Parses the contents of the log level config file.
      *
-     * Extracts log category and level pairs from a JSON structure, storing them in a `LogLevelConfig` object.
+     * Extracts log category and level pairs from the JSON text, storing them in a `LogLevelConfig` object.
      *
-     * @param config_json The JSON value representing the configuration.
-     * @return A `LogLevelConfig` object populated with log categories and their levels.
+     * @param json_content The contents of the log level config file.
+     * @return A `LogLevelConfig` object populated with log categories and their levels, which is empty if the
+     * contents are not valid JSON.
      */
-    LogLevelConfig log_config_from_json_value(json_value_s* config_json);
+    LogLevelConfig log_config_from_json(std::string_view json_content);
+
+    /**
+     * @brief Reads the log level configuration from the config blob, if the
+     * blob has an up-to-date section for the log level config file.
+     *
+     * @param config_path The path to the log level config file.
+     * @param log_config The log level configuration that is read.
+     * @return `true` if the configuration was read from the blob, `false` if
+     * the config file needs to be parsed instead.
+     */
+    bool log_config_from_blob(const std::filesystem::path& config_path, LogLevelConfig& log_config);
+
+    /**
+     * @brief Adds a log level configuration to a config blob.
+     *
+     * @param writer The writer of the config blob.
+     * @param source_contents The contents of the log level config file.
+     * @param log_config The log level configuration parsed from that file.
+     */
+    void log_config_to_blob(config_blob::BlobWriter& writer, std::string_view source_contents, const LogLevelConfig& log_config);
 
     /**
      * @brief Retrieves the path to the EOS service configuration file.
@@ -156,18 +170,6 @@ namespace pew::eos::config_legacy
      */
     std::filesystem::path get_path_for_eos_service_config(const std::string& config_filename);
 
-    /**
-     * @brief Reads a JSON configuration from a DLL.
-     *
-     * TODO: This is no longer supported, it should be removed.
-     *
-     * Attempts to load configuration data from a DLL. The function retrieves the
-     * JSON configuration string from the DLL, parses it, and returns the parsed JSON object.
-     *
-     * @return A pointer to a `json_value_s` representing the configuration data, or `nullptr` if loading fails.
-     */
-    json_value_s* read_config_json_from_dll();
-
     /**
      * @brief Collects integrated platform management flags from a JSON element.
      *
@@ -0,0 +1,141 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file config_snapshot.h
+  * @brief Hands the parsed product and platform configs to managed code.
+  *
+  * The snapshot is a single block of memory: a ConfigSnapshot, followed by
+  * the null-terminated UTF-8 contents of all of its strings. It holds no
+  * pointers, so it can be copied out with one call and read without any
+  * further calls into the plugin. The layout is mirrored by
+  * NativeConfigSnapshot.cs in the managed package; change both together and
+  * increment CONFIG_SNAPSHOT_VERSION.
+  */
+
+namespace pew::eos::config_snapshot
+{
+    /**
+     * @brief Version of the ConfigSnapshot layout.
+     */
+    constexpr uint32_t CONFIG_SNAPSHOT_VERSION = 1;
+
+    /**
+     * @brief A string stored after the ConfigSnapshot.
+     */
+    struct ConfigSnapshotString
+    {
+        /**
+         * @brief Offset of the first byte, from the start of the snapshot.
+         */
+        uint32_t offset;
+
+        /**
+         * @brief Length in bytes, not counting the null terminator.
+         */
+        uint32_t length;
+    };
+
+    struct ConfigSnapshot
+    {
+        uint32_t version;
+
+        /**
+         * @brief Size in bytes of the whole snapshot, strings included.
+         */
+        uint32_t total_size;
+
+        ConfigSnapshotString product_name;
+        ConfigSnapshotString product_version;
+        ConfigSnapshotString product_id;
+        ConfigSnapshotString sandbox_id;
+        ConfigSnapshotString deployment_id;
+        ConfigSnapshotString client_id;
+        ConfigSnapshotString client_secret;
+        ConfigSnapshotString encryption_key;
+        ConfigSnapshotString cache_directory;
+        ConfigSnapshotString override_country_code;
+        ConfigSnapshotString override_locale_code;
+
+        uint32_t is_server;
+        int32_t platform_options_flags;
+        int32_t auth_scope_flags;
+        int32_t integrated_platform_management_flags;
+        int32_t tick_budget_in_milliseconds;
+
+        /**
+         * @brief Non-zero if thread_affinity holds the affinity that the SDK
+         * is initialized with (automatic placement already applied).
+         */
+        uint32_t has_thread_affinity;
+        double task_network_timeout_seconds;
+
+        /**
+         * @brief NetworkWork, StorageIo, WebSocketIo, P2PIo, HttpRequestIo,
+         * RTCIo, EmbeddedOverlayMainThread and EmbeddedOverlayWorkerThreads.
+         */
+        uint64_t thread_affinity[8];
+
+        uint32_t always_send_input_to_overlay;
+        float initial_button_delay_for_overlay;
+        float repeat_button_delay_for_overlay;
+        int32_t toggle_friends_button_combination;
+    };
+
+    static_assert(sizeof(ConfigSnapshot) == 208, "The managed mirror of ConfigSnapshot depends on its layout.");
+
+    /**
+     * @brief Determines whether a snapshot that came from outside the plugin
+     * has the current layout, and whether all of its strings lie within it
+     * and are null-terminated.
+     */
+    bool is_valid(const ConfigSnapshot* snapshot);
+
+    /**
+     * @brief Gets a string of a snapshot that is valid (see is_valid). The
+     * data of the returned view is null-terminated.
+     */
+    std::string_view get_string(const ConfigSnapshot& snapshot, ConfigSnapshotString value);
+
+    /**
+     * @brief Gets a snapshot of the product config and of the platform config
+     * for the current platform, as the plugin uses them to create the
+     * platform (command line overrides included).
+     *
+     * The snapshot is rebuilt when either config has been reloaded since the
+     * previous call, so the returned memory is only valid until the next
+     * call; copy it before calling again.
+     *
+     * @return The snapshot, or `nullptr` if the configs could not be read.
+     */
+    PEW_EOS_API_FUNC(const ConfigSnapshot*) PEW_EOS_GetConfigSnapshot();
+}
+#endif
@@ -0,0 +1,83 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+ /**
+  * @file config_watcher.h
+  * @brief Notifies subscribers when config files change on disk.
+  *
+  * Each directory that contains a subscribed file is watched by a thread of
+  * its own (using inotify on Linux and ReadDirectoryChangesW on Windows).
+  * Because editors commonly save a file in several steps, a change is only
+  * reported once the file has not changed for a short while. Handlers are
+  * called on the watcher thread, so anything they do must be safe to do off
+  * the main thread.
+  */
+
+namespace pew::eos::config_watcher
+{
+    /**
+     * @brief Identifies a subscription, so that it can be removed again.
+     * Zero is never a valid subscription.
+     */
+    using SubscriptionId = uint64_t;
+
+    /**
+     * @brief Function that is called after a watched file has changed.
+     */
+    using ChangeHandler = std::function<void()>;
+
+    /**
+     * @brief Calls the given handler whenever the file at the given path is
+     * written to or replaced. Changes are not reported while the file does
+     * not exist.
+     *
+     * @param file_path The path of the file to watch.
+     * @param handler The function to call after the file has changed.
+     * @return The id of the subscription, or zero if the directory of the file
+     * cannot be watched.
+     */
+    SubscriptionId subscribe(const std::filesystem::path& file_path, ChangeHandler handler);
+
+    /**
+     * @brief Removes a subscription. The handler may still be running on the
+     * watcher thread when this returns.
+     *
+     * @param subscription_id The id returned by subscribe.
+     */
+    void unsubscribe(SubscriptionId subscription_id);
+
+    /**
+     * @brief Stops watching every directory and removes all subscriptions.
+     * Waits for any handler that is running to finish, so this must not be
+     * called from a handler.
+     */
+    void stop();
+}
+#endif
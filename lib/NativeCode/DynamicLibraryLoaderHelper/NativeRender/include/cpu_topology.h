@@ -0,0 +1,73 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "eos_init.h"
+
+ /**
+  * @file cpu_topology.h
+  * @brief Reads the processor layout of the machine, and uses it to place the
+  * threads of the EOS SDK.
+  *
+  * Processors are identified by their bit in an affinity mask, which is also
+  * how EOS_Initialize_ThreadAffinity identifies them. Only the first 64
+  * logical processors (on Windows, those of the first processor group) can be
+  * represented that way; any others are ignored.
+  */
+
+namespace pew::eos::cpu_topology
+{
+    /**
+     * @brief Number of physical cores that auto placement keeps free for the
+     * threads of the game: one for the main thread, and one for the render
+     * thread.
+     */
+    constexpr size_t RESERVED_GAME_CORES = 2;
+
+    /**
+     * @brief Gets the physical cores that the process is allowed to run on.
+     *
+     * @return One affinity mask per physical core, holding the logical
+     * processors (hardware threads) of that core, ordered by the lowest
+     * logical processor of each core. Empty if the topology cannot be read.
+     */
+    std::vector<uint64_t> get_physical_cores();
+
+    /**
+     * @brief Places the network, P2P, RTC and HTTP threads of the EOS SDK on
+     * the cores that are not reserved for the game's main and render threads
+     * (the first RESERVED_GAME_CORES physical cores), and logs the chosen
+     * layout. Affinities that are already set are kept.
+     *
+     * @param thread_affinity The thread affinity to fill in.
+     * @return `true` if the affinity was changed, `false` if the machine has
+     * too few cores to keep the EOS threads apart from the game's.
+     */
+    bool apply_auto_thread_affinity(EOS_Initialize_ThreadAffinity& thread_affinity);
+}
+#endif
@@ -23,7 +23,9 @@
  */
 
 #pragma once
+#ifdef _WIN32
 #include "Windows/eos_Windows.h"
+#endif
 #include "PEW_EOS_Defines.h"
 #include <eos_types.h>
 
@@ -45,10 +47,20 @@ namespace pew::eos
 #endif
     PEW_EOS_API_FUNC(void) UnityPluginLoad(void*);
 
+    /**
+     * @brief Loads the plugin like UnityPluginLoad does, but creates the
+     * default platform as a server platform regardless of the platform
+     * config. Used by hosts that run without Unity, such as the headless
+     * host of the ConsoleApplication. Call UnityPluginUnload to unload.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_LoadAsServer();
+
     /**
      * @brief Retrieves the EOS platform interface handle.
      *
-     * Provides access to the EOS platform interface handle managed by the library.
+     * Provides access to the default platform, the one the library creates
+     * when it is loaded. Other platforms are looked up by their id with
+     * PEW_EOS_GetPlatform.
      *
      * @return A pointer to the EOS platform interface handle.
      */
@@ -115,6 +127,15 @@ namespace pew::eos
      */
     EOS_Platform_Options get_create_options(const PlatformConfig& platform_config, const ProductConfig& product_config);
 
+    /**
+     * @brief Releases what get_create_options allocated for the platform
+     * options: the integrated platform options container and the task
+     * network timeout. Call once the platform has been created.
+     *
+     * @param platform_options The platform options to release.
+     */
+    void release_create_options(EOS_Platform_Options& platform_options);
+
     /**
      * \brief Apply Steam configuration values to the platform options.
      * \param platform_options The platform options object to apply the steam
@@ -138,10 +159,32 @@ namespace pew::eos
      *
      * Configures and creates an EOS platform instance. This includes setting up RTC options,
      * integrated platform options, and other settings defined in the configuration.
+     * If the config sets a native tick rate, the tick driver is started as well,
+     * and the tick controller is given the frame budget from the config.
      *
      * @param platform_config The config for the platform.
      * @param product_config The config for the product.
+     * @param as_server Whether to create a server platform even if the
+     * platform config does not say so.
+     */
+    void eos_create(const PlatformConfig& platform_config, const ProductConfig& product_config, bool as_server = false);
+
+    /**
+     * @brief Handles a change to the platform config while the platform is
+     * running.
+     *
+     * The EOS SDK only takes its options when the platform is created, so the
+     * new values of the runtime-tunable settings (the tick budget and the
+     * network task timeout) are not pushed into the SDK. They are available
+     * from the new config snapshot to native code that ticks the platform,
+     * and everything else takes effect the next time the platform is created.
+     * This logs which of the runtime-tunable settings changed, passes a new frame
+     * budget to the tick controller, and restarts the tick driver if its rate
+     * changed and the host allows the driver.
+     *
+     * @param previous_config The platform config before the change.
+     * @param platform_config The platform config after the change.
      */
-    void eos_create(const PlatformConfig& platform_config, const ProductConfig& product_config);
+    void eos_platform_config_changed(const PlatformConfig& previous_config, const PlatformConfig& platform_config);
 }
 #endif
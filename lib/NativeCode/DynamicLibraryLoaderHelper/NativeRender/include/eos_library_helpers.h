@@ -38,31 +38,69 @@ namespace pew::eos::eos_library_helpers
     typedef EOS_EResult(EOS_CALL* EOS_Initialize_t)(const EOS_InitializeOptions* Options);
     typedef EOS_EResult(EOS_CALL* EOS_Shutdown_t)();
     typedef EOS_HPlatform(EOS_CALL* EOS_Platform_Create_t)(const EOS_Platform_Options* Options);
+    typedef void(EOS_CALL* EOS_Platform_Tick_t)(EOS_HPlatform Handle);
+    typedef void(EOS_CALL* EOS_Platform_Release_t)(EOS_HPlatform Handle);
     typedef EOS_EResult(EOS_CALL* EOS_Logging_SetCallback_t)(EOS_LogMessageFunc Callback);
     typedef EOS_EResult(EOS_CALL* EOS_Logging_SetLogLevel_t)(EOS_ELogCategory LogCategory, EOS_ELogLevel LogLevel);
     typedef EOS_EResult(*EOS_IntegratedPlatformOptionsContainer_Add_t)(EOS_HIntegratedPlatformOptionsContainer Handle, const EOS_IntegratedPlatformOptionsContainer_AddOptions* InOptions);
     typedef EOS_EResult(*EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_t)(const EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainerOptions* Options, EOS_HIntegratedPlatformOptionsContainer* OutIntegratedPlatformOptionsContainerHandle);
     typedef void (*EOS_IntegratedPlatformOptionsContainer_Release_t)(EOS_HIntegratedPlatformOptionsContainer IntegratedPlatformOptionsContainerHandle);
 
+    typedef EOS_HP2P(EOS_CALL* EOS_Platform_GetP2PInterface_t)(EOS_HPlatform Handle);
+    typedef EOS_HLobby(EOS_CALL* EOS_Platform_GetLobbyInterface_t)(EOS_HPlatform Handle);
+    typedef EOS_HPresence(EOS_CALL* EOS_Platform_GetPresenceInterface_t)(EOS_HPlatform Handle);
+    typedef EOS_HRTC(EOS_CALL* EOS_Platform_GetRTCInterface_t)(EOS_HPlatform Handle);
+    typedef EOS_NotificationId(EOS_CALL* EOS_P2P_AddNotifyPeerConnectionRequest_t)(EOS_HP2P Handle, const EOS_P2P_AddNotifyPeerConnectionRequestOptions* Options, void* ClientData, EOS_P2P_OnIncomingConnectionRequestCallback ConnectionRequestHandler);
+    typedef void(EOS_CALL* EOS_P2P_RemoveNotifyPeerConnectionRequest_t)(EOS_HP2P Handle, EOS_NotificationId NotificationId);
+    typedef EOS_EResult(EOS_CALL* EOS_P2P_ReceivePacket_t)(EOS_HP2P Handle, const EOS_P2P_ReceivePacketOptions* Options, EOS_ProductUserId* OutPeerId, EOS_P2P_SocketId* OutSocketId, uint8_t* OutChannel, void* OutData, uint32_t* OutBytesWritten);
+    typedef EOS_NotificationId(EOS_CALL* EOS_Lobby_AddNotifyLobbyUpdateReceived_t)(EOS_HLobby Handle, const EOS_Lobby_AddNotifyLobbyUpdateReceivedOptions* Options, void* ClientData, const EOS_Lobby_OnLobbyUpdateReceivedCallback NotificationFn);
+    typedef void(EOS_CALL* EOS_Lobby_RemoveNotifyLobbyUpdateReceived_t)(EOS_HLobby Handle, EOS_NotificationId InId);
+    typedef EOS_NotificationId(EOS_CALL* EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_t)(EOS_HLobby Handle, const EOS_Lobby_AddNotifyLobbyMemberUpdateReceivedOptions* Options, void* ClientData, const EOS_Lobby_OnLobbyMemberUpdateReceivedCallback NotificationFn);
+    typedef void(EOS_CALL* EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_t)(EOS_HLobby Handle, EOS_NotificationId InId);
+    typedef EOS_NotificationId(EOS_CALL* EOS_Lobby_AddNotifyLobbyMemberStatusReceived_t)(EOS_HLobby Handle, const EOS_Lobby_AddNotifyLobbyMemberStatusReceivedOptions* Options, void* ClientData, const EOS_Lobby_OnLobbyMemberStatusReceivedCallback NotificationFn);
+    typedef void(EOS_CALL* EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_t)(EOS_HLobby Handle, EOS_NotificationId InId);
+    typedef EOS_NotificationId(EOS_CALL* EOS_Presence_AddNotifyOnPresenceChanged_t)(EOS_HPresence Handle, const EOS_Presence_AddNotifyOnPresenceChangedOptions* Options, void* ClientData, const EOS_Presence_OnPresenceChangedCallback NotificationHandler);
+    typedef void(EOS_CALL* EOS_Presence_RemoveNotifyOnPresenceChanged_t)(EOS_HPresence Handle, EOS_NotificationId NotificationId);
+    typedef EOS_NotificationId(EOS_CALL* EOS_RTC_AddNotifyParticipantStatusChanged_t)(EOS_HRTC Handle, const EOS_RTC_AddNotifyParticipantStatusChangedOptions* Options, void* ClientData, const EOS_RTC_OnParticipantStatusChangedCallback CompletionDelegate);
+    typedef void(EOS_CALL* EOS_RTC_RemoveNotifyParticipantStatusChanged_t)(EOS_HRTC Handle, EOS_NotificationId NotificationId);
+
     extern EOS_Initialize_t EOS_Initialize_ptr;
     extern EOS_Shutdown_t EOS_Shutdown_ptr;
     extern EOS_Platform_Create_t EOS_Platform_Create_ptr;
+    extern EOS_Platform_Tick_t EOS_Platform_Tick_ptr;
+    extern EOS_Platform_Release_t EOS_Platform_Release_ptr;
     extern EOS_Logging_SetCallback_t EOS_Logging_SetCallback_ptr;
     extern EOS_Logging_SetLogLevel_t EOS_Logging_SetLogLevel_ptr;
     extern EOS_IntegratedPlatformOptionsContainer_Add_t EOS_IntegratedPlatformOptionsContainer_Add_ptr;
     extern EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_t EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_ptr;
     extern EOS_IntegratedPlatformOptionsContainer_Release_t EOS_IntegratedPlatformOptionsContainer_Release_ptr;
 
+    extern EOS_Platform_GetP2PInterface_t EOS_Platform_GetP2PInterface_ptr;
+    extern EOS_Platform_GetLobbyInterface_t EOS_Platform_GetLobbyInterface_ptr;
+    extern EOS_Platform_GetPresenceInterface_t EOS_Platform_GetPresenceInterface_ptr;
+    extern EOS_Platform_GetRTCInterface_t EOS_Platform_GetRTCInterface_ptr;
+    extern EOS_P2P_AddNotifyPeerConnectionRequest_t EOS_P2P_AddNotifyPeerConnectionRequest_ptr;
+    extern EOS_P2P_RemoveNotifyPeerConnectionRequest_t EOS_P2P_RemoveNotifyPeerConnectionRequest_ptr;
+    extern EOS_P2P_ReceivePacket_t EOS_P2P_ReceivePacket_ptr;
+    extern EOS_Lobby_AddNotifyLobbyUpdateReceived_t EOS_Lobby_AddNotifyLobbyUpdateReceived_ptr;
+    extern EOS_Lobby_RemoveNotifyLobbyUpdateReceived_t EOS_Lobby_RemoveNotifyLobbyUpdateReceived_ptr;
+    extern EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_t EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_ptr;
+    extern EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_t EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_ptr;
+    extern EOS_Lobby_AddNotifyLobbyMemberStatusReceived_t EOS_Lobby_AddNotifyLobbyMemberStatusReceived_ptr;
+    extern EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_t EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_ptr;
+    extern EOS_Presence_AddNotifyOnPresenceChanged_t EOS_Presence_AddNotifyOnPresenceChanged_ptr;
+    extern EOS_Presence_RemoveNotifyOnPresenceChanged_t EOS_Presence_RemoveNotifyOnPresenceChanged_ptr;
+    extern EOS_RTC_AddNotifyParticipantStatusChanged_t EOS_RTC_AddNotifyParticipantStatusChanged_ptr;
+    extern EOS_RTC_RemoveNotifyParticipantStatusChanged_t EOS_RTC_RemoveNotifyParticipantStatusChanged_ptr;
+
     extern void* s_eos_sdk_lib_handle;
     extern void* s_eos_sdk_overlay_lib_handle;
 
-    extern EOS_HPlatform eos_platform_handle;
-
     /**
      * @brief Loads a dynamic library from the specified file path.
      *
      * Attempts to load the library at the specified path and returns a handle to it.
-     * On Windows, it uses `LoadLibrary` to perform the loading.
+     * On Windows, it uses `LoadLibrary` to perform the loading, on Linux `dlopen`.
      *
      * @param library_path The file path to the library to load.
      * @return A handle to the loaded library, or `nullptr` if loading fails.
@@ -73,7 +111,7 @@ namespace pew::eos::eos_library_helpers
      * @brief Retrieves a function pointer by name from a loaded library.
      *
      * Uses the provided library handle to obtain the address of a specified function.
-     * On Windows, it uses `GetProcAddress` to retrieve the function pointer.
+     * On Windows, it uses `GetProcAddress` to retrieve the function pointer, on Linux `dlsym`.
      *
      * @param library_handle A handle to the loaded library.
      * @param function The name of the function to retrieve.
@@ -117,13 +155,15 @@ namespace pew::eos::eos_library_helpers
      * @param OutData The output parameter to store the retrieved data.
      * @return `true` if the value was successfully retrieved, `false` otherwise.
      */
+#ifdef _WIN32
     bool QueryRegKey(const HKEY InKey, const TCHAR* InSubKey, const TCHAR* InValueName, std::wstring& OutData);
+#endif
 
     /**
      * @brief Unloads a previously loaded dynamic library.
      *
      * Frees the handle to a loaded library, releasing associated resources.
-     * On Windows, it uses `FreeLibrary` to unload the library.
+     * On Windows, it uses `FreeLibrary` to unload the library, on Linux `dlclose`.
      *
      * @param library_handle The handle to the library to unload.
      */
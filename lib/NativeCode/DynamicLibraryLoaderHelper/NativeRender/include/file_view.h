@@ -0,0 +1,101 @@
+#ifndef FILE_VIEW_H
+#define FILE_VIEW_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace pew::eos::io_helpers
+{
+    /**
+     * @brief Read-only view of the entire contents of a file, backed by a
+     * memory mapping of the file.
+     *
+     * Mapping the file avoids copying its contents into a separate buffer;
+     * pages are read from disk (or the file cache) as they are touched. The
+     * contents are not null-terminated.
+     */
+    class FileView
+    {
+    public:
+        FileView() = default;
+        ~FileView();
+
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+
+        FileView(FileView&& other) noexcept;
+        FileView& operator=(FileView&& other) noexcept;
+
+        /**
+         * @brief Maps the file at the given path. Any file that is already
+         * mapped by this view is released first.
+         *
+         * @param path The path of the file to map.
+         * @return `true` if the file was opened (an empty file is a valid,
+         * empty view), `false` otherwise.
+         */
+        bool open(const std::filesystem::path& path);
+
+        /**
+         * @brief Releases the mapping.
+         */
+        void close();
+
+        /**
+         * @brief Determines whether a file is currently open.
+         */
+        bool is_open() const { return _is_open; }
+
+        /**
+         * @brief Gets a pointer to the first byte of the file, or `nullptr` if
+         * the file is empty or not open.
+         */
+        const char* data() const { return _data; }
+
+        /**
+         * @brief Gets the size of the file in bytes.
+         */
+        size_t size() const { return _size; }
+
+        /**
+         * @brief Gets the contents of the file as a string view.
+         */
+        std::string_view contents() const { return { _data, _size }; }
+
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+        bool _is_open = false;
+
+        // Native mapping handle. Stored as a plain pointer so that the layout
+        // of this class does not depend on whether platform headers were
+        // included before this one.
+        void* _mapping = nullptr;
+    };
+}
+#endif
@@ -0,0 +1,199 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+#include "PEW_EOS_Defines.h"
+#include "logging.h"
+
+ /**
+  * @file flight_recorder.h
+  * @brief Crash-surviving ring buffer of the most recent log records.
+  *
+  * The flight recorder keeps the last N native and EOS SDK log records in a
+  * memory-mapped file. Because the records live in a shared file mapping, the
+  * operating system writes them back to disk even if the process is killed
+  * without a chance to run any code (SIGKILL, TerminateProcess). Fatal signals
+  * and unhandled exceptions additionally flush the mapping synchronously before
+  * the process goes down. The handlers that were installed before are then
+  * called with the original signal information and context, so that a runtime
+  * or crash reporter that handles the signal keeps working.
+  *
+  * The file layout is a FlightRecorderHeader followed by `record_count`
+  * FlightRecord slots. Writers claim a slot by incrementing
+  * `next_sequence` and publish it with a seqlock-style `state` field, so
+  * recording a message never takes a lock and never performs I/O.
+  */
+
+namespace pew::eos::flight_recorder
+{
+    /**
+     * @brief Identifies a flight recorder file.
+     */
+    constexpr char FILE_MAGIC[8] = { 'P', 'E', 'W', 'F', 'L', 'T', 'R', '\0' };
+
+    /**
+     * @brief Version of the file layout. Increment when the layout of
+     * FlightRecorderHeader or FlightRecord changes.
+     */
+    constexpr uint32_t FILE_VERSION = 1;
+
+    /**
+     * @brief Default number of records kept by the flight recorder.
+     */
+    constexpr uint32_t DEFAULT_RECORD_COUNT = 4096;
+
+    /**
+     * @brief Header at the start of a flight recorder file.
+     */
+    struct FlightRecorderHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t record_count;
+        uint32_t reserved;
+
+        /**
+         * @brief Sequence number that will be given to the next record. The
+         * slot used by a record is its sequence number modulo record_count.
+         */
+        std::atomic<uint64_t> next_sequence;
+    };
+
+    /**
+     * @brief A single fixed-size log record.
+     */
+    struct FlightRecord
+    {
+        static constexpr size_t CATEGORY_CAPACITY = 32;
+        static constexpr size_t MESSAGE_CAPACITY = 456;
+
+        /**
+         * @brief Publication state of the record. Zero means the slot has
+         * never been written, an odd value means the record with sequence
+         * (state - 1) / 2 is being written, and an even value means the record
+         * with sequence (state - 2) / 2 is complete.
+         */
+        std::atomic<uint64_t> state;
+
+        /**
+         * @brief Milliseconds since the Unix epoch when the record was written.
+         */
+        int64_t timestamp_ms;
+
+        /**
+         * @brief The EOS_ELogLevel of the record.
+         */
+        int32_t level;
+
+        uint16_t category_length;
+        uint16_t message_length;
+
+        char category[CATEGORY_CAPACITY];
+        char message[MESSAGE_CAPACITY];
+    };
+
+    static_assert(sizeof(FlightRecord) == 512, "FlightRecord is expected to be exactly 512 bytes.");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Flight recorder requires lock-free 64-bit atomics.");
+
+    /**
+     * @brief A completed record, as returned when reading a flight recorder
+     * file back.
+     */
+    struct FlightRecordEntry
+    {
+        uint64_t sequence;
+        int64_t timestamp_ms;
+        EOS_ELogLevel level;
+        std::string category;
+        std::string message;
+    };
+
+    /**
+     * @brief Opens (creating if needed) the flight recorder file, and installs
+     * the handlers that flush it when the process crashes. If a flight
+     * recorder file from a previous run exists, it is preserved with a
+     * ".prev" suffix before being replaced.
+     *
+     * @param path The path of the flight recorder file.
+     * @param record_count The number of records the ring holds.
+     * @return `true` if the flight recorder is recording, `false` otherwise.
+     */
+    bool open(const std::filesystem::path& path, uint32_t record_count = DEFAULT_RECORD_COUNT);
+
+    /**
+     * @brief Appends a record to the ring, overwriting the oldest record once
+     * the ring is full. Does nothing if the flight recorder is not open. Safe
+     * to call from any thread.
+     *
+     * @param level The log level of the record.
+     * @param category The category of the record (e.g. "NativePlugin" or the
+     * EOS SDK log category).
+     * @param message The message. Messages longer than
+     * FlightRecord::MESSAGE_CAPACITY are truncated.
+     */
+    void record(EOS_ELogLevel level, const char* category, const char* message);
+
+    /**
+     * @brief Synchronously writes the recorded messages to disk.
+     */
+    void flush();
+
+    /**
+     * @brief Flushes and closes the flight recorder, and removes the crash
+     * handlers. Must not be called while other threads may still be logging.
+     */
+    void close();
+
+    /**
+     * @brief Reads a flight recorder file (for instance one left behind by a
+     * crashed process) and calls the given function for every complete record,
+     * oldest first.
+     *
+     * @param path The path of the flight recorder file.
+     * @param on_record Function called for each record.
+     * @return `true` if the file was a valid flight recorder file, `false`
+     * otherwise.
+     */
+    bool for_each_record(const std::filesystem::path& path, const std::function<void(const FlightRecordEntry&)>& on_record);
+
+    /**
+     * @brief Reads a flight recorder file and passes each record, formatted
+     * the same way as the log file, to the given function.
+     *
+     * @param path The path of the flight recorder file.
+     * @param log_flush_function The function to call for each formatted
+     * record.
+     * @return `true` if the file was a valid flight recorder file, `false`
+     * otherwise.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_FlightRecorder_Dump(const char* path, logging::log_flush_function_t log_flush_function);
+}
+#endif
@@ -23,9 +23,14 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
 #include <tchar.h>
 #include <wchar.h>
 #include <wtypes.h>
+#endif
 
  /**
   * @file io_helpers.h
@@ -37,6 +42,7 @@
 
 namespace pew::eos::io_helpers
 {
+#ifdef _WIN32
     /**
      * @brief Retrieves the file path of a specified module as a dynamically allocated string.
      *
@@ -51,6 +57,7 @@ namespace pew::eos::io_helpers
      * @warning If the `module` handle is invalid, the function may fail or produce undefined behavior.
      */
     TCHAR* get_path_to_module(HMODULE module);
+#endif
 
     /**
      * @brief Retrieves a path relative to the current module.
@@ -61,7 +68,9 @@ namespace pew::eos::io_helpers
      * @param relative_path The relative path to resolve.
      * @return The resolved absolute path.
      *
-     * @note If the module handle cannot be obtained, the function returns an empty path.
+     * @note If the module cannot be determined, the function returns an empty path.
+     * On Linux the module is found with `dladdr`, falling back to the
+     * executable (`/proc/self/exe`) when the plugin is linked in statically.
      */
     std::filesystem::path get_path_relative_to_current_module(const std::filesystem::path& relative_path);
 
@@ -75,6 +84,32 @@ namespace pew::eos::io_helpers
      */
     std::string get_basename(const std::string& path);
 
+    /**
+     * @brief Identifies a particular version of a file, so that a cached
+     * copy of it can be told apart from the current file without reading it.
+     */
+    struct FileStamp
+    {
+        bool exists = false;
+        std::filesystem::file_time_type last_write_time;
+        std::uintmax_t size = 0;
+
+        bool operator==(const FileStamp& other) const
+        {
+            return exists == other.exists && last_write_time == other.last_write_time && size == other.size;
+        }
+    };
+
+    /**
+     * @brief Gets the stamp of the file at the given path.
+     *
+     * @param file_path The path of the file.
+     * @return The stamp of the file, whose exists field is false if the file
+     * does not exist.
+     */
+    FileStamp get_file_stamp(const std::filesystem::path& file_path);
+
+#ifdef _WIN32
     /**
      * @brief Retrieves the full path to a module as a wide string.
      *
@@ -86,6 +121,15 @@ namespace pew::eos::io_helpers
      * @note The caller must free the returned string if dynamically allocated.
      */
     std::wstring get_path_to_module_as_string(HMODULE module);
+#endif
+
+    /**
+     * @brief Retrieves the command line of the current process, split into
+     * whitespace-separated arguments.
+     *
+     * @return The command-line arguments, including the executable itself.
+     */
+    std::vector<std::string> get_command_line_arguments();
 
     /**
      * \brief Gets the value of a command line argument specified by one or more possible flags.
@@ -101,36 +145,29 @@ namespace pew::eos::io_helpers
         // This gathers the variadic parameters which represent parameter flags, any
         // of which indicate the same value that is being passed in on the command
         // line.
-        const std::vector<std::string> flag_options = { args... };
+        const std::string_view flag_options[] = { std::string_view(args)... };
 
-        for (const auto& argument : arguments)
+        for (const std::string_view argument : arguments)
         {
-            const std::string* match = nullptr;
-
-            // See if the argument matches any of the flag options provided.
-            for (const std::string& flag : flag_options)
+            // An argument that carries a value looks like "-flag=value", so
+            // the flag is whatever comes between the dash and the first "=".
+            const size_t equals_index = argument.find('=');
+            if (argument.empty() || argument.front() != '-' || equals_index == std::string_view::npos)
             {
-                // If the argument doesn't start with the flag, move to the next.
-                if (!argument._Starts_with("-" + flag + "="))
-                {
-                    continue;
-                }
-
-                // Indicate the match and exit the loop.
-                match = &flag;
-                break;
+                continue;
             }
 
-            // If there was a match
-            if (match != nullptr)
+            const std::string_view flag = argument.substr(1, equals_index - 1);
+            const std::string_view arg_value = argument.substr(equals_index + 1);
+            if (arg_value.empty())
             {
-                // extract the value.
-                // The argument should have started with "-" and continued with "=",
-                // so it needs to be substringed the length of the match plus these two characters
-                std::string arg_value;
-                arg_value = argument.substr(match->length() + 2);
+                continue;
+            }
 
-                if (!arg_value.empty())
+            // See if the argument matches any of the flag options provided.
+            for (const std::string_view flag_option : flag_options)
+            {
+                if (flag == flag_option)
                 {
                     value = arg_value;
                     return true;
@@ -23,11 +23,12 @@
  */
 
 #pragma once
-#include <filesystem>
-#include <map>
+#include <string_view>
 #include <vector>
 
 #include "json.h"
+#include "json_number.h"
+#include "static_string_map.h"
 #include "string_helpers.h"
 
 namespace pew::eos::json_helpers
@@ -51,14 +52,25 @@ namespace pew::eos::json_helpers
      *
      * \return A single flag value.
      */
-    template<typename T>
-    static T collect_flags(const std::map<std::string, T>* strings_to_enum_values, T default_value, json_object_element_s* iter)
+    template<typename T, size_t N>
+    static T collect_flags(const StaticStringMap<T, N>* strings_to_enum_values, T default_value, json_object_element_s* iter)
     {
         T flags_to_return = static_cast<T>(0);
         bool flag_set = false;
 
-        // Stores the string values that are within the JSON
-        std::vector<std::string> string_values;
+        const auto collect_flag = [&](std::string_view str)
+        {
+            // Skip if the string is not in the map
+            const T* enum_value = strings_to_enum_values->find(str);
+            if (enum_value == nullptr)
+            {
+                return;
+            }
+
+            // Otherwise, append the enum value
+            flags_to_return |= *enum_value;
+            flag_set = true;
+        };
 
         // If the string values are stored as a JSON array of strings
         if (iter->value->type == json_type_array)
@@ -67,38 +79,58 @@ namespace pew::eos::json_helpers
             json_array_s* flags = json_value_as_array(iter->value);
             for (auto e = flags->start; e != nullptr; e = e->next)
             {
-                string_values.emplace_back(json_value_as_string(e->value)->string);
+                const json_string_s* flag = json_value_as_string(e->value);
+                if (flag != nullptr)
+                {
+                    collect_flag(std::string_view(flag->string, flag->string_size));
+                }
             }
         }
         // If the string values are comma delimited
         else if (iter->value->type == json_type_string)
         {
-            const std::string flags = json_value_as_string(iter->value)->string;
-            string_values = string_helpers::split_and_trim(flags);
+            const json_string_s* flags = json_value_as_string(iter->value);
+            string_helpers::for_each_token(std::string_view(flags->string, flags->string_size), ',', collect_flag);
         }
 
-        // Iterate through the string values
-        for (const auto str : string_values)
-        {
-            // Skip if the string is not in the map
-            if (strings_to_enum_values->find(str.c_str()) == strings_to_enum_values->end())
-            {
-                continue;
-            }
+        return flag_set ? flags_to_return : default_value;
+    }
 
-            // Otherwise, append the enum value
-            flags_to_return |= strings_to_enum_values->at(str.c_str());
-            flag_set = true;
+    /**
+     * @brief Parses a JSON value as a number of the given type, with a specified default.
+     *
+     * Numbers are read straight from the number text of the DOM. A string value is parsed as a number
+     * as well (ignoring surrounding whitespace), since some configs store numbers as strings. Parsing
+     * is done with parse_number, so it is locale-independent and checks that the number fits in T.
+     *
+     * @tparam T The type to parse the number into.
+     * @param value The JSON value to interpret.
+     * @param default_value The value to return if the value is not a number that fits in T.
+     * @return The parsed value, or `default_value` if parsing fails.
+     */
+    template <typename T>
+    T json_value_to_number(json_value_s* value, T default_value = 0)
+    {
+        std::string_view text;
+        if (const json_number_s* number = json_value_as_number(value))
+        {
+            text = std::string_view(number->number, number->number_size);
+        }
+        else if (const json_string_s* string = json_value_as_string(value))
+        {
+            text = string_helpers::trim_view(std::string_view(string->string, string->string_size));
         }
 
-        return flag_set ? flags_to_return : default_value;
+        T parsed;
+        return (!text.empty() && parse_number(text, parsed)) ? parsed : default_value;
     }
 
     /**
      * @brief Parses a JSON value as a `double`, with a specified default.
      *
      * Attempts to interpret the provided JSON value as a `double`. If the value cannot be parsed as a number,
-     * it is treated as a string and parsed. If both attempts fail, the function returns the specified default.
+     * it is treated as a string and parsed (see json_value_to_number). If both attempts fail, the function
+     * returns the specified default.
      *
      * @param value The JSON value to interpret.
      * @param default_value The value to return if parsing fails.
@@ -110,7 +142,8 @@ namespace pew::eos::json_helpers
      * @brief Parses a JSON value as an unsigned 64-bit integer (`uint64_t`), with a specified default.
      *
      * Attempts to interpret the provided JSON value as a `uint64_t`. If the value cannot be parsed as a number,
-     * it is treated as a string and parsed. If both attempts fail, the function returns the specified default.
+     * it is treated as a string and parsed (see json_value_to_number). If both attempts fail, the function
+     * returns the specified default.
      *
      * @param value The JSON value to interpret.
      * @param default_value The value to return if parsing fails.
@@ -122,28 +155,13 @@ namespace pew::eos::json_helpers
      * @brief Parses a JSON value as an unsigned 32-bit integer (`uint32_t`), with a specified default.
      *
      * Attempts to interpret the provided JSON value as a `uint32_t`. If the value cannot be parsed as a number,
-     * it is treated as a string and parsed. If both attempts fail, the function returns the specified default.
+     * it is treated as a string and parsed (see json_value_to_number). If both attempts fail, the function
+     * returns the specified default.
      *
      * @param value The JSON value to interpret.
      * @param default_value The value to return if parsing fails.
      * @return The parsed `uint32_t` value, or `default_value` if parsing fails.
      */
     uint32_t json_value_as_uint32(json_value_s* value, uint32_t default_value = 0);
-
-    /**
-     * @brief Reads a JSON configuration file from a specified path and parses it.
-     *
-     * Opens and reads the specified configuration file, loads its contents into a buffer,
-     * parses the buffer as JSON, and returns the parsed JSON object. If the file is too large or
-     * cannot be opened, an exception is thrown.
-     *
-     * @param path_to_config_json The path to the JSON configuration file.
-     * @return A pointer to a `json_value_s` representing the parsed JSON structure, or `nullptr` on failure.
-     *
-     * @throws std::filesystem::filesystem_error If the file is too large to be processed.
-     *
-     * @note The caller is responsible for handling and freeing the parsed JSON structure as needed.
-     */
-    json_value_s* read_config_json_as_json_from_path(const std::filesystem::path& path_to_config_json);
 }
 #endif
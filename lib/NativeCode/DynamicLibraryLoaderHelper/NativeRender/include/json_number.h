@@ -0,0 +1,97 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace pew::eos::json_helpers
+{
+    /**
+     * @brief Parses the text of a JSON number into an arithmetic type.
+     *
+     * The text is converted with std::from_chars, so the result does not
+     * depend on the current locale, and the text does not need to be
+     * null-terminated (a json_number_s can be passed as its number and
+     * number_size without copying it).
+     *
+     * Integral types also accept a number with a fraction or an exponent
+     * ("1.5", "1e3"), which is truncated towards zero.
+     *
+     * @tparam T The type to parse the number into.
+     * @param text The number. Nothing may precede or follow it.
+     * @param value Receives the number. Left unchanged on failure.
+     * @return `true` if the text is a number that fits in T, `false` if it
+     * is not a number or is out of range.
+     */
+    template <typename T>
+    bool parse_number(std::string_view text, T& value)
+    {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "parse_number only parses into numeric types.");
+
+        const char* const first = text.data();
+        const char* const last = first + text.size();
+
+        T parsed = 0;
+        const auto [end, error] = std::from_chars(first, last, parsed);
+
+        if constexpr (std::is_integral_v<T>)
+        {
+            if (error == std::errc() && end != last && (*end == '.' || *end == 'e' || *end == 'E'))
+            {
+                double real = 0.0;
+                const auto [real_end, real_error] = std::from_chars(first, last, real);
+                if (real_error != std::errc() || real_end != last)
+                {
+                    return false;
+                }
+
+                // The bounds are powers of two, so they are exact as
+                // doubles (unlike the maximum of a 64-bit type).
+                const double lower = static_cast<double>(std::numeric_limits<T>::min());
+                const double upper = (static_cast<double>(std::numeric_limits<T>::max() / 2) + 1.0) * 2.0;
+                if (!(real > lower - 1.0 && real < upper))
+                {
+                    return false;
+                }
+
+                value = static_cast<T>(real);
+                return true;
+            }
+        }
+
+        if (error != std::errc() || end != last)
+        {
+            return false;
+        }
+
+        value = parsed;
+        return true;
+    }
+}
+#endif
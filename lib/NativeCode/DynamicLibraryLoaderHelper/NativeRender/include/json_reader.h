@@ -0,0 +1,262 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "json_number.h"
+
+namespace pew::eos::json_helpers
+{
+    /**
+     * @brief The kind of value that a JsonReader is positioned at.
+     */
+    enum class JsonValueType
+    {
+        Object,
+        Array,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+
+        /**
+         * @brief There is no value at the current position, either because
+         * the input is malformed or because the reader has already failed.
+         */
+        Invalid
+    };
+
+    /**
+     * @brief Reads JSON one value at a time, straight from the text.
+     *
+     * Unlike json_parse, the reader does not build a tree of the document.
+     * The caller walks the document with begin_object / next_member and
+     * begin_array / next_element, and reads each value into its destination
+     * as it is reached, skipping values that it has no use for. Numbers are
+     * converted in place with std::from_chars, and strings are only copied
+     * when they are read into a destination. Member names that contain no
+     * escape sequences are returned as views of the input.
+     *
+     * Any syntax error puts the reader into a failed state, after which
+     * every function reports that there is nothing more to read. The input
+     * must outlive the reader.
+     *
+     * @code
+     * JsonReader reader(text);
+     * std::string_view name;
+     * if (reader.begin_object())
+     * {
+     *     while (reader.next_member(name))
+     *     {
+     *         if (name == "ProductName") { reader.read_string(product_name); }
+     *         else { reader.skip_value(); }
+     *     }
+     * }
+     * @endcode
+     */
+    class JsonReader
+    {
+    public:
+        /**
+         * @brief Objects and arrays nested deeper than this are treated as
+         * a syntax error, so that malicious input cannot exhaust the stack
+         * of a recursive caller.
+         */
+        static constexpr size_t MAX_DEPTH = 64;
+
+        explicit JsonReader(std::string_view json);
+
+        /**
+         * @brief Gets the type of the value at the current position, without
+         * consuming it.
+         */
+        JsonValueType peek();
+
+        /**
+         * @brief Enters the object at the current position.
+         *
+         * @return `true` if the value was an object, `false` (without
+         * consuming anything) otherwise.
+         */
+        bool begin_object();
+
+        /**
+         * @brief Moves to the next member of the object that was most
+         * recently entered, and consumes its name. The value of the member
+         * must be read or skipped before calling this function again.
+         *
+         * @param name Receives the name of the member. The view is only
+         * valid until the next call to the reader.
+         * @return `true` if there is another member, `false` if the end of
+         * the object has been consumed or the reader failed.
+         */
+        bool next_member(std::string_view& name);
+
+        /**
+         * @brief Enters the array at the current position.
+         *
+         * @return `true` if the value was an array, `false` (without
+         * consuming anything) otherwise.
+         */
+        bool begin_array();
+
+        /**
+         * @brief Moves to the next element of the array that was most
+         * recently entered. The element must be read or skipped before
+         * calling this function again.
+         *
+         * @return `true` if there is another element, `false` if the end of
+         * the array has been consumed or the reader failed.
+         */
+        bool next_element();
+
+        /**
+         * @brief Reads the string at the current position, resolving any
+         * escape sequences.
+         *
+         * @return `true` if the value was a string, `false` (without
+         * consuming anything unless the string was malformed) otherwise.
+         */
+        bool read_string(std::string& value);
+
+        /**
+         * @brief Reads the string at the current position like read_string,
+         * but without copying it when it contains no escape sequences. The
+         * view is valid until the next string is read this way, or until
+         * the JSON it was read from is destroyed.
+         *
+         * @return `true` if the value was a string, `false` (without
+         * consuming anything unless the string was malformed) otherwise.
+         */
+        bool read_string_view(std::string_view& value);
+
+        /**
+         * @brief Reads the number at the current position into the given
+         * arithmetic type, with parse_number. Numbers that are out of range
+         * for the type are read as zero.
+         *
+         * @return `true` if the value was a number, `false` (without
+         * consuming anything) otherwise.
+         */
+        template <typename T>
+        bool read_number(T& value)
+        {
+            std::string_view token;
+            if (!scan_number(token))
+            {
+                return false;
+            }
+
+            if (!parse_number(token, value))
+            {
+                value = 0;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Reads `true` or `false` at the current position.
+         *
+         * @return `true` if the value was a boolean, `false` (without
+         * consuming anything) otherwise.
+         */
+        bool read_bool(bool& value);
+
+        /**
+         * @brief Consumes the value at the current position, including
+         * everything nested inside of it.
+         *
+         * Objects and arrays are skipped by finding their closing bracket
+         * with find_container_end, so their contents are not validated
+         * beyond their brackets balancing and their strings being closed.
+         */
+        void skip_value();
+
+        /**
+         * @brief Checks that nothing but whitespace follows the value that
+         * was read.
+         *
+         * @return `true` if the whole input was valid JSON, `false`
+         * otherwise.
+         */
+        bool finish();
+
+        /**
+         * @brief Determines whether the reader has encountered a syntax
+         * error.
+         */
+        bool failed() const { return _failed; }
+
+        /**
+         * @brief Gets the offset into the input that the reader is at, which
+         * is where the error is if the reader failed.
+         */
+        size_t offset() const { return _position; }
+
+    private:
+        void skip_whitespace();
+        bool fail();
+        bool consume(char expected);
+
+        /**
+         * @brief Consumes a string. Strings without escape sequences are
+         * returned as a view of the input; others are decoded into the
+         * buffer, which the returned view then refers to.
+         */
+        bool scan_string(std::string& buffer, std::string_view& contents);
+
+        bool scan_number(std::string_view& token);
+        bool scan_literal(std::string_view literal);
+
+        std::string_view _json;
+        size_t _position = 0;
+        size_t _depth = 0;
+
+        /**
+         * @brief Set when an object or array has just been entered, because
+         * its first member or element is not preceded by a comma.
+         */
+        bool _at_container_start = false;
+        bool _failed = false;
+
+        /**
+         * @brief Holds the last member name that contained escape sequences.
+         */
+        std::string _name_buffer;
+
+        /**
+         * @brief Holds the last string read by read_string_view that
+         * contained escape sequences.
+         */
+        std::string _value_buffer;
+    };
+}
+#endif
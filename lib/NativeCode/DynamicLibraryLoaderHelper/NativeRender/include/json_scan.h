@@ -0,0 +1,69 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @file json_scan.h
+ * @brief Vectorized scanning of JSON text, used by JsonReader for the parts
+ * of a document that it does not need to look at byte by byte.
+ *
+ * The input is classified 64 bytes at a time, in the style of the first
+ * stage of simdjson: each block yields bit masks of the quotes, backslashes
+ * and brackets that it contains, from which escaped characters and the
+ * extent of strings are derived with a handful of integer operations. On
+ * x86 the classification uses AVX2 when the processor supports it and SSE2
+ * otherwise; on 64-bit ARM it uses NEON. Every other target, or any build
+ * that defines PEW_EOS_JSON_SCAN_SCALAR, uses a scalar implementation that
+ * produces the same masks.
+ */
+
+namespace pew::eos::json_helpers
+{
+    /**
+     * @brief Finds the first quote, backslash or control character in the
+     * given range, which is where a string either ends or stops being a
+     * plain copy of the input.
+     *
+     * @return The offset of that character, or `size` if there is none.
+     */
+    size_t find_string_special(const char* data, size_t size);
+
+    /**
+     * @brief Finds the end of the object or array whose opening bracket is
+     * at the given offset, without parsing what is inside of it. Strings
+     * (including escaped quotes) are accounted for, but nothing else is
+     * validated: brackets only have to balance, regardless of their kind.
+     *
+     * @param json The text to scan.
+     * @param start The offset of the opening bracket.
+     * @return The offset just past the closing bracket, or
+     * `std::string_view::npos` if the container is not closed.
+     */
+    size_t find_container_end(std::string_view json, size_t start);
+}
+#endif
@@ -0,0 +1,157 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace pew::eos::logging
+{
+    /**
+     * @brief Ring buffer of UTF-8 log lines that a single consumer drains in
+     * batches, directly from the ring's memory.
+     *
+     * Each record is laid out as a 32-bit little-endian byte length, followed
+     * by that many bytes of UTF-8 text, a null terminator, and padding up to
+     * the next multiple of four bytes. Records never wrap around the end of
+     * the buffer: a record that does not fit in the space left before the end
+     * starts again at the beginning, so every batch handed to the consumer is
+     * one contiguous run of complete records.
+     *
+     * Records are never overwritten before they are consumed. When the ring is
+     * full, new records are dropped (and counted) instead, which is what makes
+     * it safe for the consumer to read a batch without holding any lock.
+     */
+    class LogRing
+    {
+    public:
+        /**
+         * @brief Default capacity of the ring (256 KiB).
+         */
+        static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+        /**
+         * @brief Size of the length prefix of every record.
+         */
+        static constexpr size_t RECORD_HEADER_SIZE = sizeof(uint32_t);
+
+        explicit LogRing(size_t capacity = DEFAULT_CAPACITY);
+
+        LogRing(const LogRing&) = delete;
+        LogRing& operator=(const LogRing&) = delete;
+
+        /**
+         * @brief Appends a line to the ring. Lines longer than a quarter of the
+         * capacity are truncated. Safe to call from any thread.
+         *
+         * @param text The text of the line. Does not need to be
+         * null-terminated.
+         * @param length The number of bytes of text.
+         * @return `true` if the line was added, `false` if it was dropped
+         * because the ring is full.
+         */
+        bool push(const char* text, size_t length);
+
+        /**
+         * @brief Gets the oldest contiguous run of records that have not been
+         * consumed yet. The memory stays valid, and is not modified, until it
+         * is released by consume().
+         *
+         * @param data Receives a pointer to the first record, or `nullptr` if
+         * the ring is empty.
+         * @param length Receives the number of bytes of records available.
+         */
+        void peek(const char** data, size_t* length);
+
+        /**
+         * @brief Releases bytes previously returned by peek(), making the space
+         * available to new records. Must be a whole number of records.
+         *
+         * @param length The number of bytes to release.
+         */
+        void consume(size_t length);
+
+        /**
+         * @brief Calls the given function for each record that has not been
+         * consumed, without consuming it.
+         *
+         * @param on_line Function called with the null-terminated text and
+         * length of each line.
+         * @param from_position Records that start before this position, as
+         * returned by get_head_position, are skipped.
+         * @return The position after the last record.
+         */
+        uint64_t for_each(const std::function<void(const char*, size_t)>& on_line, uint64_t from_position = 0);
+
+        /**
+         * @brief Gets the position after the newest record. Positions only
+         * grow, so records pushed later start at or after it.
+         */
+        uint64_t get_head_position();
+
+        /**
+         * @brief Discards every record that has not been consumed.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the number of records that were dropped because the ring
+         * was full.
+         */
+        uint64_t get_dropped_count();
+
+        /**
+         * @brief Gets the size, in bytes, that a line of the given length
+         * occupies in the ring.
+         */
+        static constexpr size_t get_record_size(size_t length)
+        {
+            return (RECORD_HEADER_SIZE + length + 1 + 3) & ~static_cast<size_t>(3);
+        }
+
+    private:
+        void skip_wrap();
+
+        std::mutex _mutex;
+        std::vector<char> _buffer;
+
+        // Positions are monotonic byte counters; the offset into the buffer is
+        // the position modulo the capacity.
+        uint64_t _head = 0;
+        uint64_t _tail = 0;
+
+        // Position at which the producer skipped the unused space at the end
+        // of the buffer, or UINT64_MAX if there is no such gap between the
+        // tail and the head. There can be at most one, since the head never
+        // gets more than a full lap ahead of the tail.
+        uint64_t _wrap_at = UINT64_MAX;
+
+        uint64_t _dropped = 0;
+    };
+}
+#endif
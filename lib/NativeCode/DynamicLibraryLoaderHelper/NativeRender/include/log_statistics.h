@@ -0,0 +1,116 @@
+#ifndef LOG_STATISTICS_H
+#define LOG_STATISTICS_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <eos_logging.h>
+
+#include "PEW_EOS_Defines.h"
+
+namespace pew::eos::logging
+{
+    /**
+     * @brief The number of log levels that statistics are kept for. Counters
+     * are indexed by the EOS_ELogLevel value divided by 100, so index 0 is
+     * EOS_LOG_Off and index 6 is EOS_LOG_VeryVerbose.
+     */
+    constexpr size_t LOG_STATISTICS_LEVEL_COUNT = 7;
+
+    /**
+     * @brief The maximum number of categories that statistics are kept for.
+     * Messages in categories beyond this limit are counted under the
+     * "Other" category.
+     */
+    constexpr size_t LOG_STATISTICS_MAX_CATEGORIES = 64;
+
+    /**
+     * @brief The size of the category name field, including the null
+     * terminator. Longer category names are truncated.
+     */
+    constexpr size_t LOG_STATISTICS_CATEGORY_CAPACITY = 48;
+
+    /**
+     * @brief Snapshot of the log statistics of a single category. This struct
+     * is blittable so that it can be read directly from managed code.
+     */
+    struct LogCategoryStatistics
+    {
+        /**
+         * @brief The null-terminated name of the category, as reported by the
+         * EOS SDK (e.g. "LogEOSAuth"), or "NativePlugin" for messages logged by
+         * this plugin.
+         */
+        char category[LOG_STATISTICS_CATEGORY_CAPACITY];
+
+        /**
+         * @brief The number of messages logged, per log level.
+         */
+        uint64_t message_count[LOG_STATISTICS_LEVEL_COUNT];
+
+        /**
+         * @brief The number of bytes of formatted log output, per log level.
+         */
+        uint64_t byte_count[LOG_STATISTICS_LEVEL_COUNT];
+
+        /**
+         * @brief The number of messages that were dropped before they could be
+         * handed to managed code, because the log buffer was full.
+         */
+        uint64_t dropped_count;
+    };
+
+    /**
+     * @brief Counts a logged message. Lock-free unless this is the first
+     * message of a category.
+     *
+     * @param category The category of the message.
+     * @param level The log level of the message.
+     * @param bytes The number of bytes of formatted log output.
+     * @param dropped Whether the message was dropped from the log buffer.
+     */
+    void record_log_statistics(const char* category, EOS_ELogLevel level, size_t bytes, bool dropped);
+
+    /**
+     * @brief Copies the current log statistics into the given array.
+     *
+     * Counters are read individually, so a snapshot that is taken while
+     * messages are being logged may be off by the messages logged during the
+     * copy.
+     *
+     * @param statistics The array to copy the statistics of each category into.
+     * May be null if capacity is zero.
+     * @param capacity The number of elements in the array.
+     * @return The number of categories that have statistics. If this is larger
+     * than capacity, only the first capacity categories were copied.
+     */
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_GetLogStatistics(LogCategoryStatistics* statistics, uint32_t capacity);
+
+    /**
+     * @brief Resets all log statistics counters to zero.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_ResetLogStatistics();
+}
+#endif
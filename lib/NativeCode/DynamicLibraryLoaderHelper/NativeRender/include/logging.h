@@ -28,6 +28,7 @@
 #include <eos_logging.h>
 
 #include "PEW_EOS_Defines.h"
+#include "mapped_log_file.h"
 
 /**
   * \brief Forward declarations
@@ -61,13 +62,39 @@ namespace pew::eos::logging
     /**
      * @brief Flushes buffered log messages using a custom flush function.
      *
-     * Iterates over any buffered log messages and passes each one to the specified flush function.
-     * After flushing, the buffer is cleared.
+     * Drains the log ring, passing each buffered log message to the specified
+     * flush function. Prefer global_log_peek_batch and
+     * global_log_consume_batch, which hand over all buffered messages at once
+     * instead of calling back once per message.
      *
      * @param log_flush_function The function to call for each log message in the buffer.
      */
     PEW_EOS_API_FUNC(void) global_log_flush_with_function(log_flush_function_t log_flush_function);
 
+    /**
+     * @brief Gets the oldest batch of buffered log messages without copying
+     * them.
+     *
+     * The batch is a contiguous run of records, each made of a 32-bit
+     * little-endian byte length, the UTF-8 text of the message, a null
+     * terminator, and padding up to the next multiple of four bytes (see
+     * LogRing). The memory stays valid until it is released with
+     * global_log_consume_batch. Call again after consuming to get the next
+     * batch; a length of zero means the buffer is empty.
+     *
+     * @param data Receives a pointer to the first record of the batch.
+     * @param length Receives the size of the batch in bytes.
+     */
+    PEW_EOS_API_FUNC(void) global_log_peek_batch(const char** data, size_t* length);
+
+    /**
+     * @brief Releases log messages previously returned by
+     * global_log_peek_batch.
+     *
+     * @param length The number of bytes to release. Must cover whole records.
+     */
+    PEW_EOS_API_FUNC(void) global_log_consume_batch(size_t length);
+
     /**
      * @brief Converts a log level string to its corresponding EOS log level enumeration.
      *
@@ -91,14 +118,16 @@ namespace pew::eos::logging
     /**
      * @brief Closes the global log file and clears the buffer.
      *
-     * Closes the currently open log file (if any) and clears any buffered log messages.
+     * Closes the currently open log file (if any) and discards any log
+     * messages that managed code has not drained yet.
      */
     void global_log_close();
 
     /**
      * @brief Writes a formatted log message to the log file or buffer.
      *
-     * Logs a formatted message to the open log file, if available, or to a buffer for deferred logging.
+     * Logs a formatted message to the open log file, if available, and to the
+     * log ring that managed code drains.
      * Supports standard `printf` formatting.
      *
      * @param format The format string for the log message.
@@ -119,12 +148,20 @@ namespace pew::eos::logging
     /**
      * @brief Opens a log file for writing.
      *
-     * Opens a specified log file and writes any buffered log messages to it. If a log
-     * file is already open, it is closed before opening the new file.
+     * Opens (or appends to) the specified log file as a memory-mapped segment
+     * and writes any buffered log messages to it. If a log file is already
+     * open, it is closed before opening the new file. Once a segment reaches
+     * `segment_size` bytes it is rotated, keeping at most `max_segments`
+     * files on disk.
      *
      * @param filename The name of the file to open for logging.
+     * @param segment_size The size, in bytes, at which the log file rotates.
+     * @param max_segments The number of log files to keep, including the
+     * active one.
      */
-    void global_log_open(const char* filename);
+    void global_log_open(const char* filename,
+        size_t segment_size = MappedLogFile::DEFAULT_SEGMENT_SIZE,
+        size_t max_segments = MappedLogFile::DEFAULT_MAX_SEGMENTS);
 
     /**
      * @brief Logs a message with a timestamp and header.
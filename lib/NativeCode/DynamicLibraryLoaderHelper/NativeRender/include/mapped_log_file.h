@@ -0,0 +1,123 @@
+#ifndef MAPPED_LOG_FILE_H
+#define MAPPED_LOG_FILE_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+
+namespace pew::eos::logging
+{
+    /**
+     * @brief Append-only log sink that writes into a memory-mapped region of
+     * the log file.
+     *
+     * The backing file is grown to a fixed segment size and mapped once, so
+     * writing a line is a copy into the mapped view rather than a system
+     * call. When a line does not fit in the remaining space of the segment,
+     * the segment is finalized (truncated to the bytes actually written) and
+     * rotated: "name.ext" becomes "name.1.ext", "name.1.ext" becomes
+     * "name.2.ext" and so on, with the oldest segment beyond the configured
+     * count being deleted. Opening an existing file appends to it, so history
+     * survives restarts.
+     */
+    class MappedLogFile
+    {
+    public:
+        /**
+         * @brief Default size of a single log segment (4 MiB).
+         */
+        static constexpr size_t DEFAULT_SEGMENT_SIZE = 4 * 1024 * 1024;
+
+        /**
+         * @brief Default number of segments (including the active one) that
+         * are kept on disk.
+         */
+        static constexpr size_t DEFAULT_MAX_SEGMENTS = 4;
+
+        MappedLogFile() = default;
+        ~MappedLogFile();
+
+        MappedLogFile(const MappedLogFile&) = delete;
+        MappedLogFile& operator=(const MappedLogFile&) = delete;
+
+        /**
+         * @brief Opens (or creates) the log file at the given path and maps
+         * the first segment. Any file that is already open is closed first.
+         *
+         * @param path The path of the active log file.
+         * @param segment_size The size, in bytes, at which segments rotate.
+         * @param max_segments The number of segments to keep on disk,
+         * including the active one. Must be at least one.
+         * @return `true` if the file was opened and mapped, `false` otherwise.
+         */
+        bool open(const std::filesystem::path& path,
+            size_t segment_size = DEFAULT_SEGMENT_SIZE,
+            size_t max_segments = DEFAULT_MAX_SEGMENTS);
+
+        /**
+         * @brief Determines whether a segment is currently mapped.
+         */
+        bool is_open() const;
+
+        /**
+         * @brief Appends a line of text followed by a newline character. Lines
+         * longer than a segment are truncated to fit.
+         *
+         * @param text The text to append. Does not need to be null-terminated.
+         * @param length The number of bytes of text to append.
+         */
+        void write_line(const char* text, size_t length);
+
+        /**
+         * @brief Unmaps the active segment, truncates the file to the number
+         * of bytes written, and closes it.
+         */
+        void close();
+
+    private:
+        bool map_segment();
+        void unmap_segment();
+        void rotate();
+        std::filesystem::path get_segment_path(size_t index) const;
+
+        std::mutex _mutex;
+        std::filesystem::path _path;
+        size_t _segment_size = DEFAULT_SEGMENT_SIZE;
+        size_t _max_segments = DEFAULT_MAX_SEGMENTS;
+
+        char* _view = nullptr;
+        size_t _view_size = 0;
+        size_t _offset = 0;
+
+        // Native file and mapping handles. These are stored as plain integers
+        // and pointers so that the layout of this class does not depend on
+        // whether platform headers were included before this one.
+        intptr_t _file = -1;
+        void* _mapping = nullptr;
+    };
+}
+#endif
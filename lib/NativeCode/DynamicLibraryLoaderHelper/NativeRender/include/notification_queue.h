@@ -0,0 +1,268 @@
+#ifndef NOTIFICATION_QUEUE_H
+#define NOTIFICATION_QUEUE_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <eos_types.h>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file notification_queue.h
+  * @brief Collects frequent EOS notifications in native memory, so that
+  * managed code can receive all of them with a single call per frame.
+  *
+  * Without the queue, every notification is a separate call from the SDK
+  * into managed code, made from inside EOS_Platform_Tick. Instead, the
+  * plugin registers native handlers for the notifications that arrive most
+  * often under heavy lobby and voice traffic. Each handler copies its
+  * payload into a record in an arena, and PEW_EOS_DrainNotifications hands
+  * the whole arena to managed code at once.
+  *
+  * Records are a fixed-layout struct that starts with a NotificationHeader,
+  * followed by the null-terminated UTF-8 contents of its strings, padded to
+  * a multiple of NOTIFICATION_RECORD_ALIGNMENT bytes. Handles (product user
+  * ids and Epic account ids) are stored as they are, and remain valid
+  * because the SDK does not release them. The layouts are mirrored by
+  * NativeNotificationQueue.cs in the managed package; change both together.
+  */
+
+namespace pew::eos::notification_queue
+{
+    /**
+     * @brief Records start at, and are padded to, a multiple of this many
+     * bytes.
+     */
+    constexpr uint32_t NOTIFICATION_RECORD_ALIGNMENT = 8;
+
+    /**
+     * @brief The most bytes of records that are held between two drains.
+     * Notifications that arrive once the queue is full are dropped (and
+     * counted).
+     */
+    constexpr uint32_t MAX_QUEUED_NOTIFICATION_BYTES = 4 * 1024 * 1024;
+
+    enum class NotificationType : uint32_t
+    {
+        PeerConnectionRequest = 1,
+        LobbyUpdate = 2,
+        LobbyMemberUpdate = 3,
+        LobbyMemberStatus = 4,
+        RTCParticipantStatus = 5,
+        PresenceChanged = 6,
+    };
+
+    /**
+     * @brief A string stored after the struct of a record.
+     */
+    struct NotificationString
+    {
+        /**
+         * @brief Offset of the first byte, from the start of the record.
+         */
+        uint32_t offset;
+
+        /**
+         * @brief Length in bytes, not counting the null terminator.
+         */
+        uint32_t length;
+    };
+
+    struct NotificationHeader
+    {
+        NotificationType type;
+
+        /**
+         * @brief Size in bytes of the whole record, strings and padding
+         * included. The next record starts this many bytes after this one.
+         */
+        uint32_t size;
+    };
+
+    /**
+     * @brief EOS_P2P_OnIncomingConnectionRequestInfo.
+     */
+    struct PeerConnectionRequestNotification
+    {
+        NotificationHeader header;
+        EOS_ProductUserId local_user_id;
+        EOS_ProductUserId remote_user_id;
+        NotificationString socket_name;
+    };
+
+    /**
+     * @brief EOS_Lobby_LobbyUpdateReceivedCallbackInfo.
+     */
+    struct LobbyUpdateNotification
+    {
+        NotificationHeader header;
+        NotificationString lobby_id;
+    };
+
+    /**
+     * @brief EOS_Lobby_LobbyMemberUpdateReceivedCallbackInfo.
+     */
+    struct LobbyMemberUpdateNotification
+    {
+        NotificationHeader header;
+        EOS_ProductUserId target_user_id;
+        NotificationString lobby_id;
+    };
+
+    /**
+     * @brief EOS_Lobby_LobbyMemberStatusReceivedCallbackInfo.
+     */
+    struct LobbyMemberStatusNotification
+    {
+        NotificationHeader header;
+        EOS_ProductUserId target_user_id;
+        NotificationString lobby_id;
+        int32_t current_status;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief EOS_RTC_ParticipantStatusChangedCallbackInfo.
+     */
+    struct RTCParticipantStatusNotification
+    {
+        NotificationHeader header;
+        EOS_ProductUserId local_user_id;
+        EOS_ProductUserId participant_id;
+        NotificationString room_name;
+        int32_t participant_status;
+        uint32_t is_in_blocklist;
+
+        /**
+         * @brief The participant metadata, as key and value pairs. Each key
+         * and each value is followed by a null terminator.
+         */
+        NotificationString metadata;
+        uint32_t metadata_count;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief EOS_Presence_PresenceChangedCallbackInfo.
+     */
+    struct PresenceChangedNotification
+    {
+        NotificationHeader header;
+        EOS_EpicAccountId local_user_id;
+        EOS_EpicAccountId presence_user_id;
+    };
+
+    /**
+     * @brief The notifications collected since the previous drain.
+     */
+    struct NotificationBatch
+    {
+        /**
+         * @brief The first record, or null if there are none.
+         */
+        const uint8_t* data;
+
+        /**
+         * @brief Size in bytes of all records.
+         */
+        uint32_t length;
+
+        /**
+         * @brief The number of records.
+         */
+        uint32_t count;
+
+        /**
+         * @brief The number of notifications dropped because the queue was
+         * full, since the plugin was loaded.
+         */
+        uint64_t dropped_count;
+    };
+
+    /**
+     * @brief Removes every subscription that was added through this queue.
+     */
+    void remove_all();
+
+    /**
+     * @brief Queues incoming P2P connection requests for the given local
+     * user.
+     *
+     * @param local_user_id The user to receive connection requests for.
+     * @param socket_name The socket to receive connection requests for, or
+     * null for every socket.
+     * @return The id of the subscription, or zero if the notification could
+     * not be registered.
+     */
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueuePeerConnectionRequests(EOS_ProductUserId local_user_id, const char* socket_name);
+
+    /**
+     * @brief Queues lobby updates, lobby member updates and lobby member
+     * status changes.
+     *
+     * @return The id of the subscription, or zero if the notifications could
+     * not be registered.
+     */
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueueLobbyNotifications();
+
+    /**
+     * @brief Queues presence changes.
+     *
+     * @return The id of the subscription, or zero if the notification could
+     * not be registered.
+     */
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueuePresenceNotifications();
+
+    /**
+     * @brief Queues participant status changes in the given RTC room.
+     *
+     * @param local_user_id The local user in the room.
+     * @param room_name The name of the room.
+     * @return The id of the subscription, or zero if the notification could
+     * not be registered.
+     */
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueueRTCParticipantStatus(EOS_ProductUserId local_user_id, const char* room_name);
+
+    /**
+     * @brief Removes a subscription. Notifications that were already queued
+     * are still handed out by the next drain.
+     *
+     * @param subscription_id The id returned when the subscription was
+     * added.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_RemoveQueuedNotifications(uint64_t subscription_id);
+
+    /**
+     * @brief Hands out the notifications queued since the previous call.
+     *
+     * The records stay valid until the next call, which reuses their memory
+     * for the notifications that arrive in the meantime.
+     *
+     * @param batch Receives the queued records.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_DrainNotifications(NotificationBatch* batch);
+}
+#endif
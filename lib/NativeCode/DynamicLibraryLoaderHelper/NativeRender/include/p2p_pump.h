@@ -0,0 +1,169 @@
+#ifndef P2P_PUMP_H
+#define P2P_PUMP_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <eos_p2p_types.h>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file p2p_pump.h
+  * @brief Receives P2P packets natively, so that managed code can collect
+  * all packets of a tick with a single call.
+  *
+  * Without the pump, managed code calls EOS_P2P_GetNextReceivedPacketSize
+  * and EOS_P2P_ReceivePacket for every packet. Instead, once the pump is
+  * started for a local user, every packet the SDK holds is received after
+  * each tick of the default platform and stored in a ring for its channel.
+  * The rings are single-producer single-consumer: the thread that ticks
+  * the platform fills them and PEW_P2P_DrainBatch empties them, without
+  * locking each other out. Each ring owns a pool of packet-sized buffers
+  * that is allocated when its channel first receives a packet, and reused
+  * from then on.
+  *
+  * When the ring of a channel is full, the pump stops receiving until the
+  * next drain instead of dropping the packet, leaving the remaining packets
+  * in the queue of the SDK. Packets are handed out in order within each
+  * channel, but not across channels.
+  *
+  * The layouts are mirrored by NativeP2PReceiver.cs in the managed package;
+  * change both together.
+  */
+
+namespace pew::eos::p2p_pump
+{
+    /**
+     * @brief The number of packets the ring of each channel holds.
+     */
+    constexpr uint32_t PACKETS_PER_CHANNEL = 256;
+
+    /**
+     * @brief Describes one packet of a batch.
+     */
+    struct PacketDescriptor
+    {
+        /**
+         * @brief The user who sent the packet.
+         */
+        EOS_ProductUserId peer_id;
+
+        /**
+         * @brief Offset of the payload in the payload arena.
+         */
+        uint32_t payload_offset;
+
+        /**
+         * @brief Size in bytes of the payload.
+         */
+        uint32_t payload_size;
+
+        /**
+         * @brief Offset in the payload arena of the null-terminated name of
+         * the socket the packet was sent on. Packets sent on the same socket
+         * share the name.
+         */
+        uint32_t socket_name_offset;
+
+        uint8_t channel;
+        uint8_t reserved[3];
+    };
+
+    /**
+     * @brief The packets received since the previous drain.
+     */
+    struct PacketBatch
+    {
+        /**
+         * @brief The descriptors of the packets, or null if there are none.
+         */
+        const PacketDescriptor* descriptors;
+
+        /**
+         * @brief The number of descriptors.
+         */
+        uint32_t descriptor_count;
+
+        /**
+         * @brief Size in bytes of the payload arena.
+         */
+        uint32_t payload_size;
+
+        /**
+         * @brief The payloads and socket names of the packets.
+         */
+        const uint8_t* payload_arena;
+    };
+
+    /**
+     * @brief Receives the packets the SDK holds, if the pump is running for
+     * the given platform. Called after the platform is ticked, on the
+     * ticking thread.
+     *
+     * @param platform The platform that was ticked.
+     */
+    void pump(EOS_HPlatform platform);
+
+    /**
+     * @brief Stops receiving packets. Packets already in the rings are still
+     * handed out by the next drain; a packet held back because the ring of
+     * its channel was full is dropped.
+     */
+    void stop();
+
+    /**
+     * @brief Starts receiving the packets sent to the given local user on
+     * the default platform, replacing any user the pump was started for.
+     *
+     * @param local_user_id The user to receive packets for.
+     * @return `false` if there is no default platform, or the SDK does not
+     * provide the P2P functions.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_P2P_StartReceivePump(EOS_ProductUserId local_user_id);
+
+    /**
+     * @brief Stops receiving packets, see stop.
+     */
+    PEW_EOS_API_FUNC(void) PEW_P2P_StopReceivePump();
+
+    /**
+     * @brief Receives the packets the SDK holds. Hosts that tick the default
+     * platform themselves, instead of through the plugin, call this right
+     * after each tick, on the same thread.
+     */
+    PEW_EOS_API_FUNC(void) PEW_P2P_PumpAfterTick();
+
+    /**
+     * @brief Hands out every packet received since the previous call. Does
+     * not call the SDK, so it may be called from any thread, but from one
+     * thread at a time.
+     *
+     * The descriptors and the payload arena stay valid until the next call.
+     *
+     * @param batch Receives the packets.
+     */
+    PEW_EOS_API_FUNC(void) PEW_P2P_DrainBatch(PacketBatch* batch);
+}
+#endif
@@ -0,0 +1,180 @@
+#ifndef PLATFORM_REGISTRY_H
+#define PLATFORM_REGISTRY_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <eos_types.h>
+
+#include "PEW_EOS_Defines.h"
+#include "config_snapshot.h"
+
+ /**
+  * @file platform_registry.h
+  * @brief Keeps track of the EOS platforms created in this process.
+  *
+  * The platform that the plugin creates when it is loaded is registered as
+  * the default platform. Further platforms (for instance to run several
+  * matches in one server process, or a client and a server side by side)
+  * are created from a config snapshot, and are identified by the id they
+  * are registered under rather than by their handle, so that a released
+  * platform cannot be used by mistake.
+  *
+  * Each created platform has a tick rate of its own, and is ticked by
+  * tick_due. The platforms share no thread: whoever calls tick_due ticks
+  * every platform that is due, so releasing a platform must happen on that
+  * same thread, as the SDK requires.
+  */
+
+namespace pew::eos::platform_registry
+{
+    /**
+     * @brief Identifies a registered platform. Zero is never a valid id.
+     */
+    using PlatformId = uint32_t;
+
+    /**
+     * @brief The id of the platform that the plugin creates when it is
+     * loaded.
+     */
+    constexpr PlatformId DEFAULT_PLATFORM_ID = 1;
+
+    /**
+     * @brief Registers the platform created by the plugin as the default
+     * platform. The default platform is not ticked by the registry; it is
+     * ticked by managed code, the tick controller or the tick driver.
+     *
+     * @return `false` if there already is a default platform.
+     */
+    bool set_default(EOS_HPlatform platform);
+
+    /**
+     * @brief Creates a platform from the given config snapshot and registers
+     * it. The options are built like those of the default platform, so
+     * the RTC and integrated platform options come from the configs, and
+     * the values the snapshot carries replace the ones from the configs.
+     *
+     * @param snapshot The product and platform config to create the
+     * platform with, for instance a modified copy of the snapshot returned
+     * by PEW_EOS_GetConfigSnapshot.
+     * @param ticks_per_second The rate at which tick_due ticks the platform,
+     * or zero if it is ticked by the caller.
+     * @return The id of the platform, or zero if it could not be created,
+     * or if a shutdown has started.
+     */
+    PlatformId create(const config_snapshot::ConfigSnapshot& snapshot, uint32_t ticks_per_second);
+
+    /**
+     * @brief Gets the handle of a registered platform.
+     *
+     * @return The handle, or `nullptr` if no platform is registered under
+     * the id.
+     */
+    EOS_HPlatform get(PlatformId platform_id);
+
+    /**
+     * @brief Gets the handle of the default platform, or `nullptr` if it has
+     * not been created (or has been released).
+     */
+    EOS_HPlatform get_default();
+
+    /**
+     * @brief Changes the rate at which tick_due ticks a platform.
+     *
+     * @return `false` if no platform is registered under the id.
+     */
+    bool set_tick_rate(PlatformId platform_id, uint32_t ticks_per_second);
+
+    /**
+     * @brief Ticks every platform whose next tick is due. When a platform
+     * has fallen behind, the ticks it missed are skipped.
+     *
+     * @return The time at which the next tick is due, or the maximum time
+     * point if no platform is ticked by the registry.
+     */
+    std::chrono::steady_clock::time_point tick_due();
+
+    /**
+     * @brief Ticks every platform once, the default platform included,
+     * regardless of their tick rates.
+     */
+    void tick_all();
+
+    /**
+     * @brief Unregisters a platform and releases it. Releasing the default
+     * platform also stops the tick driver and removes the notifications
+     * queued for it. If the platform is being ticked on another thread, this
+     * waits for the tick to end. A platform cannot be released from its own
+     * callbacks.
+     *
+     * @return `false` if no platform is registered under the id, or if the
+     * platform is being ticked on this thread.
+     */
+    bool release(PlatformId platform_id);
+
+    /**
+     * @brief Releases every platform created with create. The default
+     * platform is left to its owner.
+     */
+    void release_created();
+
+    /**
+     * @brief Releases every platform, the default platform included.
+     */
+    void release_all();
+
+    /**
+     * @brief Creates a platform, see create.
+     *
+     * @return The id of the platform, or zero if the snapshot is not valid
+     * or the platform could not be created.
+     */
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_CreatePlatform(const config_snapshot::ConfigSnapshot* snapshot, uint32_t ticks_per_second);
+
+    /**
+     * @brief Releases a platform, see release.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_ReleasePlatform(uint32_t platform_id);
+
+    /**
+     * @brief Gets the handle of a registered platform, or null.
+     */
+    PEW_EOS_API_FUNC(void*) PEW_EOS_GetPlatform(uint32_t platform_id);
+
+    /**
+     * @brief Changes the tick rate of a platform, see set_tick_rate.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_SetPlatformTickRate(uint32_t platform_id, uint32_t ticks_per_second);
+
+    /**
+     * @brief Ticks every platform that is due, see tick_due.
+     *
+     * @return The number of microseconds until the next tick is due (zero if
+     * one already is), or UINT32_MAX if no platform is ticked by the
+     * registry.
+     */
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_TickPlatforms();
+}
+#endif
@@ -0,0 +1,135 @@
+#ifndef SHUTDOWN_H
+#define SHUTDOWN_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file shutdown.h
+  * @brief Shuts the EOS SDK down within a bounded time.
+  *
+  * The shutdown runs in stages, each of which is timed:
+  *
+  * 1. New work is refused: the tick driver and the config watcher are
+  *    stopped, no more platforms can be created, and
+  *    PEW_EOS_BeginPendingRequest fails.
+  * 2. Every platform is ticked until the pending requests (see
+  *    PEW_EOS_BeginPendingRequest) have completed, or until the deadline.
+  * 3. The flight recorder is written to disk.
+  * 4. Every platform is released.
+  * 5. The SDK is shut down, if asked to.
+  *
+  * The SDK does not tell whether requests are still in flight, so only the
+  * requests that callers mark as pending are waited for; any other request
+  * gets the ticks of the drain stage, but may still be abandoned.
+  */
+
+namespace pew::eos::shutdown
+{
+    /**
+     * @brief How long the stages of a shutdown took. This struct is
+     * blittable so that it can be read directly from managed code.
+     */
+    struct ShutdownReport
+    {
+        /**
+         * @brief Non-zero if the deadline passed while requests were still
+         * pending.
+         */
+        uint32_t timed_out;
+
+        /**
+         * @brief The number of requests that were still pending when the
+         * drain stage ended.
+         */
+        uint32_t pending_request_count;
+
+        /**
+         * @brief The number of times the platforms were ticked during the
+         * drain stage.
+         */
+        uint32_t drain_tick_count;
+
+        /**
+         * @brief Non-zero if EOS_Shutdown was called.
+         */
+        uint32_t sdk_shut_down;
+
+        uint64_t stop_requests_microseconds;
+        uint64_t drain_microseconds;
+        uint64_t flush_log_microseconds;
+        uint64_t release_platforms_microseconds;
+        uint64_t shutdown_sdk_microseconds;
+        uint64_t total_microseconds;
+    };
+
+    /**
+     * @brief Determines whether a shutdown has started. Work that cannot be
+     * finished before the platforms are released must not be started then.
+     */
+    bool is_shutting_down();
+
+    /**
+     * @brief Runs the shutdown. Must be called from the thread that ticks
+     * the platforms, and not from an SDK callback. Once the SDK has been shut
+     * down, further calls do nothing. If it was not, the shutdown ends once
+     * the platforms are released, and platforms and pending requests can be
+     * created again afterwards.
+     *
+     * @param deadline_in_milliseconds The longest time to spend waiting for
+     * pending requests.
+     * @param shutdown_sdk Whether to call EOS_Shutdown once the platforms
+     * are released. The SDK cannot be initialized again in the same process
+     * afterwards.
+     * @param report Receives the timings of the stages, may be null.
+     * @return `true` if the shutdown ran, `false` if another shutdown is in
+     * progress or the SDK has already been shut down.
+     */
+    bool run(uint32_t deadline_in_milliseconds, bool shutdown_sdk, ShutdownReport* report);
+
+    /**
+     * @brief Marks a request as pending, so that a shutdown waits for its
+     * callback (within its deadline). Call PEW_EOS_EndPendingRequest from
+     * the callback.
+     *
+     * @return `false` if a shutdown has started, in which case the request
+     * must not be made.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_BeginPendingRequest();
+
+    /**
+     * @brief Marks a request that was made after PEW_EOS_BeginPendingRequest
+     * as completed.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_EndPendingRequest();
+
+    /**
+     * @brief Runs the shutdown, see run.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_Shutdown(uint32_t deadline_in_milliseconds, bool shutdown_sdk, ShutdownReport* report);
+}
+#endif
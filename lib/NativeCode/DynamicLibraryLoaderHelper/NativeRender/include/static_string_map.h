@@ -0,0 +1,206 @@
+#ifndef STATIC_STRING_MAP_H
+#define STATIC_STRING_MAP_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace pew::eos
+{
+    /**
+     * @brief An entry of a StaticStringMap.
+     */
+    template <typename T>
+    struct StaticStringMapEntry
+    {
+        std::string_view key;
+        T value;
+    };
+
+    /**
+     * @brief Immutable map from strings to values, built at compile time.
+     *
+     * The map is a perfect hash table: while the map is being constructed, a
+     * seed is searched for under which every key hashes to a different slot.
+     * A lookup therefore hashes the key once and compares it against at most
+     * one entry, and never allocates. Construct instances with
+     * make_static_string_map, as `constexpr` variables, so that the search
+     * happens during compilation (a table for which no seed can be found,
+     * for instance because it contains the same key twice, then fails to
+     * compile).
+     *
+     * @tparam T The type of the values.
+     * @tparam N The number of entries.
+     */
+    template <typename T, size_t N>
+    class StaticStringMap
+    {
+    public:
+        using Entry = StaticStringMapEntry<T>;
+
+        constexpr explicit StaticStringMap(const Entry (&entries)[N]) :
+            StaticStringMap(entries, std::make_index_sequence<N>())
+        {
+        }
+
+        /**
+         * @brief Finds the value mapped to the given key.
+         *
+         * @return A pointer to the value, or `nullptr` if the key is not in
+         * the map.
+         */
+        constexpr const T* find(std::string_view key) const
+        {
+            const uint8_t index = _slots[get_slot(key, _seed)];
+            return (index != EMPTY_SLOT && _entries[index].key == key) ? &_entries[index].value : nullptr;
+        }
+
+        /**
+         * @brief Determines whether the given key is in the map.
+         */
+        constexpr bool contains(std::string_view key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        constexpr size_t size() const { return N; }
+
+        constexpr const Entry* begin() const { return _entries; }
+        constexpr const Entry* end() const { return _entries + N; }
+
+    private:
+        static_assert(N > 0, "A StaticStringMap must have at least one entry.");
+        static_assert(N < 0xFF, "A StaticStringMap can hold at most 254 entries.");
+
+        static constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+        static constexpr size_t get_slot_count()
+        {
+            size_t slot_count = 8;
+            while (slot_count < N * 4)
+            {
+                slot_count *= 2;
+            }
+            return slot_count;
+        }
+
+        /**
+         * @brief Number of slots in the hash table. Keeping the table at
+         * least four times as large as the number of entries keeps the
+         * number of seeds that have to be tried small.
+         */
+        static constexpr size_t SLOT_COUNT = get_slot_count();
+
+        /**
+         * @brief Upper bound on the number of seeds that are tried before
+         * giving up on building the table.
+         */
+        static constexpr uint32_t MAX_SEED = 4096;
+
+        template <size_t... Indices>
+        constexpr StaticStringMap(const Entry (&entries)[N], std::index_sequence<Indices...>) :
+            _entries{ entries[Indices]... },
+            _slots(),
+            _seed(0)
+        {
+            while (!try_seed(_seed))
+            {
+                if (++_seed == MAX_SEED)
+                {
+                    throw std::logic_error("No perfect hash exists for the keys of the StaticStringMap (is a key duplicated?).");
+                }
+            }
+        }
+
+        /**
+         * @brief Hashes a key with 32-bit FNV-1a, starting from a basis that
+         * is varied by the seed, and maps the hash to a slot.
+         */
+        static constexpr size_t get_slot(std::string_view key, uint32_t seed)
+        {
+            uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+            for (const char character : key)
+            {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 16777619u;
+            }
+
+            // The low bits of FNV-1a are not well mixed, so fold in the high
+            // bits before masking.
+            hash ^= hash >> 16;
+            return hash & (SLOT_COUNT - 1);
+        }
+
+        /**
+         * @brief Fills the slots using the given seed.
+         *
+         * @return `true` if every key was placed in a slot of its own,
+         * `false` if two keys collided.
+         */
+        constexpr bool try_seed(uint32_t seed)
+        {
+            for (size_t slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                _slots[slot] = EMPTY_SLOT;
+            }
+
+            for (size_t index = 0; index < N; ++index)
+            {
+                const size_t slot = get_slot(_entries[index].key, seed);
+                if (_slots[slot] != EMPTY_SLOT)
+                {
+                    return false;
+                }
+                _slots[slot] = static_cast<uint8_t>(index);
+            }
+
+            return true;
+        }
+
+        Entry _entries[N];
+        uint8_t _slots[SLOT_COUNT];
+        uint32_t _seed;
+    };
+
+    /**
+     * @brief Creates a StaticStringMap from the given entries.
+     *
+     * @code
+     * constexpr auto COLORS = make_static_string_map<int>({
+     *     { "Red",   0xFF0000 },
+     *     { "Green", 0x00FF00 },
+     * });
+     * @endcode
+     */
+    template <typename T, size_t N>
+    constexpr StaticStringMap<T, N> make_static_string_map(const StaticStringMapEntry<T> (&entries)[N])
+    {
+        return StaticStringMap<T, N>(entries);
+    }
+}
+#endif
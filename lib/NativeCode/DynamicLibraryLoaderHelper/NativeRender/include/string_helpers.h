@@ -23,7 +23,10 @@
  */
 
 #pragma once
+#include <array>
+#include <cctype>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <filesystem>
 
@@ -51,6 +54,180 @@ namespace pew::eos::string_helpers
        */
     std::vector<std::string> split_and_trim(const std::string& input, char delimiter = ',');
 
+    /**
+       * \brief Trims the whitespace from the beginning and end of a string,
+       * without copying it.
+       *
+       * \param str The string to trim.
+       *
+       * \return A view of the part of the string that is not whitespace.
+       */
+    std::string_view trim_view(std::string_view str);
+
+    /**
+       * \brief
+       * Splits a string by the indicated delimiter, trims the results of the
+       * split, and calls the given function with each non-empty value. Unlike
+       * split_and_trim, the values are views into the input, so nothing is
+       * copied or allocated.
+       *
+       * \param input The string to split and trim.
+       *
+       * \param delimiter The character at which to split the string.
+       *
+       * \param function Function called with each value, as a
+       * std::string_view.
+       */
+    template <typename Function>
+    void for_each_token(std::string_view input, char delimiter, Function&& function)
+    {
+        while (true)
+        {
+            const size_t delimiter_index = input.find(delimiter);
+
+            const std::string_view token = trim_view(input.substr(0, delimiter_index));
+            if (!token.empty())
+            {
+                function(token);
+            }
+
+            if (delimiter_index == std::string_view::npos)
+            {
+                break;
+            }
+            input.remove_prefix(delimiter_index + 1);
+        }
+    }
+
+    /**
+       * \brief
+       * Splits a string at runs of whitespace, and calls the given function
+       * with each non-empty value (a view into the input), the way a stream
+       * extracts whitespace-separated words.
+       *
+       * \param input The string to split.
+       *
+       * \param function Function called with each word, as a
+       * std::string_view.
+       */
+    template <typename Function>
+    void for_each_word(std::string_view input, Function&& function)
+    {
+        const auto is_space = [](char character) { return std::isspace(static_cast<unsigned char>(character)) != 0; };
+
+        size_t index = 0;
+        while (index < input.size())
+        {
+            while (index < input.size() && is_space(input[index]))
+            {
+                ++index;
+            }
+
+            const size_t word_start = index;
+            while (index < input.size() && !is_space(input[index]))
+            {
+                ++index;
+            }
+
+            if (index > word_start)
+            {
+                function(input.substr(word_start, index - word_start));
+            }
+        }
+    }
+
+    /**
+       * \brief
+       * A list of views into a string, as returned by split_view. The first
+       * N views are stored inline, so that splitting a short string does not
+       * allocate; any further views are stored on the heap.
+       *
+       * The views point into the string that was split, which therefore has
+       * to outlive the list.
+       *
+       * \tparam N The number of views stored inline.
+       */
+    template <size_t N>
+    class TokenList
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            const_iterator(const TokenList* list, size_t index) : _list(list), _index(index) {}
+
+            std::string_view operator*() const { return (*_list)[_index]; }
+            const_iterator& operator++() { ++_index; return *this; }
+            bool operator==(const const_iterator& other) const { return _index == other._index; }
+            bool operator!=(const const_iterator& other) const { return _index != other._index; }
+
+        private:
+            const TokenList* _list;
+            size_t _index;
+        };
+
+        void push_back(std::string_view token)
+        {
+            if (_size < N)
+            {
+                _inline_tokens[_size] = token;
+            }
+            else
+            {
+                _overflow_tokens.push_back(token);
+            }
+            ++_size;
+        }
+
+        std::string_view operator[](size_t index) const
+        {
+            return index < N ? _inline_tokens[index] : _overflow_tokens[index - N];
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, _size); }
+
+    private:
+        std::array<std::string_view, N> _inline_tokens = {};
+        std::vector<std::string_view> _overflow_tokens;
+        size_t _size = 0;
+    };
+
+    /**
+       * \brief
+       * Splits a string by the indicated delimiter, without trimming or
+       * dropping empty values (so "1..2" yields three values, the second of
+       * which is empty).
+       *
+       * \tparam N The number of values to store without allocating.
+       *
+       * \param input The string to split.
+       *
+       * \param delimiter The character at which to split the string.
+       *
+       * \return Views into the input, one for each value.
+       */
+    template <size_t N = 8>
+    TokenList<N> split_view(std::string_view input, char delimiter)
+    {
+        TokenList<N> tokens;
+        while (true)
+        {
+            const size_t delimiter_index = input.find(delimiter);
+            tokens.push_back(input.substr(0, delimiter_index));
+
+            if (delimiter_index == std::string_view::npos)
+            {
+                break;
+            }
+            input.remove_prefix(delimiter_index + 1);
+        }
+        return tokens;
+    }
+
     /**
      * @brief Creates an ISO 8601 formatted timestamp string with millisecond precision.
      *
@@ -67,8 +244,8 @@ namespace pew::eos::string_helpers
     /**
      * @brief Calculates the number of bytes required to store a UTF-8 encoded version of a wide string.
      *
-     * This function uses `WideCharToMultiByte` to determine the number of bytes necessary to represent
-     * a given wide string in UTF-8 encoding.
+     * This function counts the number of bytes necessary to represent a given wide string in UTF-8
+     * encoding, without converting it (see utf_transcode.h).
      *
      * @param[in] wide_str The wide string to evaluate.
      * @param[in] wide_str_len The length of the wide string.
@@ -121,15 +298,8 @@ namespace pew::eos::string_helpers
     /**
      * @brief Converts a wide string to a UTF-8 encoded `std::string`.
      *
-     * Uses `std::wstring_convert` for the conversion. If `std::wstring_convert`
-     * becomes unsupported in the future, this function could be rewritten using
-     * `create_utf8_str_from_wide_str`.
-     *
-     * Using the std::wstring_convert method for this currently. It might be the
-     * case that in the future this method won't work. If that happens, one
-     * could convert this function to use the create_utf8_str_from_wide_str
-     * function to emulate it. Doing this might come with a cost, as data will
-     * need to be copied multiple times.
+     * Converts straight into the returned string with `wide_to_utf8` (see
+     * utf_transcode.h), which is sized for the worst case and then shrunk.
      *
      * @param[in] wide_str The wide string to convert.
      * @return A UTF-8 encoded `std::string` representation of the wide string.
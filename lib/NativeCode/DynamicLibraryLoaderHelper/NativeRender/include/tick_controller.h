@@ -0,0 +1,167 @@
+#ifndef TICK_CONTROLLER_H
+#define TICK_CONTROLLER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <eos_types.h>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file tick_controller.h
+  * @brief Adapts how much work the EOS SDK does each frame to the frame
+  * time.
+  *
+  * The SDK only takes its tick budget when the platform is created, and
+  * re-creating the platform would drop all of its state (logins, lobbies,
+  * connections). So instead of changing the budget, the controller changes
+  * how many bounded ticks are run each frame. It keeps an allowance of time
+  * that EOS may use per frame: the allowance is halved while the smoothed
+  * frame time exceeds the frame budget, and grows by one tick budget at a
+  * time while the frame time is comfortably below it. Ticks are repeated
+  * until the allowance is used up, or until a tick finishes well within the
+  * tick budget, which means that the SDK has no deferred work left.
+  *
+  * While a loading screen is up, and for frames that are so long that they
+  * must be hitches, the frame time is not held against EOS: the allowance is
+  * raised to the whole frame budget instead.
+  *
+  * The controller only has something to adjust when the platform was
+  * created with a tick budget; without one, every tick does all the work
+  * that is queued, and one tick is run per frame.
+  */
+
+namespace pew::eos::tick_controller
+{
+    /**
+     * @brief The maximum number of ticks run in a single frame.
+     */
+    constexpr uint32_t MAX_TICKS_PER_FRAME = 8;
+
+    /**
+     * @brief The share of the frame budget that EOS may use per frame,
+     * outside of loading screens.
+     */
+    constexpr double MAX_FRAME_BUDGET_SHARE = 0.5;
+
+    /**
+     * @brief Frames longer than this multiple of the frame budget are
+     * counted as hitches, and left out of the smoothed frame time.
+     */
+    constexpr double HITCH_FRAME_BUDGET_MULTIPLE = 4.0;
+
+    /**
+     * @brief State of the tick controller. This struct is blittable so that
+     * it can be read directly from managed code.
+     */
+    struct TickControllerStatistics
+    {
+        /**
+         * @brief Non-zero if a frame budget is configured.
+         */
+        uint32_t is_enabled;
+
+        /**
+         * @brief Non-zero while a loading screen is up.
+         */
+        uint32_t is_loading;
+
+        float frame_budget_in_milliseconds;
+
+        /**
+         * @brief The time EOS may currently use per frame.
+         */
+        float allowance_in_milliseconds;
+
+        float smoothed_frame_time_in_milliseconds;
+        float smoothed_tick_time_in_milliseconds;
+
+        /**
+         * @brief The number of ticks run in the most recent frame.
+         */
+        uint32_t last_frame_tick_count;
+        uint32_t reserved;
+
+        uint64_t frame_count;
+        uint64_t tick_count;
+        uint64_t hitch_count;
+    };
+
+    /**
+     * @brief Sets the frame budget to target, and the tick budget that the
+     * platform was created with. Safe to call from any thread.
+     *
+     * @param frame_budget_in_milliseconds The time a frame should take, or
+     * zero to disable the controller.
+     * @param tick_budget_in_milliseconds The tick budget of the platform, or
+     * zero if it has none.
+     */
+    void configure(float frame_budget_in_milliseconds, uint32_t tick_budget_in_milliseconds);
+
+    /**
+     * @brief Changes the frame budget to target, keeping the tick budget.
+     * Safe to call from any thread.
+     *
+     * @param frame_budget_in_milliseconds The time a frame should take, or
+     * zero to disable the controller.
+     */
+    void set_frame_budget(float frame_budget_in_milliseconds);
+
+    /**
+     * @brief Runs the ticks of one frame. Call once per frame, from the
+     * thread that ticks the platform.
+     *
+     * @param platform The platform to tick.
+     * @return `false` (without ticking) if the controller is disabled or the
+     * platform cannot be ticked, `true` otherwise.
+     */
+    bool tick(EOS_HPlatform platform);
+
+    /**
+     * @brief Tells the controller whether a loading screen is up.
+     */
+    void set_loading(bool is_loading);
+
+    /**
+     * @brief Runs the ticks of one frame for the platform created by the
+     * plugin, see tick. Does nothing, and returns `false`, while the tick
+     * driver is running.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_TickWithinFrameBudget();
+
+    /**
+     * @brief Tells the tick controller whether a loading screen is up, see
+     * set_loading.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_SetLoadingScreenActive(bool is_loading);
+
+    /**
+     * @brief Copies the state of the tick controller.
+     *
+     * @param statistics The struct to copy the state into.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_GetTickControllerStatistics(TickControllerStatistics* statistics);
+}
+#endif
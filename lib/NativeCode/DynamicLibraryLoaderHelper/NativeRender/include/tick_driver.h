@@ -0,0 +1,210 @@
+#ifndef TICK_DRIVER_H
+#define TICK_DRIVER_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <eos_types.h>
+
+#include "PEW_EOS_Defines.h"
+
+ /**
+  * @file tick_driver.h
+  * @brief Ticks the EOS platform at a fixed rate on a thread of its own.
+  *
+  * Normally the platform is ticked by managed code once per frame, so the
+  * SDK is serviced less often when the frame rate drops, and not at all
+  * during a hitch. When the driver is running, EOS_Platform_Tick is called
+  * from the driver thread instead, on a fixed schedule that does not depend
+  * on the frame rate. SDK callbacks are then also run on the driver thread.
+  *
+  * The EOS SDK must only be called from one thread at a time, and from the
+  * thread that ticks the platform. Under Unity, managed code calls the SDK
+  * from the main thread whether or not it ticks the platform, so the driver
+  * is not allowed to run by default. Hosts that make no SDK calls outside of
+  * SDK callbacks (and so only call the SDK from the driver thread) allow it
+  * with PEW_EOS_AllowTickDriver. The driver does not start until then, and
+  * "nativeTickRate" in the platform config is ignored.
+  *
+  * A tick that takes longer than the tick budget (or, without a budget,
+  * longer than the tick interval) is counted as an overrun. When ticks fall
+  * behind the schedule, the ticks that were missed are skipped rather than
+  * run back to back, so an overrun never turns into a burst of ticks.
+  */
+
+namespace pew::eos::tick_driver
+{
+    /**
+     * @brief The number of buckets of each histogram. Bucket 0 counts
+     * durations of less than 32 microseconds, and bucket i (for i > 0)
+     * durations from 2^(i+4) up to 2^(i+5) microseconds. The last bucket
+     * also counts every longer duration.
+     */
+    constexpr size_t TICK_HISTOGRAM_BUCKET_COUNT = 16;
+
+    /**
+     * @brief The highest rate the driver ticks at. Higher rates are clamped
+     * to it.
+     */
+    constexpr uint32_t MAX_TICKS_PER_SECOND = 1000;
+
+    /**
+     * @brief Statistics of the tick driver. This struct is blittable so that
+     * it can be read directly from managed code.
+     */
+    struct TickDriverStatistics
+    {
+        /**
+         * @brief Non-zero while the driver is ticking the platform.
+         */
+        uint32_t is_running;
+
+        /**
+         * @brief The rate the driver ticks at (or last ticked at).
+         */
+        uint32_t ticks_per_second;
+
+        /**
+         * @brief The duration above which a tick counts as an overrun: the
+         * tick budget if there is one, the tick interval otherwise.
+         */
+        uint64_t overrun_threshold_microseconds;
+
+        uint64_t tick_count;
+
+        /**
+         * @brief The number of ticks that took longer than the overrun
+         * threshold.
+         */
+        uint64_t overrun_count;
+
+        /**
+         * @brief The number of scheduled ticks that were skipped because the
+         * driver had fallen behind.
+         */
+        uint64_t missed_tick_count;
+
+        uint64_t total_tick_microseconds;
+        uint64_t max_tick_microseconds;
+
+        /**
+         * @brief The largest delay between the time a tick was scheduled for
+         * and the time it started.
+         */
+        uint64_t max_jitter_microseconds;
+
+        /**
+         * @brief Histogram of the time spent in EOS_Platform_Tick.
+         */
+        uint64_t duration_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+
+        /**
+         * @brief Histogram of the delay with which ticks started.
+         */
+        uint64_t jitter_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+
+        /**
+         * @brief Histogram of the time by which overrunning ticks exceeded
+         * the overrun threshold.
+         */
+        uint64_t overrun_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+    };
+
+    /**
+     * @brief Starts ticking the given platform. If the driver is already
+     * running, it is stopped first.
+     *
+     * @param platform The platform to tick.
+     * @param ticks_per_second The rate to tick the platform at.
+     * @param tick_budget_in_milliseconds The tick budget the platform was
+     * created with, or zero if it has none.
+     * @return `true` if the driver was started, `false` if the driver is
+     * not allowed to run, or the platform, the rate or EOS_Platform_Tick is
+     * not available.
+     */
+    bool start(EOS_HPlatform platform, uint32_t ticks_per_second, uint32_t tick_budget_in_milliseconds);
+
+    /**
+     * @brief Stops ticking the platform, and waits for a tick that is in
+     * progress to finish. Must not be called from an SDK callback.
+     */
+    void stop();
+
+    /**
+     * @brief Determines whether the host allowed the driver to run, see
+     * PEW_EOS_AllowTickDriver.
+     */
+    bool is_allowed();
+
+    /**
+     * @brief Determines whether the driver is ticking the platform.
+     */
+    bool is_running();
+
+    /**
+     * @brief Allows the driver to run, or stops it and forbids it from
+     * running again. Only hosts that make no SDK calls from any other thread
+     * than the one that ticks may allow it; call this before the plugin is
+     * loaded, so that the driver can start along with the platform.
+     *
+     * @param is_allowed Whether the driver may run.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_AllowTickDriver(bool is_allowed);
+
+    /**
+     * @brief Starts ticking the platform created by the plugin at the given
+     * rate, with the tick budget from the platform config.
+     *
+     * @return `true` if the driver was started.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_StartTickDriver(uint32_t ticks_per_second);
+
+    /**
+     * @brief Stops the tick driver, see stop.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_StopTickDriver();
+
+    /**
+     * @brief Determines whether the tick driver is running, in which case
+     * managed code must not tick the platform itself.
+     */
+    PEW_EOS_API_FUNC(bool) PEW_EOS_IsTickDriverRunning();
+
+    /**
+     * @brief Copies the statistics of the tick driver.
+     *
+     * Counters are read individually, so a copy that is taken while the
+     * platform is being ticked may be off by one tick.
+     *
+     * @param statistics The struct to copy the statistics into.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_GetTickDriverStatistics(TickDriverStatistics* statistics);
+
+    /**
+     * @brief Resets the counters and histograms of the tick driver to zero.
+     */
+    PEW_EOS_API_FUNC(void) PEW_EOS_ResetTickDriverStatistics();
+}
+#endif
@@ -0,0 +1,138 @@
+#ifndef UTF_TRANSCODE_H
+#define UTF_TRANSCODE_H
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file utf_transcode.h
+ * @brief Conversions between UTF-8 and UTF-16 or UTF-32 into buffers that
+ * the caller provides.
+ *
+ * Runs of ASCII, which make up most of the paths and names that cross the
+ * interop boundary, are converted 8 or 16 code units at a time with SSE2
+ * on x86 and NEON on 64-bit ARM; everything else is converted one code
+ * point at a time. Invalid input (unpaired surrogates, overlong or
+ * truncated UTF-8 sequences and so on) is replaced by U+FFFD, which is
+ * what WideCharToMultiByte and MultiByteToWideChar do by default, and
+ * reported in the result.
+ *
+ * Every conversion can also be run without an output buffer, in which case
+ * it only counts the code units that it would write.
+ */
+
+namespace pew::eos::string_helpers
+{
+    /**
+     * @brief The result of a conversion.
+     */
+    struct TranscodeResult
+    {
+        /**
+         * @brief The number of input code units that were converted. This is
+         * less than the length of the input if the output buffer filled up;
+         * conversion always stops on a code point boundary.
+         */
+        size_t read;
+
+        /**
+         * @brief The number of output code units that were written (or that
+         * would be written, when counting).
+         */
+        size_t written;
+
+        /**
+         * @brief `false` if any invalid input was replaced by U+FFFD.
+         */
+        bool valid;
+    };
+
+    /**
+     * @brief Converts UTF-16 to UTF-8.
+     *
+     * @param input The code units to convert. A null terminator is converted
+     * like any other character.
+     * @param length The number of code units to convert.
+     * @param output The buffer to write to, or `nullptr` to only count.
+     * @param capacity The number of code units that fit in the buffer.
+     */
+    TranscodeResult utf16_to_utf8(const char16_t* input, size_t length, char* output, size_t capacity);
+
+    /**
+     * @brief Converts UTF-32 to UTF-8. See utf16_to_utf8.
+     */
+    TranscodeResult utf32_to_utf8(const char32_t* input, size_t length, char* output, size_t capacity);
+
+    /**
+     * @brief Converts a wide string (UTF-16 on Windows, UTF-32 elsewhere) to
+     * UTF-8. See utf16_to_utf8.
+     */
+    TranscodeResult wide_to_utf8(const wchar_t* input, size_t length, char* output, size_t capacity);
+
+    /**
+     * @brief Converts UTF-8 to UTF-16.
+     *
+     * @param input The code units to convert. A null terminator is converted
+     * like any other character.
+     * @param length The number of code units to convert.
+     * @param output The buffer to write to, or `nullptr` to only count.
+     * @param capacity The number of code units that fit in the buffer.
+     */
+    TranscodeResult utf8_to_utf16(const char* input, size_t length, char16_t* output, size_t capacity);
+
+    /**
+     * @brief Converts UTF-8 to UTF-32. See utf8_to_utf16.
+     */
+    TranscodeResult utf8_to_utf32(const char* input, size_t length, char32_t* output, size_t capacity);
+
+    /**
+     * @brief Converts UTF-8 to a wide string (UTF-16 on Windows, UTF-32
+     * elsewhere). See utf8_to_utf16.
+     */
+    TranscodeResult utf8_to_wide(const char* input, size_t length, wchar_t* output, size_t capacity);
+
+    /**
+     * @brief Gets a buffer size that is always large enough to hold the
+     * UTF-8 conversion of a wide string of the given length, so that short
+     * strings can be converted in a single pass.
+     */
+    constexpr size_t max_utf8_length_for_wide(size_t wide_length)
+    {
+        // A UTF-16 code unit never becomes more than 3 bytes (a surrogate
+        // pair becomes 4), and a UTF-32 code unit never more than 4.
+        return wide_length * (sizeof(wchar_t) == 2 ? 3 : 4);
+    }
+
+    /**
+     * @brief Gets a buffer size that is always large enough to hold the wide
+     * conversion of a UTF-8 string of the given length. Every byte becomes
+     * at most one wide code unit.
+     */
+    constexpr size_t max_wide_length_for_utf8(size_t utf8_length)
+    {
+        return utf8_length;
+    }
+}
+#endif
@@ -8,18 +8,21 @@
 #define PCH_H
 
 // add headers that you want to pre-compile here
+#if _WIN32 || _WIN64
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #define NOMINMAX
 // Windows Header Files
 #include <windows.h>
 
-#if _WIN32 || _WIN64
 #define PLATFORM_WINDOWS 1
 #if _WIN64
 #define PLATFORM_64BITS 1
 #else
 #define PLATFORM_32BITS 1
 #endif
+#elif __linux__
+#define PLATFORM_LINUX 1
+#define PLATFORM_64BITS 1
 #endif
 
 #define STATIC_EXPORT(return_type) extern "C" return_type
@@ -31,23 +34,40 @@
 #endif
 
 #include "eos_sdk.h"
+#if PLATFORM_WINDOWS
 #include "Windows/eos_Windows.h"
+#endif
 
 #if _WIN64
 #define STEAM_SDK_DLL_NAME "steam_api64.dll"
 #elif _WIN32
 #define STEAM_SDK_DLL_NAME "steam_api.dll"
+#elif PLATFORM_LINUX
+#define STEAM_SDK_DLL_NAME "libsteam_api.so"
+#endif
+
+// On Windows these come from the project's preprocessor definitions.
+#if PLATFORM_LINUX
+#ifndef SDK_DLL_NAME
+#define SDK_DLL_NAME "libEOSSDK-Linux-Shipping.so"
+#endif
+#ifndef CONFIG_DIRECTORY
+#define CONFIG_DIRECTORY "../../StreamingAssets/EOS/"
+#endif
 #endif
 
 #define SHOW_DIALOG_BOX_ON_WARN 0
-#define ENABLE_DLL_BASED_EOS_CONFIG 1
 #define XAUDIO2_DLL_NAME "xaudio2_9redist.dll"
 
 #define EOS_WINDOWS_CONFIG_FILENAME "eos_windows_config.json"
+#define EOS_LINUX_CONFIG_FILENAME "eos_linux_config.json"
 #define EOS_PRODUCT_CONFIG_FILENAME "eos_product_config.json"
 
 #define EOS_STEAM_CONFIG_FILENAME "eos_steam_config.json"
 #define EOS_LOGLEVEL_CONFIG_FILENAME "log_level_config.json"
+#define EOS_CONFIG_BLOB_FILENAME "eos_config.bin"
+
+#define FLIGHT_RECORDER_FILENAME "gfx_flight_recorder.bin"
 
 //#define RESTRICT __restrict
 
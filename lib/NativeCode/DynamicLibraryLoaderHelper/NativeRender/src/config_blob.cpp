@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "config_blob.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "io_helpers.h"
+
+namespace pew::eos::config_blob
+{
+    /**
+     * @brief Alignment of everything appended to the blob. Large enough for
+     * every field type used by the records.
+     */
+    constexpr size_t BLOB_ALIGNMENT = 8;
+
+    uint64_t hash_contents(std::string_view contents)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char character : contents)
+        {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    BlobWriter::BlobWriter() :
+        _buffer(sizeof(BlobHeader), '\0')
+    {
+    }
+
+    uint32_t BlobWriter::append(const void* data, size_t size)
+    {
+        const size_t offset = (_buffer.size() + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+        _buffer.resize(offset + size, '\0');
+        if (size != 0)
+        {
+            memcpy(_buffer.data() + offset, data, size);
+        }
+        return static_cast<uint32_t>(offset);
+    }
+
+    BlobString BlobWriter::add_string(std::string_view value)
+    {
+        // Append the null terminator along with the string, so that strings
+        // can be used as C strings straight from the mapping.
+        const uint32_t offset = append(value.data(), value.size());
+        _buffer.push_back('\0');
+        return { offset, static_cast<uint32_t>(value.size()) };
+    }
+
+    BlobArray BlobWriter::add_strings(const std::vector<std::string>& values)
+    {
+        std::vector<BlobString> strings;
+        strings.reserve(values.size());
+        for (const std::string& value : values)
+        {
+            strings.push_back(add_string(value));
+        }
+        return add_array(strings);
+    }
+
+    void BlobWriter::add_section(const std::string& source_name, std::string_view source_contents, const void* record, size_t record_size)
+    {
+        BlobSection section = {};
+        section.source_name = add_string(source_name);
+        section.record_offset = append(record, record_size);
+        section.record_size = static_cast<uint32_t>(record_size);
+        section.source_size = source_contents.size();
+        section.source_hash = hash_contents(source_contents);
+        _sections.push_back(section);
+    }
+
+    std::vector<char> BlobWriter::finish()
+    {
+        BlobHeader header = {};
+        memcpy(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+        header.version = BLOB_VERSION;
+        header.section_count = static_cast<uint32_t>(_sections.size());
+        header.section_table_offset = append(_sections.data(), sizeof(BlobSection) * _sections.size());
+        header.total_size = static_cast<uint32_t>(_buffer.size());
+        memcpy(_buffer.data(), &header, sizeof(header));
+
+        return std::move(_buffer);
+    }
+
+    Section::Section(const char* blob, size_t blob_size, const BlobSection& section) :
+        _blob(blob),
+        _blob_size(blob_size),
+        _section(section)
+    {
+    }
+
+    std::string_view Section::get_string(const BlobString& value) const
+    {
+        // The extra character accounts for the null terminator.
+        const char* characters = get<char>(value.offset, static_cast<uint64_t>(value.length) + 1);
+        return (characters == nullptr) ? std::string_view() : std::string_view(characters, value.length);
+    }
+
+    std::vector<std::string> Section::get_strings(const BlobArray& value) const
+    {
+        std::vector<std::string> strings;
+        for (const BlobString& string : get_array<BlobString>(value))
+        {
+            strings.emplace_back(get_string(string));
+        }
+        return strings;
+    }
+
+    bool Section::is_current(const std::filesystem::path& source_path) const
+    {
+        std::error_code error;
+        const auto source_size = std::filesystem::file_size(source_path, error);
+        if (error)
+        {
+            return !std::filesystem::exists(source_path, error);
+        }
+
+        // Comparing the size first avoids reading the file in the common case
+        // where an edit changed its length.
+        if (source_size != _section.source_size)
+        {
+            return false;
+        }
+
+        io_helpers::FileView source;
+        return source.open(source_path) && hash_contents(source.contents()) == _section.source_hash;
+    }
+
+    /**
+     * @brief A config blob shared by open_shared, along with the stamp of the
+     * file it was mapped from.
+     */
+    struct SharedBlob
+    {
+        io_helpers::FileStamp stamp;
+        std::shared_ptr<const ConfigBlob> blob;
+    };
+
+    std::mutex s_shared_blobs_mutex;
+    std::map<std::filesystem::path, SharedBlob> s_shared_blobs;
+
+    std::shared_ptr<const ConfigBlob> ConfigBlob::open_shared(const std::filesystem::path& path)
+    {
+        std::lock_guard lock(s_shared_blobs_mutex);
+
+        // A missing or invalid blob is remembered as well, so that it is only
+        // looked for again once the file changes.
+        const io_helpers::FileStamp stamp = io_helpers::get_file_stamp(path);
+        const auto existing = s_shared_blobs.find(path);
+        if (existing != s_shared_blobs.end() && existing->second.stamp == stamp)
+        {
+            return existing->second.blob;
+        }
+
+        auto blob = std::make_shared<ConfigBlob>();
+        if (!stamp.exists || !blob->open(path))
+        {
+            blob = nullptr;
+        }
+        s_shared_blobs[path] = SharedBlob{ stamp, blob };
+
+        return blob;
+    }
+
+    void ConfigBlob::release_shared(const std::filesystem::path& path)
+    {
+        std::lock_guard lock(s_shared_blobs_mutex);
+        s_shared_blobs.erase(path);
+    }
+
+    bool ConfigBlob::open(const std::filesystem::path& path)
+    {
+        if (!_view.open(path) || _view.size() < sizeof(BlobHeader))
+        {
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const BlobHeader*>(_view.data());
+        if (memcmp(header->magic, BLOB_MAGIC, sizeof(BLOB_MAGIC)) != 0
+            || header->version != BLOB_VERSION
+            || header->total_size != _view.size()
+            || header->section_table_offset % alignof(BlobSection) != 0
+            || static_cast<uint64_t>(header->section_table_offset) + static_cast<uint64_t>(header->section_count) * sizeof(BlobSection) > _view.size())
+        {
+            return false;
+        }
+
+        _header = header;
+        return true;
+    }
+
+    std::unique_ptr<Section> ConfigBlob::find_section(std::string_view source_name) const
+    {
+        const auto* sections = reinterpret_cast<const BlobSection*>(_view.data() + _header->section_table_offset);
+        for (uint32_t index = 0; index < _header->section_count; ++index)
+        {
+            auto section = std::make_unique<Section>(_view.data(), _view.size(), sections[index]);
+            if (section->get_string(sections[index].source_name) == source_name)
+            {
+                return section;
+            }
+        }
+        return nullptr;
+    }
+}
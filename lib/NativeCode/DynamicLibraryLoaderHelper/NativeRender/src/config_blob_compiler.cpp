@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "config_blob.h"
+
+#include <fstream>
+
+#include "config_legacy.h"
+#include "logging.h"
+#include "Config/NativePlatformConfig.hpp"
+#include "Config/ProductConfig.hpp"
+#include "Config/SteamConfig.hpp"
+
+namespace pew::eos::config_blob
+{
+    /**
+     * @brief Adds the log level config, which is still read through the legacy
+     * config functions, to the blob.
+     */
+    static bool compile_log_level_config(BlobWriter& writer)
+    {
+        const auto config_path = config_legacy::get_path_for_eos_service_config(EOS_LOGLEVEL_CONFIG_FILENAME);
+
+        io_helpers::FileView source;
+        if (!source.open(config_path))
+        {
+            return false;
+        }
+
+        const config_legacy::LogLevelConfig log_config = config_legacy::log_config_from_json(source.contents());
+
+        config_legacy::log_config_to_blob(writer, source.contents(), log_config);
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_CompileConfigBlob(const char* output_path)
+    {
+        if (output_path == nullptr)
+        {
+            return false;
+        }
+
+        BlobWriter writer;
+
+        const auto log_compiled = [](const char* file_name, bool compiled)
+        {
+            logging::log_inform(std::string(file_name) + (compiled ? " added to the config blob." : " not found, not added to the config blob."));
+        };
+
+        log_compiled(EOS_PRODUCT_CONFIG_FILENAME, config::Config::compile_to_blob<config::ProductConfig>(writer));
+#if PLATFORM_WINDOWS
+        log_compiled(EOS_WINDOWS_CONFIG_FILENAME, config::Config::compile_to_blob<config::WindowsConfig>(writer));
+#elif PLATFORM_LINUX
+        log_compiled(EOS_LINUX_CONFIG_FILENAME, config::Config::compile_to_blob<config::LinuxConfig>(writer));
+#endif
+        log_compiled(EOS_STEAM_CONFIG_FILENAME, config::Config::compile_to_blob<config::SteamConfig>(writer));
+        log_compiled(EOS_LOGLEVEL_CONFIG_FILENAME, compile_log_level_config(writer));
+
+        const std::vector<char> blob = writer.finish();
+
+        // The blob is written next to the output and then moved over it, so
+        // that the file a running plugin has mapped is never truncated.
+        const std::filesystem::path path = std::filesystem::u8path(output_path);
+        std::filesystem::path temporary_path = path;
+        temporary_path += ".tmp";
+
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+            file.close();
+            if (!file)
+            {
+                logging::log_error(std::string("Failed to write the config blob to \"") + temporary_path.u8string() + "\".");
+                std::error_code error;
+                std::filesystem::remove(temporary_path, error);
+                return false;
+            }
+        }
+
+        // The mapping has to be released before the file can be replaced on
+        // Windows.
+        ConfigBlob::release_shared(path);
+
+        std::error_code error;
+        std::filesystem::rename(temporary_path, path, error);
+        if (error)
+        {
+            logging::log_error(std::string("Failed to write the config blob to \"") + output_path + "\": " + error.message());
+            std::filesystem::remove(temporary_path, error);
+            return false;
+        }
+
+        return true;
+    }
+}
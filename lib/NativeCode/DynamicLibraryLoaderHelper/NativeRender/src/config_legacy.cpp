@@ -25,6 +25,7 @@
 #include "eos_library_helpers.h"
 #include "io_helpers.h"
 #include "json_helpers.h"
+#include "json_reader.h"
 #include "logging.h"
 
 using namespace pew::eos::config_legacy;
@@ -32,11 +33,6 @@ using namespace pew::eos::json_helpers;
 
 namespace pew::eos::config_legacy
 {
-    /**
-     * \brief Function that gets the config as a JSON string.
-     */
-    static GetConfigAsJSONString_t GetConfigAsJSONString;
-
     bool EOSSteamConfig::is_managed_by_application() const
     {
         return static_cast<std::underlying_type_t<EOS_EIntegratedPlatformManagementFlags>>(flags &
@@ -49,41 +45,108 @@ namespace pew::eos::config_legacy
             EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedBySDK);
     }
 
-    LogLevelConfig log_config_from_json_value(json_value_s* config_json)
+    LogLevelConfig log_config_from_json(std::string_view json_content)
     {
-        json_object_s* config_json_object = json_value_as_object(config_json);
-        json_object_element_s* iter = config_json_object->start;
         LogLevelConfig log_config;
 
-        while (iter != nullptr)
+        JsonReader reader(json_content);
+        if (reader.begin_object())
         {
-            if (!strcmp("LogCategoryLevelPairs", iter->name->string))
+            std::string_view name;
+            while (reader.next_member(name))
             {
-                json_array_s* pairs = json_value_as_array(iter->value);
-                for (auto e = pairs->start; e != nullptr; e = e->next)
+                if (name != "LogCategoryLevelPairs" || !reader.begin_array())
+                {
+                    reader.skip_value();
+                    continue;
+                }
+
+                while (reader.next_element())
                 {
-                    json_object_s* pairs_json_object = json_value_as_object(e->value);
-                    json_object_element_s* pairs_iter = pairs_json_object->start;
-                    while (pairs_iter != nullptr)
+                    if (!reader.begin_object())
                     {
-                        if (!strcmp("Category", pairs_iter->name->string))
+                        reader.skip_value();
+                        continue;
+                    }
+
+                    std::string_view pair_name;
+                    while (reader.next_member(pair_name))
+                    {
+                        std::vector<std::string>* values = nullptr;
+                        if (pair_name == "Category")
                         {
-                            log_config.category.push_back(json_value_as_string(pairs_iter->value)->string);
+                            values = &log_config.category;
                         }
-                        else if (!strcmp("Level", pairs_iter->name->string))
+                        else if (pair_name == "Level")
                         {
-                            log_config.level.push_back(json_value_as_string(pairs_iter->value)->string);
+                            values = &log_config.level;
+                        }
+
+                        std::string value;
+                        if (values != nullptr && reader.read_string(value))
+                        {
+                            values->push_back(std::move(value));
+                        }
+                        else
+                        {
+                            reader.skip_value();
                         }
-                        pairs_iter = pairs_iter->next;
                     }
                 }
             }
-            iter = iter->next;
+        }
+
+        if (!reader.finish())
+        {
+            logging::log_warn("Failed to parse the log level config (at offset " + std::to_string(reader.offset()) + ").");
+            return {};
         }
 
         return log_config;
     }
 
+    /**
+     * \brief Reads the log level config from the section of the config blob
+     * that was compiled from the given config file, if the section is still
+     * current.
+     * \param config_path The path to the log level config file.
+     * \param log_config Receives the log level config.
+     * \return True if the config was read, false if the config file needs to
+     * be parsed instead.
+     */
+    bool log_config_from_blob(const std::filesystem::path& config_path, LogLevelConfig& log_config)
+    {
+        const auto blob = config_blob::ConfigBlob::open_shared(get_path_for_eos_service_config(EOS_CONFIG_BLOB_FILENAME));
+        if (blob == nullptr)
+        {
+            return false;
+        }
+
+        const auto section = blob->find_section(config_path.filename().string());
+        if (section == nullptr || !section->is_current(config_path))
+        {
+            return false;
+        }
+
+        const auto record = section->get_record<config_blob::LogLevelConfigRecord>();
+        if (record == nullptr)
+        {
+            return false;
+        }
+
+        log_config.category = section->get_strings(record->categories);
+        log_config.level = section->get_strings(record->levels);
+        return true;
+    }
+
+    void log_config_to_blob(config_blob::BlobWriter& writer, std::string_view source_contents, const LogLevelConfig& log_config)
+    {
+        config_blob::LogLevelConfigRecord record = {};
+        record.categories = writer.add_strings(log_config.category);
+        record.levels = writer.add_strings(log_config.level);
+        writer.add_section(EOS_LOGLEVEL_CONFIG_FILENAME, source_contents, record);
+    }
+
     /**
      * \brief Gets the fully-qualified path to a config file. Uses
      * CONFIG_DIRECTORY in concert with the determined path of the current
@@ -103,40 +166,6 @@ namespace pew::eos::config_legacy
         return absolute(config_file_path_relative_to_module);
     }
 
-    json_value_s* read_config_json_from_dll()
-    {
-        json_value_s* config_json = nullptr;
-
-#if ENABLE_DLL_BASED_EOS_CONFIG
-        logging::log_inform("Trying to load eos config via dll");
-        static void* eos_generated_library_handle = eos_library_helpers::load_library_at_path(io_helpers::get_path_relative_to_current_module("EOSGenerated.dll"));
-
-        if (!eos_generated_library_handle)
-        {
-            logging::log_warn("No Generated DLL found (Might not be an error)");
-            return NULL;
-        }
-
-        GetConfigAsJSONString = eos_library_helpers::load_function_with_name<GetConfigAsJSONString_t>(eos_generated_library_handle, "GetConfigAsJSONString");
-
-        if (GetConfigAsJSONString)
-        {
-            const char* config_as_json_string = GetConfigAsJSONString();
-            if (config_as_json_string != nullptr)
-            {
-                size_t config_as_json_string_length = strlen(config_as_json_string);
-                config_json = json_parse(config_as_json_string, config_as_json_string_length);
-            }
-        }
-        else
-        {
-            logging::log_warn("No function found");
-        }
-#endif
-
-        return config_json;
-    }
-
     EOS_EIntegratedPlatformManagementFlags eos_collect_integrated_platform_management_flags(json_object_element_s* iter)
     {
         return json_helpers::collect_flags<EOS_EIntegratedPlatformManagementFlags>(
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "config_snapshot.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpu_topology.h"
+#include "logging.h"
+#include "Config/NativePlatformConfig.hpp"
+#include "Config/ProductConfig.hpp"
+
+namespace pew::eos::config_snapshot
+{
+    /**
+     * @brief Collects the strings of a snapshot, which are stored after the
+     * ConfigSnapshot itself.
+     */
+    class StringArena
+    {
+    public:
+        ConfigSnapshotString add(const std::string& value)
+        {
+            const ConfigSnapshotString added = {
+                static_cast<uint32_t>(sizeof(ConfigSnapshot) + _contents.size()),
+                static_cast<uint32_t>(value.size())
+            };
+
+            _contents.append(value);
+            _contents.push_back('\0');
+            return added;
+        }
+
+        const std::string& contents() const { return _contents; }
+
+    private:
+        std::string _contents;
+    };
+
+    static std::mutex s_snapshot_mutex;
+
+    // The configs the current snapshot was built from, to tell when either
+    // has been reloaded.
+    static std::shared_ptr<const config::ProductConfig> s_product_config;
+    static std::shared_ptr<const config::NativePlatformConfig> s_platform_config;
+
+    // Stored as 64-bit words so that the snapshot is suitably aligned.
+    static std::vector<uint64_t> s_snapshot;
+
+    static void build_snapshot(const config::ProductConfig& product_config, const config::PlatformConfig& platform_config)
+    {
+        ConfigSnapshot snapshot = {};
+        StringArena strings;
+
+        snapshot.version = CONFIG_SNAPSHOT_VERSION;
+        snapshot.product_name = strings.add(product_config.product_name);
+        snapshot.product_version = strings.add(product_config.product_version);
+        snapshot.product_id = strings.add(product_config.product_id);
+        snapshot.sandbox_id = strings.add(platform_config.deployment.sandbox.id);
+        snapshot.deployment_id = strings.add(platform_config.deployment.id);
+        snapshot.client_id = strings.add(platform_config.client_credentials.client_id);
+        snapshot.client_secret = strings.add(platform_config.client_credentials.client_secret);
+        snapshot.encryption_key = strings.add(platform_config.client_credentials.encryption_key);
+        snapshot.cache_directory = strings.add(platform_config.get_cache_directory());
+        snapshot.override_country_code = strings.add(platform_config.overrideCountryCode);
+        snapshot.override_locale_code = strings.add(platform_config.overrideLocaleCode);
+
+        snapshot.is_server = platform_config.is_server ? 1 : 0;
+        snapshot.platform_options_flags = platform_config.platform_options_flags;
+        snapshot.auth_scope_flags = static_cast<int32_t>(platform_config.auth_scope_flags);
+        snapshot.integrated_platform_management_flags = static_cast<int32_t>(platform_config.integrated_platform_management_flags);
+        snapshot.tick_budget_in_milliseconds = platform_config.tick_budget_in_milliseconds;
+        snapshot.task_network_timeout_seconds = platform_config.task_network_timeout_seconds;
+
+        // Matches what get_initialize_options hands to the SDK.
+        EOS_Initialize_ThreadAffinity thread_affinity = platform_config.thread_affinity;
+        if (platform_config.auto_thread_affinity)
+        {
+            cpu_topology::apply_auto_thread_affinity(thread_affinity);
+        }
+        snapshot.has_thread_affinity = 1;
+        snapshot.thread_affinity[0] = thread_affinity.NetworkWork;
+        snapshot.thread_affinity[1] = thread_affinity.StorageIo;
+        snapshot.thread_affinity[2] = thread_affinity.WebSocketIo;
+        snapshot.thread_affinity[3] = thread_affinity.P2PIo;
+        snapshot.thread_affinity[4] = thread_affinity.HttpRequestIo;
+        snapshot.thread_affinity[5] = thread_affinity.RTCIo;
+        snapshot.thread_affinity[6] = thread_affinity.EmbeddedOverlayMainThread;
+        snapshot.thread_affinity[7] = thread_affinity.EmbeddedOverlayWorkerThreads;
+
+        snapshot.always_send_input_to_overlay = platform_config.always_send_input_to_overlay ? 1 : 0;
+        snapshot.initial_button_delay_for_overlay = platform_config.initial_button_delay_for_overlay;
+        snapshot.repeat_button_delay_for_overlay = platform_config.repeat_button_delay_for_overlay;
+        snapshot.toggle_friends_button_combination = static_cast<int32_t>(platform_config.toggle_friends_button_combination);
+
+        const std::string& contents = strings.contents();
+        snapshot.total_size = static_cast<uint32_t>(sizeof(ConfigSnapshot) + contents.size());
+
+        s_snapshot.assign((snapshot.total_size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+        char* const destination = reinterpret_cast<char*>(s_snapshot.data());
+        memcpy(destination, &snapshot, sizeof(ConfigSnapshot));
+        memcpy(destination + sizeof(ConfigSnapshot), contents.data(), contents.size());
+    }
+
+    bool is_valid(const ConfigSnapshot* snapshot)
+    {
+        if (snapshot == nullptr || snapshot->version != CONFIG_SNAPSHOT_VERSION || snapshot->total_size < sizeof(ConfigSnapshot))
+        {
+            return false;
+        }
+
+        const char* const contents = reinterpret_cast<const char*>(snapshot);
+        for (const ConfigSnapshotString& value : {
+            snapshot->product_name, snapshot->product_version, snapshot->product_id,
+            snapshot->sandbox_id, snapshot->deployment_id, snapshot->client_id,
+            snapshot->client_secret, snapshot->encryption_key, snapshot->cache_directory,
+            snapshot->override_country_code, snapshot->override_locale_code })
+        {
+            if (value.offset < sizeof(ConfigSnapshot)
+                || value.offset >= snapshot->total_size
+                || value.length >= snapshot->total_size - value.offset
+                || contents[value.offset + value.length] != '\0')
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string_view get_string(const ConfigSnapshot& snapshot, ConfigSnapshotString value)
+    {
+        return std::string_view(reinterpret_cast<const char*>(&snapshot) + value.offset, value.length);
+    }
+
+    PEW_EOS_API_FUNC(const ConfigSnapshot*) PEW_EOS_GetConfigSnapshot()
+    {
+        const auto product_config = config::Config::get<config::ProductConfig>();
+        const auto platform_config = config::Config::get<config::NativePlatformConfig>();
+        if (product_config == nullptr || platform_config == nullptr)
+        {
+            logging::log_error("Could not read the configs for the config snapshot.");
+            return nullptr;
+        }
+
+        std::lock_guard lock(s_snapshot_mutex);
+        if (s_snapshot.empty() || product_config != s_product_config || platform_config != s_platform_config)
+        {
+            build_snapshot(*product_config, *platform_config);
+            s_product_config = product_config;
+            s_platform_config = platform_config;
+        }
+
+        return reinterpret_cast<const ConfigSnapshot*>(s_snapshot.data());
+    }
+}
@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "config_watcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging.h"
+#include "string_helpers.h"
+
+#if !PLATFORM_WINDOWS
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace pew::eos::config_watcher
+{
+    /**
+     * @brief How long a file has to stay unchanged before the change is
+     * reported.
+     */
+    constexpr std::chrono::milliseconds DEBOUNCE_INTERVAL(250);
+
+    /**
+     * @brief Watches a single directory for changes on a thread of its own.
+     */
+    class DirectoryWatch
+    {
+    public:
+        explicit DirectoryWatch(std::filesystem::path directory);
+        ~DirectoryWatch();
+
+        DirectoryWatch(const DirectoryWatch&) = delete;
+        DirectoryWatch& operator=(const DirectoryWatch&) = delete;
+
+        /**
+         * @brief Starts watching the directory.
+         * @return `true` if the directory is being watched, `false` otherwise.
+         */
+        bool start();
+
+        const std::filesystem::path& get_directory() const { return _directory; }
+
+    private:
+        enum class WaitResult
+        {
+            Changed,
+            TimedOut,
+            Stopped
+        };
+
+        void run();
+
+        /**
+         * @brief Waits until files in the directory change, the timeout
+         * expires, or the watch is stopped.
+         *
+         * @param timeout How long to wait for, or a negative duration to wait
+         * without a timeout.
+         * @param changed_file_names Receives the names of the files that
+         * changed.
+         * @param all_changed Set if changes were lost, in which case every
+         * file has to be treated as changed.
+         */
+        WaitResult wait_for_changes(std::chrono::milliseconds timeout, std::set<std::string>& changed_file_names, bool& all_changed);
+
+        void close_handles();
+
+        std::filesystem::path _directory;
+        std::thread _thread;
+
+#if PLATFORM_WINDOWS
+        HANDLE _directory_handle = INVALID_HANDLE_VALUE;
+        HANDLE _changed_event = nullptr;
+        HANDLE _stop_event = nullptr;
+        OVERLAPPED _overlapped = {};
+        bool _read_pending = false;
+
+        // ReadDirectoryChangesW requires a DWORD-aligned buffer.
+        std::vector<DWORD> _buffer = std::vector<DWORD>(16 * 1024 / sizeof(DWORD));
+
+        bool begin_read();
+#else
+        int _inotify = -1;
+        int _stop_event = -1;
+#endif
+    };
+
+    struct Subscription
+    {
+        SubscriptionId id;
+        std::filesystem::path directory;
+        std::string file_name;
+        ChangeHandler handler;
+    };
+
+    static std::mutex s_mutex;
+    static std::vector<std::unique_ptr<DirectoryWatch>> s_watches;
+    static std::vector<Subscription> s_subscriptions;
+    static SubscriptionId s_next_subscription_id = 1;
+
+    /**
+     * @brief Calls the handlers of the subscriptions to the given files.
+     */
+    static void dispatch(const std::filesystem::path& directory, const std::set<std::string>& changed_file_names, bool all_changed)
+    {
+        // Handlers are copied so that they run without the lock held, which
+        // lets them subscribe and unsubscribe.
+        std::vector<Subscription> subscriptions;
+        {
+            std::lock_guard lock(s_mutex);
+            for (const auto& subscription : s_subscriptions)
+            {
+                if (subscription.directory == directory && (all_changed || changed_file_names.count(subscription.file_name) != 0))
+                {
+                    subscriptions.push_back(subscription);
+                }
+            }
+        }
+
+        for (const auto& subscription : subscriptions)
+        {
+            const auto file_path = directory / subscription.file_name;
+
+            // A file that is deleted and then recreated is reported once it
+            // exists again.
+            std::error_code error;
+            if (!std::filesystem::exists(file_path, error))
+            {
+                continue;
+            }
+
+            logging::log_inform("Config file \"" + string_helpers::to_utf8_str(file_path) + "\" changed.");
+
+            try
+            {
+                subscription.handler();
+            }
+            catch (const std::exception& exception)
+            {
+                logging::log_error("Failed to apply the changes to \"" + string_helpers::to_utf8_str(file_path) + "\": " + exception.what());
+            }
+        }
+    }
+
+    DirectoryWatch::DirectoryWatch(std::filesystem::path directory) :
+        _directory(std::move(directory))
+    {
+    }
+
+    DirectoryWatch::~DirectoryWatch()
+    {
+        if (_thread.joinable())
+        {
+#if PLATFORM_WINDOWS
+            SetEvent(_stop_event);
+#else
+            const uint64_t stop = 1;
+            (void)write(_stop_event, &stop, sizeof(stop));
+#endif
+            _thread.join();
+        }
+
+        close_handles();
+    }
+
+    void DirectoryWatch::run()
+    {
+        std::set<std::string> pending_file_names;
+        bool all_pending = false;
+        auto report_time = std::chrono::steady_clock::time_point::max();
+
+        while (true)
+        {
+            auto timeout = std::chrono::milliseconds(-1);
+            if (!pending_file_names.empty() || all_pending)
+            {
+                timeout = std::max(std::chrono::milliseconds(0),
+                    std::chrono::duration_cast<std::chrono::milliseconds>(report_time - std::chrono::steady_clock::now()));
+            }
+
+            const WaitResult result = wait_for_changes(timeout, pending_file_names, all_pending);
+            if (result == WaitResult::Stopped)
+            {
+                break;
+            }
+
+            if (result == WaitResult::Changed)
+            {
+                // Every change restarts the interval, so that a file that is
+                // still being written is not read half-way through.
+                report_time = std::chrono::steady_clock::now() + DEBOUNCE_INTERVAL;
+                continue;
+            }
+
+            dispatch(_directory, pending_file_names, all_pending);
+            pending_file_names.clear();
+            all_pending = false;
+        }
+    }
+
+#if PLATFORM_WINDOWS
+    bool DirectoryWatch::start()
+    {
+        _directory_handle = CreateFileW(_directory.wstring().c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        _changed_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        _stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+        if (_directory_handle == INVALID_HANDLE_VALUE || _changed_event == nullptr || _stop_event == nullptr || !begin_read())
+        {
+            close_handles();
+            return false;
+        }
+
+        _thread = std::thread(&DirectoryWatch::run, this);
+        return true;
+    }
+
+    bool DirectoryWatch::begin_read()
+    {
+        ResetEvent(_changed_event);
+        _overlapped = {};
+        _overlapped.hEvent = _changed_event;
+
+        constexpr DWORD notify_filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        _read_pending = ReadDirectoryChangesW(_directory_handle, _buffer.data(), static_cast<DWORD>(_buffer.size() * sizeof(DWORD)),
+            FALSE, notify_filter, nullptr, &_overlapped, nullptr) != FALSE;
+        return _read_pending;
+    }
+
+    DirectoryWatch::WaitResult DirectoryWatch::wait_for_changes(std::chrono::milliseconds timeout, std::set<std::string>& changed_file_names, bool& all_changed)
+    {
+        const HANDLE events[] = { _stop_event, _changed_event };
+        const DWORD wait_time = (timeout.count() < 0) ? INFINITE : static_cast<DWORD>(timeout.count());
+
+        const DWORD wait_result = WaitForMultipleObjects(2, events, FALSE, wait_time);
+        if (wait_result == WAIT_TIMEOUT)
+        {
+            return WaitResult::TimedOut;
+        }
+        if (wait_result != WAIT_OBJECT_0 + 1)
+        {
+            return WaitResult::Stopped;
+        }
+
+        DWORD bytes_returned = 0;
+        _read_pending = false;
+        if (!GetOverlappedResult(_directory_handle, &_overlapped, &bytes_returned, FALSE))
+        {
+            logging::log_error("Stopped watching config directory \"" + string_helpers::to_utf8_str(_directory) + "\".");
+            return WaitResult::Stopped;
+        }
+
+        if (bytes_returned == 0)
+        {
+            // The buffer overflowed, so the names of the changed files are
+            // not known.
+            all_changed = true;
+        }
+        else
+        {
+            const auto* buffer = reinterpret_cast<const char*>(_buffer.data());
+            for (DWORD offset = 0;;)
+            {
+                const auto* notification = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + offset);
+                const std::wstring file_name(notification->FileName, notification->FileNameLength / sizeof(WCHAR));
+                changed_file_names.insert(string_helpers::to_utf8_str(file_name));
+
+                if (notification->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                offset += notification->NextEntryOffset;
+            }
+        }
+
+        if (!begin_read())
+        {
+            logging::log_error("Stopped watching config directory \"" + string_helpers::to_utf8_str(_directory) + "\".");
+            return WaitResult::Stopped;
+        }
+
+        return WaitResult::Changed;
+    }
+
+    void DirectoryWatch::close_handles()
+    {
+        if (_directory_handle != INVALID_HANDLE_VALUE)
+        {
+            // The pending read writes to the buffer, so it has to be finished
+            // before the buffer goes away.
+            if (_read_pending)
+            {
+                DWORD bytes_returned = 0;
+                CancelIoEx(_directory_handle, &_overlapped);
+                GetOverlappedResult(_directory_handle, &_overlapped, &bytes_returned, TRUE);
+                _read_pending = false;
+            }
+            CloseHandle(_directory_handle);
+            _directory_handle = INVALID_HANDLE_VALUE;
+        }
+        if (_changed_event != nullptr)
+        {
+            CloseHandle(_changed_event);
+            _changed_event = nullptr;
+        }
+        if (_stop_event != nullptr)
+        {
+            CloseHandle(_stop_event);
+            _stop_event = nullptr;
+        }
+    }
+#else
+    bool DirectoryWatch::start()
+    {
+        _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        _stop_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        // Files saved in place are reported by IN_CLOSE_WRITE, and files
+        // saved by replacing them by IN_MOVED_TO.
+        constexpr uint32_t event_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+        if (_inotify < 0 || _stop_event < 0 || inotify_add_watch(_inotify, _directory.c_str(), event_mask) < 0)
+        {
+            close_handles();
+            return false;
+        }
+
+        _thread = std::thread(&DirectoryWatch::run, this);
+        return true;
+    }
+
+    DirectoryWatch::WaitResult DirectoryWatch::wait_for_changes(std::chrono::milliseconds timeout, std::set<std::string>& changed_file_names, bool& all_changed)
+    {
+        pollfd descriptors[] = { { _stop_event, POLLIN, 0 }, { _inotify, POLLIN, 0 } };
+
+        const int poll_result = poll(descriptors, 2, static_cast<int>(timeout.count()));
+        if (poll_result == 0)
+        {
+            return WaitResult::TimedOut;
+        }
+        if (poll_result < 0)
+        {
+            return (errno == EINTR) ? WaitResult::Changed : WaitResult::Stopped;
+        }
+        if (descriptors[0].revents != 0)
+        {
+            return WaitResult::Stopped;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t bytes_read;
+        while ((bytes_read = read(_inotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (ssize_t offset = 0; offset < bytes_read;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
+                {
+                    all_changed = true;
+                }
+                else if (event->len != 0)
+                {
+                    changed_file_names.insert(event->name);
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+
+        return WaitResult::Changed;
+    }
+
+    void DirectoryWatch::close_handles()
+    {
+        if (_inotify >= 0)
+        {
+            ::close(_inotify);
+            _inotify = -1;
+        }
+        if (_stop_event >= 0)
+        {
+            ::close(_stop_event);
+            _stop_event = -1;
+        }
+    }
+#endif
+
+    SubscriptionId subscribe(const std::filesystem::path& file_path, ChangeHandler handler)
+    {
+        const auto absolute_path = std::filesystem::absolute(file_path).lexically_normal();
+        const auto directory = absolute_path.parent_path();
+
+        std::lock_guard lock(s_mutex);
+
+        const bool is_watched = std::any_of(s_watches.begin(), s_watches.end(), [&directory](const auto& watch)
+        {
+            return watch->get_directory() == directory;
+        });
+
+        if (!is_watched)
+        {
+            auto watch = std::make_unique<DirectoryWatch>(directory);
+            if (!watch->start())
+            {
+                logging::log_warn("Unable to watch config directory \"" + string_helpers::to_utf8_str(directory) + "\" for changes.");
+                return 0;
+            }
+            s_watches.push_back(std::move(watch));
+        }
+
+        const SubscriptionId subscription_id = s_next_subscription_id++;
+        s_subscriptions.push_back({ subscription_id, directory, string_helpers::to_utf8_str(absolute_path.filename()), std::move(handler) });
+        return subscription_id;
+    }
+
+    void unsubscribe(SubscriptionId subscription_id)
+    {
+        std::lock_guard lock(s_mutex);
+
+        s_subscriptions.erase(std::remove_if(s_subscriptions.begin(), s_subscriptions.end(), [subscription_id](const Subscription& subscription)
+        {
+            return subscription.id == subscription_id;
+        }), s_subscriptions.end());
+    }
+
+    void stop()
+    {
+        std::vector<std::unique_ptr<DirectoryWatch>> watches;
+        {
+            std::lock_guard lock(s_mutex);
+            watches.swap(s_watches);
+            s_subscriptions.clear();
+        }
+
+        // The watches are destroyed (and their threads joined) without the
+        // lock held, since a thread that is dispatching needs the lock.
+        watches.clear();
+    }
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "logging.h"
+
+#if PLATFORM_LINUX
+#include <fstream>
+#include <sched.h>
+#endif
+
+namespace pew::eos::cpu_topology
+{
+    /**
+     * @brief Formats an affinity mask for the log.
+     */
+    static std::string to_hex_string(uint64_t mask)
+    {
+        char buffer[19];
+        snprintf(buffer, sizeof(buffer), "0x%" PRIx64, mask);
+        return buffer;
+    }
+
+#if PLATFORM_WINDOWS
+    std::vector<uint64_t> get_physical_cores()
+    {
+        DWORD buffer_size = 0;
+        GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &buffer_size);
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+        {
+            return {};
+        }
+
+        std::vector<char> buffer(buffer_size);
+        auto* const information = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+        if (!GetLogicalProcessorInformationEx(RelationProcessorCore, information, &buffer_size))
+        {
+            return {};
+        }
+
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        {
+            process_mask = ~static_cast<DWORD_PTR>(0);
+        }
+
+        std::vector<uint64_t> cores;
+        for (DWORD offset = 0; offset < buffer_size;)
+        {
+            const auto* const entry = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            offset += entry->Size;
+
+            // Masks only reach the processors of the first group.
+            const GROUP_AFFINITY& group_mask = entry->Processor.GroupMask[0];
+            if (group_mask.Group != 0)
+            {
+                continue;
+            }
+
+            const uint64_t core_mask = static_cast<uint64_t>(group_mask.Mask & process_mask);
+            if (core_mask != 0)
+            {
+                cores.push_back(core_mask);
+            }
+        }
+
+        return cores;
+    }
+#elif PLATFORM_LINUX
+    /**
+     * @brief Reads a number from a file in sysfs.
+     *
+     * @return `true` if the file held a number.
+     */
+    static bool read_sysfs_number(const std::string& path, int& value)
+    {
+        std::ifstream file(path);
+        return static_cast<bool>(file >> value);
+    }
+
+    std::vector<uint64_t> get_physical_cores()
+    {
+        cpu_set_t process_set;
+        CPU_ZERO(&process_set);
+        if (sched_getaffinity(0, sizeof(process_set), &process_set) != 0)
+        {
+            return {};
+        }
+
+        // Logical processors that share a package and core id are hardware
+        // threads of the same physical core. When the topology is not exposed
+        // (as in some containers) each processor is counted as a core.
+        std::map<std::pair<int, int>, uint64_t> cores_by_id;
+        std::vector<uint64_t> cores;
+        for (int cpu = 0; cpu < 64; ++cpu)
+        {
+            if (!CPU_ISSET(cpu, &process_set))
+            {
+                continue;
+            }
+
+            const std::string topology_path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            int package_id = 0;
+            int core_id = 0;
+            if (!read_sysfs_number(topology_path + "physical_package_id", package_id)
+                || !read_sysfs_number(topology_path + "core_id", core_id))
+            {
+                package_id = -1;
+                core_id = cpu;
+            }
+
+            cores_by_id[{ package_id, core_id }] |= uint64_t{ 1 } << cpu;
+        }
+
+        for (const auto& core : cores_by_id)
+        {
+            cores.push_back(core.second);
+        }
+
+        // Order by the lowest logical processor, which is how the cores are
+        // numbered on Windows as well.
+        std::sort(cores.begin(), cores.end(), [](uint64_t a, uint64_t b) { return (a & (~a + 1)) < (b & (~b + 1)); });
+
+        return cores;
+    }
+#else
+    std::vector<uint64_t> get_physical_cores()
+    {
+        return {};
+    }
+#endif
+
+    bool apply_auto_thread_affinity(EOS_Initialize_ThreadAffinity& thread_affinity)
+    {
+        const std::vector<uint64_t> cores = get_physical_cores();
+
+        // The EOS threads need at least one core of their own.
+        if (cores.size() <= RESERVED_GAME_CORES)
+        {
+            logging::log_inform("Automatic thread affinity: found " + std::to_string(cores.size())
+                + " physical core(s), which is too few to keep EOS threads apart from the game. Using the default thread affinity.");
+            return false;
+        }
+
+        uint64_t game_mask = 0;
+        uint64_t eos_mask = 0;
+        for (size_t index = 0; index < cores.size(); ++index)
+        {
+            (index < RESERVED_GAME_CORES ? game_mask : eos_mask) |= cores[index];
+        }
+
+        for (uint64_t EOS_Initialize_ThreadAffinity::* member : {
+            &EOS_Initialize_ThreadAffinity::NetworkWork,
+            &EOS_Initialize_ThreadAffinity::P2PIo,
+            &EOS_Initialize_ThreadAffinity::RTCIo,
+            &EOS_Initialize_ThreadAffinity::HttpRequestIo })
+        {
+            if (thread_affinity.*member == 0)
+            {
+                thread_affinity.*member = eos_mask;
+            }
+        }
+
+        logging::log_inform("Automatic thread affinity: " + std::to_string(cores.size()) + " physical cores. "
+            "Reserved for the main and render threads: " + to_hex_string(game_mask) + ", "
+            "NetworkWork: " + to_hex_string(thread_affinity.NetworkWork) + ", "
+            "P2PIo: " + to_hex_string(thread_affinity.P2PIo) + ", "
+            "RTCIo: " + to_hex_string(thread_affinity.RTCIo) + ", "
+            "HttpRequestIo: " + to_hex_string(thread_affinity.HttpRequestIo) + ".");
+
+        return true;
+    }
+}
@@ -25,96 +25,115 @@
 // This is apparently needed so that the Overlay can render properly
 #include "pch.h"
 
-#include <iterator>
-#include <sstream>
+#include <filesystem>
 #include <string>
 #include "config_legacy.h"
+#include "config_watcher.h"
+#include "flight_recorder.h"
 #include "logging.h"
+#include "notification_queue.h"
+#include "p2p_pump.h"
+#include "platform_registry.h"
+#include "tick_driver.h"
 #include <eos_library_helpers.h>
 #include <eos_helpers.h>
 #include "io_helpers.h"
 #include "Config/SteamConfig.hpp"
-#include "Config/WindowsConfig.hpp"
+#include "Config/NativePlatformConfig.hpp"
 
 using namespace pew::eos;
 using namespace pew::eos::eos_library_helpers;
 
-using FSig_ApplicationWillShutdown = void (__stdcall *)(void);
+using FSig_ApplicationWillShutdown = void (EOS_CALL *)(void);
 FSig_ApplicationWillShutdown FuncApplicationWillShutdown = nullptr;
 
-/**
- * \brief Applies any command line arguments that may have been provided.
- * \param platform_config The platform config whose values may need to be
- * overridden by command line arguments.
- * \param product_config The product config. This is used to warn the user if
- * the provided sandbox id or deployment id is not defined in the product
- * config. If they are not defined, they will still be applied.
- */
-static void apply_cli_arguments(config::PlatformConfig& platform_config, const config::ProductConfig& product_config)
-{
-    //support sandbox and deployment id override via command line arguments
-    auto argument_stream = std::stringstream(GetCommandLineA());
-    const std::istream_iterator<std::string> argument_stream_begin(argument_stream);
-    const std::istream_iterator<std::string> argument_stream_end;
-    const std::vector argument_strings(argument_stream_begin, argument_stream_end);
-
-    std::string sandbox_id_override;
-    if (io_helpers::try_get_command_line_argument(argument_strings, sandbox_id_override, "epicsandboxid", "eossandboxid"))
-    {
-        if (!product_config.environments.is_sandbox_defined(sandbox_id_override))
-        {
-            logging::log_warn(
-              "Sandbox Id \"" + sandbox_id_override + "\" was provided on the "
-              "command line, but is not found in the product config. Attempting "
-              "to use it regardless.");
-        }
-        platform_config.deployment.sandbox.id = sandbox_id_override;
-    }
-
-    std::string deployment_id_override;
-    if (io_helpers::try_get_command_line_argument(argument_strings, deployment_id_override, "eosdeploymentid", "epicdeploymentid"))
-    {
-        if (!product_config.environments.is_deployment_defined(deployment_id_override))
-        {
-            logging::log_warn(
-              "Deployment Id \"" + deployment_id_override + "\" was provided on the "
-              "command line, but is not found in the product config. Attempting "
-              "to use it regardless.");
-        }
-        platform_config.deployment.id = deployment_id_override;
-    }
-}
-
 /**
  * @brief This helper function determines whether the library is being
  *        included by the ConsoleApplication project within the solution.
  */
 bool IsConsoleApp()
 {
+#if PLATFORM_WINDOWS
     char processName[MAX_PATH] = { 0 };
     GetModuleFileNameA(NULL, processName, MAX_PATH);
     std::string name(processName);
+#else
+    std::error_code error;
+    std::string name = std::filesystem::read_symlink("/proc/self/exe", error).string();
+#endif
     // This should be set to the output target name of the ConsoleApplication 
     // project.
     return name.find("ConsoleApplication") != std::string::npos;
 }
 
-// Called by unity on load. It kicks off the work to load the DLL for Overlay
-#if PLATFORM_32BITS
-#pragma comment(linker, "/export:UnityPluginLoad=_UnityPluginLoad@4")
+/**
+ * @brief Gets the path to write the flight recorder to. The directory of the
+ *        plugin is often read-only in an installed game, so the recording
+ *        goes to the temp directory of the user instead, in a directory named
+ *        after the executable so that games do not overwrite each other's
+ *        recordings.
+ *
+ * @return The path, or an empty path if there is no writable directory.
+ */
+static std::filesystem::path get_flight_recorder_path()
+{
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        return {};
+    }
+
+#if PLATFORM_WINDOWS
+    const std::filesystem::path executable_path = io_helpers::get_path_to_module_as_string(nullptr);
+#else
+    const std::filesystem::path executable_path = std::filesystem::read_symlink("/proc/self/exe", error);
 #endif
-PEW_EOS_API_FUNC(void) UnityPluginLoad(void* arg)
+    directory /= "PlayEveryWare";
+    if (!executable_path.empty())
+    {
+        directory /= executable_path.stem();
+    }
+
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        return {};
+    }
+
+    return directory / FLIGHT_RECORDER_FILENAME;
+}
+
+/**
+ * @brief Loads the EOS SDK, initializes it and creates the default platform.
+ *
+ * @param entry_point The exported function that loads the plugin, to log.
+ * @param as_server Whether to create the platform as a server platform, even
+ * if the platform config does not say so.
+ */
+static void load_plugin(const char* entry_point, bool as_server)
 {
 #if _DEBUG
+#if PLATFORM_WINDOWS
     if (!IsDebuggerPresent() && !IsConsoleApp())
     {
         logging::show_log_as_dialog("You may attach a debugger to the DLL");
     }
+#endif
     logging::global_log_open("gfx_log.txt");
 #endif
 
+    // The flight recorder is always on; it only costs a copy per message and
+    // keeps the most recent messages around if the process crashes.
+    const std::filesystem::path flight_recorder_path = get_flight_recorder_path();
+    const bool is_recording = !flight_recorder_path.empty() && flight_recorder::open(flight_recorder_path);
+
     std::filesystem::path DllPath;
-    logging::log_inform("On UnityPluginLoad");
+    logging::log_inform(std::string("On ") + entry_point);
+    if (is_recording)
+    {
+        logging::log_inform("Recording the most recent log messages to \"" + flight_recorder_path.u8string() + "\".");
+    }
 
     // Acquire pointer to EOS SDK library
     s_eos_sdk_lib_handle = load_library_at_path(io_helpers::get_path_relative_to_current_module(SDK_DLL_NAME));
@@ -132,19 +151,26 @@ PEW_EOS_API_FUNC(void) UnityPluginLoad(void* arg)
             logging::log_inform("start eos init");
 
             const auto product_config = config::Config::get<config::ProductConfig>();
-            const auto windows_config = config::Config::get<config::WindowsConfig>();
-            
-            apply_cli_arguments(*windows_config, *product_config);
+            const auto platform_config = config::Config::get<config::NativePlatformConfig>();
 
-            eos_init(*windows_config, *product_config);
+            eos_init(*platform_config, *product_config);
             eos_set_loglevel_via_config();
-            eos_create(*windows_config, *product_config);
-
-            // Free function pointers and library handle.
+            eos_create(*platform_config, *product_config, as_server);
+
+            // Pick up changes to the config files while the platform is
+            // running.
+            config::Config::subscribe<config::NativePlatformConfig>(
+                [](const std::shared_ptr<const config::NativePlatformConfig>& previous_config, const std::shared_ptr<const config::NativePlatformConfig>& current_config)
+                {
+                    eos_platform_config_changed(*previous_config, *current_config);
+                });
+            config_watcher::subscribe(config_legacy::get_path_for_eos_service_config(EOS_LOGLEVEL_CONFIG_FILENAME), eos_set_loglevel_via_config);
+
+            // Free function pointers and library handle. Creating platforms
+            // and shutting the SDK down stay possible, for the platform
+            // registry and the shutdown.
             s_eos_sdk_lib_handle = nullptr;
             EOS_Initialize_ptr = nullptr;
-            EOS_Shutdown_ptr = nullptr;
-            EOS_Platform_Create_ptr = nullptr;
         }
         else
         {
@@ -157,12 +183,33 @@ PEW_EOS_API_FUNC(void) UnityPluginLoad(void* arg)
     }
 }
 
+// Called by unity on load. It kicks off the work to load the DLL for Overlay
+#if PLATFORM_32BITS
+#pragma comment(linker, "/export:UnityPluginLoad=_UnityPluginLoad@4")
+#endif
+PEW_EOS_API_FUNC(void) UnityPluginLoad(void* arg)
+{
+    load_plugin("UnityPluginLoad", false);
+}
+
+//-------------------------------------------------------------------------
+PEW_EOS_API_FUNC(void) PEW_EOS_LoadAsServer()
+{
+    load_plugin("PEW_EOS_LoadAsServer", true);
+}
+
 //-------------------------------------------------------------------------
 #if PLATFORM_32BITS
 #pragma comment(linker, "/export:_UnityPluginUnload=_UnityPluginUnload@0")
 #endif
 PEW_EOS_API_FUNC(void) UnityPluginUnload()
 {
+    tick_driver::stop();
+    notification_queue::remove_all();
+    p2p_pump::stop();
+    platform_registry::release_created();
+    config_watcher::stop();
+
     if (FuncApplicationWillShutdown != nullptr)
     {
         FuncApplicationWillShutdown();
@@ -171,4 +218,5 @@ PEW_EOS_API_FUNC(void) UnityPluginUnload()
     s_eos_sdk_overlay_lib_handle = nullptr;
 
     logging::global_log_close();
+    flight_recorder::close();
 }
@@ -22,30 +22,38 @@
 
 #include <pch.h>
 #include "eos_helpers.h"
+#include <algorithm>
 #include <filesystem>
 #include <sstream>
 #include "config_legacy.h"
+#include "cpu_topology.h"
 #include "eos_library_helpers.h"
 #include "io_helpers.h"
-#include "json_helpers.h"
+#include "file_view.h"
 #include "logging.h"
-#include <codecvt>
+#include "platform_registry.h"
+#include "tick_controller.h"
+#include "tick_driver.h"
 #include <eos_types.h>
 
+#if PLATFORM_WINDOWS
 #include "../../../include/DLLHContext.h"
+#elif PLATFORM_LINUX
+#include <dlfcn.h>
+#endif
+#include "Config/NativePlatformConfig.hpp"
 #include "Config/PlatformConfig.hpp"
 #include "Config/ProductConfig.hpp"
 #include "Config/SteamConfig.hpp"
-#include "Config/WindowsConfig.hpp"
 
 namespace pew::eos
 {
     PEW_EOS_API_FUNC(void*) EOS_GetPlatformInterface()
     {
-        return eos_library_helpers::eos_platform_handle;
+        return platform_registry::get_default();
     }
 
-    typedef bool(__cdecl* SteamAPI_Init_t)();
+    typedef bool(*SteamAPI_Init_t)();
 
     /**
      * @brief Initializes the steam api using the given function name.
@@ -74,15 +82,24 @@ namespace pew::eos
 
         auto path_to_log_config_json = config_legacy::get_path_for_eos_service_config(EOS_LOGLEVEL_CONFIG_FILENAME);
 
-        if (!exists(path_to_log_config_json))
+        config_legacy::LogLevelConfig log_config;
+        if (!config_legacy::log_config_from_blob(path_to_log_config_json, log_config))
         {
-            logging::log_inform("Log level config not found, using default log levels");
-            return;
-        }
+            if (!exists(path_to_log_config_json))
+            {
+                logging::log_inform("Log level config not found, using default log levels");
+                return;
+            }
 
-        json_value_s* log_config_as_json = json_helpers::read_config_json_as_json_from_path(path_to_log_config_json);
-        config_legacy::LogLevelConfig log_config = config_legacy::log_config_from_json_value(log_config_as_json);
-        free(log_config_as_json);
+            io_helpers::FileView file;
+            if (!file.open(path_to_log_config_json))
+            {
+                logging::log_warn("Failed to open the log level config, using default log levels");
+                return;
+            }
+
+            log_config = config_legacy::log_config_from_json(file.contents());
+        }
 
         // Validation to prevent out of range exception
         if (log_config.category.size() != log_config.level.size())
@@ -131,11 +148,13 @@ namespace pew::eos
         output << platform_options.ClientCredentials.ClientId << "\n";
         output << platform_options.ClientCredentials.ClientSecret << "\n";
 
+#if PLATFORM_WINDOWS
         auto* rtc_options = platform_options.RTCOptions;
         auto* windows_rtc_options = (EOS_Windows_RTCOptions*)rtc_options->PlatformSpecificOptions;
 
         output << windows_rtc_options->ApiVersion << "\n";
         output << windows_rtc_options->XAudio29DllPath << "\n";
+#endif
 
         logging::log_inform(output.str().c_str());
     }
@@ -153,6 +172,10 @@ namespace pew::eos
         // Populate the thread affinity from the platform configuration
         override_thread_affinity = platform_config.thread_affinity;
         override_thread_affinity.ApiVersion = EOS_INITIALIZE_THREADAFFINITY_API_LATEST;
+        if (platform_config.auto_thread_affinity)
+        {
+            cpu_topology::apply_auto_thread_affinity(override_thread_affinity);
+        }
 
         // Construct and populate the initialize options structure
         EOS_InitializeOptions sdk_initialize_options = {};
@@ -194,6 +217,25 @@ namespace pew::eos
         }
     }
 
+    /**
+     * @brief Gets a handle to a library that the process has already loaded,
+     * without loading it.
+     *
+     * @return The handle, or `nullptr` if the library is not loaded.
+     */
+    static void* get_loaded_library_handle(const char* library_name)
+    {
+#if PLATFORM_WINDOWS
+        return GetModuleHandleA(library_name);
+#elif PLATFORM_LINUX
+        // Unlike GetModuleHandleA this takes a reference to the library, which
+        // is never released since the steam library stays loaded anyway.
+        return dlopen(library_name, RTLD_NOW | RTLD_NOLOAD);
+#else
+        return nullptr;
+#endif
+    }
+
     void eos_call_steam_init(const std::string& steam_dll_filename)
     {
         // Default (fallback) name of the steam dll to load.
@@ -209,7 +251,7 @@ namespace pew::eos
         }
 
         // Get a handle to the steam dll
-        HANDLE steam_dll_handle = GetModuleHandleA(steam_dll_path.filename().string().c_str());
+        void* steam_dll_handle = get_loaded_library_handle(steam_dll_path.filename().string().c_str());
 
         // If getting a handle to the steam dll was not successful, log a
         // warning, and if the filename given as a parameter is something other
@@ -227,7 +269,7 @@ namespace pew::eos
 
                 // TODO: Isn't it supposed to be the basename of the dll, like
                 // it is in the first call to GetModuleHandleA?
-                steam_dll_handle = GetModuleHandleA(DEFAULT_STEAM_DLL_NAME);
+                steam_dll_handle = get_loaded_library_handle(DEFAULT_STEAM_DLL_NAME);
             }
 
             // If the steam dll handle is *STILL* not loaded, then attempt to
@@ -394,13 +436,26 @@ namespace pew::eos
         return platform_options;
     }
 
+    void release_create_options(EOS_Platform_Options& platform_options)
+    {
+        // If there is an integrated platform options container, make sure that it is freed.
+        if (platform_options.IntegratedPlatformOptionsContainerHandle)
+        {
+            eos_library_helpers::EOS_IntegratedPlatformOptionsContainer_Release_ptr(platform_options.IntegratedPlatformOptionsContainerHandle);
+            platform_options.IntegratedPlatformOptionsContainerHandle = nullptr;
+        }
+
+        delete platform_options.TaskNetworkTimeoutSeconds;
+        platform_options.TaskNetworkTimeoutSeconds = nullptr;
+    }
+
     // NOTE: This compile conditional is here because these functions are only 
     //       utilized to test the compatibility between native and managed 
     //       components of the plugin to guarantee their equivalency.
 #if _DEBUG
     PEW_EOS_API_FUNC(EOS_Platform_Options) PEW_EOS_Get_CreateOptions()
     {
-        static const auto platform_config = Config::get<WindowsConfig>();
+        static const auto platform_config = Config::get<NativePlatformConfig>();
         static const auto product_config = Config::get<ProductConfig>();
 
         static const auto create_options = get_create_options(*platform_config, *product_config);
@@ -413,7 +468,7 @@ namespace pew::eos
 
     PEW_EOS_API_FUNC(EOS_InitializeOptions) PEW_EOS_Get_InitializeOptions()
     {
-        static const auto platform_config = Config::get<WindowsConfig>();
+        static const auto platform_config = Config::get<NativePlatformConfig>();
         static const auto product_config = Config::get<ProductConfig>();
 
         // Allocate the required resources
@@ -426,29 +481,82 @@ namespace pew::eos
     }
 #endif
 
-    void eos_create(const PlatformConfig& platform_config, const ProductConfig& product_config)
+    void eos_create(const PlatformConfig& platform_config, const ProductConfig& product_config, bool as_server)
     {
         auto platform_options = get_create_options(platform_config, product_config);
+        if (as_server)
+        {
+            platform_options.bIsServer = EOS_TRUE;
+        }
 
         logging::log_inform("Calling EOS_Platform_Create");
-        eos_library_helpers::eos_platform_handle = eos_library_helpers::EOS_Platform_Create_ptr(&platform_options);
+        const EOS_HPlatform platform = eos_library_helpers::EOS_Platform_Create_ptr(&platform_options);
 
-        // If there is an integrated platform options container, make sure that it is freed.
-        if (platform_options.IntegratedPlatformOptionsContainerHandle)
+        if (!platform)
         {
-            eos_library_helpers::EOS_IntegratedPlatformOptionsContainer_Release_ptr(platform_options.IntegratedPlatformOptionsContainerHandle);
+            logging::log_error("Failed to create the EOS SDK Platform.");
         }
-
-        if (!eos_library_helpers::eos_platform_handle)
+        else if (!platform_registry::set_default(platform))
         {
-            logging::log_error("Failed to create the EOS SDK Platform.");
+            logging::log_error("The EOS SDK Platform was already created, releasing the new one.");
+            eos_library_helpers::EOS_Platform_Release_ptr(platform);
         }
         else
         {
             logging::log_inform("Successfully created the EOS SDK Platform.");
+
+            tick_controller::configure(platform_config.frame_budget_in_milliseconds, platform_options.TickBudgetInMilliseconds);
+
+            if (platform_config.native_tick_rate > 0)
+            {
+                tick_driver::start(platform, platform_config.native_tick_rate, platform_options.TickBudgetInMilliseconds);
+            }
         }
 
-        // Delete the one allocation
-        delete platform_options.TaskNetworkTimeoutSeconds;
+        release_create_options(platform_options);
+    }
+
+    void eos_platform_config_changed(const PlatformConfig& previous_config, const PlatformConfig& platform_config)
+    {
+        if (previous_config.tick_budget_in_milliseconds != platform_config.tick_budget_in_milliseconds)
+        {
+            logging::log_inform("Tick budget changed from " + std::to_string(previous_config.tick_budget_in_milliseconds) +
+                " to " + std::to_string(platform_config.tick_budget_in_milliseconds) + " milliseconds.");
+        }
+
+        if (previous_config.task_network_timeout_seconds != platform_config.task_network_timeout_seconds)
+        {
+            logging::log_inform("Network task timeout changed from " + std::to_string(previous_config.task_network_timeout_seconds) +
+                " to " + std::to_string(platform_config.task_network_timeout_seconds) + " seconds.");
+        }
+
+        if (previous_config.frame_budget_in_milliseconds != platform_config.frame_budget_in_milliseconds)
+        {
+            logging::log_inform("Frame budget changed from " + std::to_string(previous_config.frame_budget_in_milliseconds) +
+                " to " + std::to_string(platform_config.frame_budget_in_milliseconds) + " milliseconds.");
+
+            tick_controller::set_frame_budget(platform_config.frame_budget_in_milliseconds);
+        }
+
+        if (previous_config.native_tick_rate != platform_config.native_tick_rate)
+        {
+            logging::log_inform("Native tick rate changed from " + std::to_string(previous_config.native_tick_rate) +
+                " to " + std::to_string(platform_config.native_tick_rate) + " ticks per second.");
+
+            // Hosts that tick the platform some other way do not allow the
+            // driver, which must then not be started behind their back.
+            if (!tick_driver::is_allowed())
+            {
+                logging::log_inform("The tick driver is not allowed in this host, ignoring the new rate.");
+            }
+            else if (platform_config.native_tick_rate > 0)
+            {
+                tick_driver::start(platform_registry::get_default(), platform_config.native_tick_rate, static_cast<uint32_t>(std::max(platform_config.tick_budget_in_milliseconds, 0)));
+            }
+            else
+            {
+                tick_driver::stop();
+            }
+        }
     }
 }
@@ -25,6 +25,10 @@
 #include "logging.h"
 #include "string_helpers.h"
 
+#if PLATFORM_LINUX
+#include <dlfcn.h>
+#endif
+
 /**
   * @brief Chooses a string based on the platform's bitness.
   *
@@ -45,23 +49,38 @@ const char* pick_if_32bit_else(const char* choice_if_32bit, const char* choice_i
 
 namespace pew::eos::eos_library_helpers
 {
-    typedef void (EOS_CALL* EOS_Platform_Release_t)(EOS_HPlatform Handle);
-
-    EOS_Platform_Release_t EOS_Platform_Release_ptr;
-
     void* s_eos_sdk_lib_handle = nullptr;
     void* s_eos_sdk_overlay_lib_handle = nullptr;
-    EOS_HPlatform eos_platform_handle = nullptr;
 
     EOS_Initialize_t EOS_Initialize_ptr = nullptr;
     EOS_Shutdown_t EOS_Shutdown_ptr = nullptr;
     EOS_Platform_Create_t EOS_Platform_Create_ptr = nullptr;
+    EOS_Platform_Tick_t EOS_Platform_Tick_ptr = nullptr;
+    EOS_Platform_Release_t EOS_Platform_Release_ptr = nullptr;
     EOS_Logging_SetCallback_t EOS_Logging_SetCallback_ptr = nullptr;
     EOS_Logging_SetLogLevel_t EOS_Logging_SetLogLevel_ptr = nullptr;
     EOS_IntegratedPlatformOptionsContainer_Add_t EOS_IntegratedPlatformOptionsContainer_Add_ptr = nullptr;
     EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_t EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_ptr = nullptr;
     EOS_IntegratedPlatformOptionsContainer_Release_t EOS_IntegratedPlatformOptionsContainer_Release_ptr = nullptr;
 
+    EOS_Platform_GetP2PInterface_t EOS_Platform_GetP2PInterface_ptr = nullptr;
+    EOS_Platform_GetLobbyInterface_t EOS_Platform_GetLobbyInterface_ptr = nullptr;
+    EOS_Platform_GetPresenceInterface_t EOS_Platform_GetPresenceInterface_ptr = nullptr;
+    EOS_Platform_GetRTCInterface_t EOS_Platform_GetRTCInterface_ptr = nullptr;
+    EOS_P2P_AddNotifyPeerConnectionRequest_t EOS_P2P_AddNotifyPeerConnectionRequest_ptr = nullptr;
+    EOS_P2P_RemoveNotifyPeerConnectionRequest_t EOS_P2P_RemoveNotifyPeerConnectionRequest_ptr = nullptr;
+    EOS_P2P_ReceivePacket_t EOS_P2P_ReceivePacket_ptr = nullptr;
+    EOS_Lobby_AddNotifyLobbyUpdateReceived_t EOS_Lobby_AddNotifyLobbyUpdateReceived_ptr = nullptr;
+    EOS_Lobby_RemoveNotifyLobbyUpdateReceived_t EOS_Lobby_RemoveNotifyLobbyUpdateReceived_ptr = nullptr;
+    EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_t EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_ptr = nullptr;
+    EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_t EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_ptr = nullptr;
+    EOS_Lobby_AddNotifyLobbyMemberStatusReceived_t EOS_Lobby_AddNotifyLobbyMemberStatusReceived_ptr = nullptr;
+    EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_t EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_ptr = nullptr;
+    EOS_Presence_AddNotifyOnPresenceChanged_t EOS_Presence_AddNotifyOnPresenceChanged_ptr = nullptr;
+    EOS_Presence_RemoveNotifyOnPresenceChanged_t EOS_Presence_RemoveNotifyOnPresenceChanged_ptr = nullptr;
+    EOS_RTC_AddNotifyParticipantStatusChanged_t EOS_RTC_AddNotifyParticipantStatusChanged_ptr = nullptr;
+    EOS_RTC_RemoveNotifyParticipantStatusChanged_t EOS_RTC_RemoveNotifyParticipantStatusChanged_ptr = nullptr;
+
     void* load_library_at_path(const std::filesystem::path& library_path)
     {
         void* to_return = nullptr;
@@ -70,6 +89,13 @@ namespace pew::eos::eos_library_helpers
         logging::log_inform(("Loading path at " + string_helpers::to_utf8_str(library_path)).c_str());
         HMODULE handle = LoadLibrary(library_path.c_str());
         to_return = (void*)handle;
+#elif PLATFORM_LINUX
+        logging::log_inform("Loading path at " + library_path.string());
+        to_return = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (to_return == nullptr)
+        {
+            logging::log_error(std::string("Failed to load library: ") + dlerror());
+        }
 #endif
 
         return to_return;
@@ -81,6 +107,8 @@ namespace pew::eos::eos_library_helpers
 #if PLATFORM_WINDOWS
         HMODULE handle = (HMODULE)library_handle;
         to_return = (void*)GetProcAddress(handle, function);
+#elif PLATFORM_LINUX
+        to_return = dlsym(library_handle, function);
 #endif
         return to_return;
     }
@@ -91,6 +119,7 @@ namespace pew::eos::eos_library_helpers
         EOS_Initialize_ptr = load_function_with_name<EOS_Initialize_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Initialize@4", "EOS_Initialize"));
         EOS_Shutdown_ptr = load_function_with_name<EOS_Shutdown_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Shutdown@0", "EOS_Shutdown"));
         EOS_Platform_Create_ptr = load_function_with_name<EOS_Platform_Create_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_Create@4", "EOS_Platform_Create"));
+        EOS_Platform_Tick_ptr = load_function_with_name<EOS_Platform_Tick_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_Tick@4", "EOS_Platform_Tick"));
         EOS_Platform_Release_ptr = load_function_with_name<EOS_Platform_Release_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_Release@4", "EOS_Platform_Release"));
         EOS_Logging_SetLogLevel_ptr = load_function_with_name<EOS_Logging_SetLogLevel_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Logging_SetLogLevel@8", "EOS_Logging_SetLogLevel"));
         EOS_Logging_SetCallback_ptr = load_function_with_name<EOS_Logging_SetCallback_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("EOS_Logging_SetCallback@4", "EOS_Logging_SetCallback"));
@@ -98,12 +127,30 @@ namespace pew::eos::eos_library_helpers
         EOS_IntegratedPlatformOptionsContainer_Add_ptr = load_function_with_name<EOS_IntegratedPlatformOptionsContainer_Add_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_IntegratedPlatformOptionsContainer_Add@8", "EOS_IntegratedPlatformOptionsContainer_Add"));
         EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_ptr = load_function_with_name<EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer@8", "EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer"));
         EOS_IntegratedPlatformOptionsContainer_Release_ptr = load_function_with_name<EOS_IntegratedPlatformOptionsContainer_Release_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_IntegratedPlatformOptionsContainer_Release@4", "EOS_IntegratedPlatformOptionsContainer_Release"));
+
+        EOS_Platform_GetP2PInterface_ptr = load_function_with_name<EOS_Platform_GetP2PInterface_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_GetP2PInterface@4", "EOS_Platform_GetP2PInterface"));
+        EOS_Platform_GetLobbyInterface_ptr = load_function_with_name<EOS_Platform_GetLobbyInterface_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_GetLobbyInterface@4", "EOS_Platform_GetLobbyInterface"));
+        EOS_Platform_GetPresenceInterface_ptr = load_function_with_name<EOS_Platform_GetPresenceInterface_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_GetPresenceInterface@4", "EOS_Platform_GetPresenceInterface"));
+        EOS_Platform_GetRTCInterface_ptr = load_function_with_name<EOS_Platform_GetRTCInterface_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Platform_GetRTCInterface@4", "EOS_Platform_GetRTCInterface"));
+        EOS_P2P_AddNotifyPeerConnectionRequest_ptr = load_function_with_name<EOS_P2P_AddNotifyPeerConnectionRequest_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_P2P_AddNotifyPeerConnectionRequest@16", "EOS_P2P_AddNotifyPeerConnectionRequest"));
+        EOS_P2P_RemoveNotifyPeerConnectionRequest_ptr = load_function_with_name<EOS_P2P_RemoveNotifyPeerConnectionRequest_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_P2P_RemoveNotifyPeerConnectionRequest@12", "EOS_P2P_RemoveNotifyPeerConnectionRequest"));
+        EOS_P2P_ReceivePacket_ptr = load_function_with_name<EOS_P2P_ReceivePacket_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_P2P_ReceivePacket@28", "EOS_P2P_ReceivePacket"));
+        EOS_Lobby_AddNotifyLobbyUpdateReceived_ptr = load_function_with_name<EOS_Lobby_AddNotifyLobbyUpdateReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_AddNotifyLobbyUpdateReceived@16", "EOS_Lobby_AddNotifyLobbyUpdateReceived"));
+        EOS_Lobby_RemoveNotifyLobbyUpdateReceived_ptr = load_function_with_name<EOS_Lobby_RemoveNotifyLobbyUpdateReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_RemoveNotifyLobbyUpdateReceived@12", "EOS_Lobby_RemoveNotifyLobbyUpdateReceived"));
+        EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_ptr = load_function_with_name<EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_AddNotifyLobbyMemberUpdateReceived@16", "EOS_Lobby_AddNotifyLobbyMemberUpdateReceived"));
+        EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_ptr = load_function_with_name<EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived@12", "EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived"));
+        EOS_Lobby_AddNotifyLobbyMemberStatusReceived_ptr = load_function_with_name<EOS_Lobby_AddNotifyLobbyMemberStatusReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_AddNotifyLobbyMemberStatusReceived@16", "EOS_Lobby_AddNotifyLobbyMemberStatusReceived"));
+        EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_ptr = load_function_with_name<EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived@12", "EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived"));
+        EOS_Presence_AddNotifyOnPresenceChanged_ptr = load_function_with_name<EOS_Presence_AddNotifyOnPresenceChanged_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Presence_AddNotifyOnPresenceChanged@16", "EOS_Presence_AddNotifyOnPresenceChanged"));
+        EOS_Presence_RemoveNotifyOnPresenceChanged_ptr = load_function_with_name<EOS_Presence_RemoveNotifyOnPresenceChanged_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_Presence_RemoveNotifyOnPresenceChanged@12", "EOS_Presence_RemoveNotifyOnPresenceChanged"));
+        EOS_RTC_AddNotifyParticipantStatusChanged_ptr = load_function_with_name<EOS_RTC_AddNotifyParticipantStatusChanged_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_RTC_AddNotifyParticipantStatusChanged@16", "EOS_RTC_AddNotifyParticipantStatusChanged"));
+        EOS_RTC_RemoveNotifyParticipantStatusChanged_ptr = load_function_with_name<EOS_RTC_RemoveNotifyParticipantStatusChanged_t>(s_eos_sdk_lib_handle, pick_if_32bit_else("_EOS_RTC_RemoveNotifyParticipantStatusChanged@12", "EOS_RTC_RemoveNotifyParticipantStatusChanged"));
     }
 
+#if PLATFORM_WINDOWS
     bool QueryRegKey(const HKEY InKey, const TCHAR* InSubKey, const TCHAR* InValueName, std::wstring& OutData)
     {
         bool bSuccess = false;
-#if PLATFORM_WINDOWS
         // Redirect key depending on system
         for (uint32_t RegistryIndex = 0; RegistryIndex < 2 && !bSuccess; ++RegistryIndex)
         {
@@ -128,13 +175,17 @@ namespace pew::eos::eos_library_helpers
                 RegCloseKey(Key);
             }
         }
-#endif
         return bSuccess;
     }
+#endif
 
     void unload_library(void* library_handle)
     {
+#if PLATFORM_WINDOWS
         FreeLibrary((HMODULE)library_handle);
+#elif PLATFORM_LINUX
+        dlclose(library_handle);
+#endif
     }
 
     static bool get_overlay_dll_path(std::filesystem::path* OutDllPath)
@@ -155,7 +206,7 @@ namespace pew::eos::eos_library_helpers
         *OutDllPath = std::filesystem::path(OverlayDllDirectory) / OVERLAY_DLL_NAME;
         return exists(*OutDllPath) && is_regular_file(*OutDllPath);
 #else
-        log_inform("Trying to get a DLL path on a platform without DLL paths searching");
+        logging::log_inform("Trying to get a DLL path on a platform without DLL paths searching");
         return false;
 #endif
     }
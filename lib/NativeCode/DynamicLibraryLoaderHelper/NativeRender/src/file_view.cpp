@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "file_view.h"
+
+#include <utility>
+
+#if !PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pew::eos::io_helpers
+{
+    FileView::~FileView()
+    {
+        close();
+    }
+
+    FileView::FileView(FileView&& other) noexcept :
+        _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)),
+        _is_open(std::exchange(other._is_open, false)),
+        _mapping(std::exchange(other._mapping, nullptr))
+    {
+    }
+
+    FileView& FileView::operator=(FileView&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _is_open = std::exchange(other._is_open, false);
+            _mapping = std::exchange(other._mapping, nullptr);
+        }
+        return *this;
+    }
+
+    bool FileView::open(const std::filesystem::path& path)
+    {
+        close();
+
+#if PLATFORM_WINDOWS
+        const HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER file_size = {};
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        _size = static_cast<size_t>(file_size.QuadPart);
+        if (_size != 0)
+        {
+            // The mapping keeps the file open, so the file handle itself is
+            // not needed once the mapping exists.
+            _mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping != nullptr)
+            {
+                _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+        }
+        CloseHandle(file);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            return false;
+        }
+
+        struct stat file_status = {};
+        if (fstat(file, &file_status) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        _size = static_cast<size_t>(file_status.st_size);
+        if (_size != 0)
+        {
+            // The mapping stays valid after the descriptor is closed.
+            void* view = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+            _data = (view == MAP_FAILED) ? nullptr : static_cast<const char*>(view);
+        }
+        ::close(file);
+#endif
+
+        if (_size != 0 && _data == nullptr)
+        {
+            close();
+            return false;
+        }
+
+        _is_open = true;
+        return true;
+    }
+
+    void FileView::close()
+    {
+#if PLATFORM_WINDOWS
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping != nullptr)
+        {
+            CloseHandle(_mapping);
+        }
+#else
+        if (_data != nullptr)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+        _is_open = false;
+        _mapping = nullptr;
+    }
+}
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+#if !PLATFORM_WINDOWS
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace pew::eos::flight_recorder
+{
+    /**
+     * @brief Offset of the first record within the file. The header is padded
+     * out to a cache line so that records never share a line with the
+     * frequently written sequence counter.
+     */
+    constexpr size_t RECORDS_OFFSET = 64;
+    static_assert(sizeof(FlightRecorderHeader) <= RECORDS_OFFSET, "FlightRecorderHeader must fit before the first record.");
+
+    FlightRecorderHeader* s_header = nullptr;
+    FlightRecord* s_records = nullptr;
+    uint32_t s_record_count = 0;
+
+    void* s_view = nullptr;
+    size_t s_view_size = 0;
+
+#if PLATFORM_WINDOWS
+    HANDLE s_file = INVALID_HANDLE_VALUE;
+    HANDLE s_mapping = nullptr;
+    LPTOP_LEVEL_EXCEPTION_FILTER s_previous_exception_filter = nullptr;
+#else
+    int s_file = -1;
+
+    constexpr int FATAL_SIGNALS[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+    struct sigaction s_previous_actions[std::size(FATAL_SIGNALS)];
+#endif
+
+    bool s_crash_handlers_installed = false;
+
+    /**
+     * @brief Copies a string into a fixed-size field, truncating it if it does
+     * not fit, and returns the number of bytes copied.
+     */
+    static uint16_t copy_truncated(char* destination, size_t capacity, const char* source)
+    {
+        if (source == nullptr)
+        {
+            return 0;
+        }
+
+        size_t length = 0;
+        while (length < capacity && source[length] != '\0')
+        {
+            ++length;
+        }
+
+        memcpy(destination, source, length);
+        return static_cast<uint16_t>(length);
+    }
+
+    /**
+     * @brief Writes the mapped view back to the file. Only calls functions
+     * that are safe to use from a signal handler.
+     */
+    static void flush_view()
+    {
+        if (s_view == nullptr)
+        {
+            return;
+        }
+
+#if PLATFORM_WINDOWS
+        FlushViewOfFile(s_view, s_view_size);
+        FlushFileBuffers(s_file);
+#else
+        msync(s_view, s_view_size, MS_SYNC);
+#endif
+    }
+
+#if PLATFORM_WINDOWS
+    static LONG WINAPI on_unhandled_exception(EXCEPTION_POINTERS* exception_info)
+    {
+        flush_view();
+
+        if (s_previous_exception_filter != nullptr)
+        {
+            return s_previous_exception_filter(exception_info);
+        }
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+#else
+    static void on_fatal_signal(int signal_number, siginfo_t* info, void* context)
+    {
+        flush_view();
+
+        const struct sigaction* previous_action = nullptr;
+        for (size_t index = 0; index < std::size(FATAL_SIGNALS); ++index)
+        {
+            if (FATAL_SIGNALS[index] == signal_number)
+            {
+                previous_action = &s_previous_actions[index];
+                break;
+            }
+        }
+        if (previous_action == nullptr)
+        {
+            return;
+        }
+
+        // A handler installed before the flight recorder is called with the
+        // original siginfo and context, since some of them (the Mono
+        // runtime turning SIGSEGV into a NullReferenceException, crash
+        // reporters) need the context of the faulting thread, and may
+        // resume it.
+        if ((previous_action->sa_flags & SA_SIGINFO) != 0)
+        {
+            if (previous_action->sa_sigaction != nullptr)
+            {
+                previous_action->sa_sigaction(signal_number, info, context);
+            }
+            return;
+        }
+        if (previous_action->sa_handler != SIG_DFL && previous_action->sa_handler != SIG_IGN)
+        {
+            previous_action->sa_handler(signal_number);
+            return;
+        }
+
+        // Otherwise the default action is restored. A fault happens again
+        // once the faulting instruction re-executes, this time with the
+        // default action, so the process terminates (or dumps core) as it
+        // would have without the flight recorder. A signal that was sent
+        // rather than caused by a fault is raised again.
+        sigaction(signal_number, previous_action, nullptr);
+        if (info == nullptr || info->si_code <= 0)
+        {
+            raise(signal_number);
+        }
+    }
+#endif
+
+    static void install_crash_handlers()
+    {
+        if (s_crash_handlers_installed)
+        {
+            return;
+        }
+
+#if PLATFORM_WINDOWS
+        s_previous_exception_filter = SetUnhandledExceptionFilter(on_unhandled_exception);
+#else
+        // The handler stays installed after it runs, since a previous
+        // handler it chains to may recover from the signal. SA_ONSTACK lets
+        // a stack overflow be handled on the alternate stack, if the process
+        // has one.
+        struct sigaction action = {};
+        action.sa_sigaction = on_fatal_signal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+
+        for (size_t index = 0; index < std::size(FATAL_SIGNALS); ++index)
+        {
+            sigaction(FATAL_SIGNALS[index], &action, &s_previous_actions[index]);
+        }
+#endif
+        s_crash_handlers_installed = true;
+    }
+
+    static void remove_crash_handlers()
+    {
+        if (!s_crash_handlers_installed)
+        {
+            return;
+        }
+
+#if PLATFORM_WINDOWS
+        SetUnhandledExceptionFilter(s_previous_exception_filter);
+        s_previous_exception_filter = nullptr;
+#else
+        for (size_t index = 0; index < std::size(FATAL_SIGNALS); ++index)
+        {
+            sigaction(FATAL_SIGNALS[index], &s_previous_actions[index], nullptr);
+        }
+#endif
+        s_crash_handlers_installed = false;
+    }
+
+    static bool map_file(const std::filesystem::path& path, size_t size)
+    {
+#if PLATFORM_WINDOWS
+        s_file = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (s_file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        // Creating a mapping larger than the file grows the file to that size.
+        ULARGE_INTEGER mapping_size = {};
+        mapping_size.QuadPart = size;
+        s_mapping = CreateFileMappingW(s_file, nullptr, PAGE_READWRITE, mapping_size.HighPart, mapping_size.LowPart, nullptr);
+        if (s_mapping != nullptr)
+        {
+            s_view = MapViewOfFile(s_mapping, FILE_MAP_WRITE, 0, 0, 0);
+        }
+#else
+        s_file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (s_file < 0)
+        {
+            return false;
+        }
+
+        if (ftruncate(s_file, static_cast<off_t>(size)) == 0)
+        {
+            void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, s_file, 0);
+            s_view = (view == MAP_FAILED) ? nullptr : view;
+        }
+#endif
+        s_view_size = (s_view == nullptr) ? 0 : size;
+        return s_view != nullptr;
+    }
+
+    static void unmap_file()
+    {
+#if PLATFORM_WINDOWS
+        if (s_view != nullptr)
+        {
+            UnmapViewOfFile(s_view);
+        }
+        if (s_mapping != nullptr)
+        {
+            CloseHandle(s_mapping);
+            s_mapping = nullptr;
+        }
+        if (s_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(s_file);
+            s_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (s_view != nullptr)
+        {
+            munmap(s_view, s_view_size);
+        }
+        if (s_file != -1)
+        {
+            ::close(s_file);
+            s_file = -1;
+        }
+#endif
+        s_view = nullptr;
+        s_view_size = 0;
+    }
+
+    bool open(const std::filesystem::path& path, uint32_t record_count)
+    {
+        close();
+
+        if (record_count == 0)
+        {
+            return false;
+        }
+
+        // Keep the recording of the previous run around, since that is the
+        // one that is interesting if the previous run crashed.
+        std::error_code error;
+        if (std::filesystem::exists(path, error))
+        {
+            std::filesystem::path previous_path = path;
+            previous_path.replace_filename(path.stem().string() + ".prev" + path.extension().string());
+            std::filesystem::rename(path, previous_path, error);
+        }
+
+        if (!map_file(path, RECORDS_OFFSET + static_cast<size_t>(record_count) * sizeof(FlightRecord)))
+        {
+            unmap_file();
+            return false;
+        }
+
+        // The file is newly created, so every record is zeroed (and therefore
+        // marked as never written) already.
+        s_header = new (s_view) FlightRecorderHeader();
+        memcpy(s_header->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        s_header->version = FILE_VERSION;
+        s_header->record_size = sizeof(FlightRecord);
+        s_header->record_count = record_count;
+        s_header->next_sequence.store(0, std::memory_order_relaxed);
+
+        s_record_count = record_count;
+        s_records = reinterpret_cast<FlightRecord*>(static_cast<char*>(s_view) + RECORDS_OFFSET);
+
+        install_crash_handlers();
+
+        return true;
+    }
+
+    void record(EOS_ELogLevel level, const char* category, const char* message)
+    {
+        FlightRecorderHeader* header = s_header;
+        if (header == nullptr)
+        {
+            return;
+        }
+
+        const uint64_t sequence = header->next_sequence.fetch_add(1, std::memory_order_relaxed);
+        FlightRecord& slot = s_records[sequence % s_record_count];
+
+        // Mark the slot as being written before touching its contents, so that
+        // a reader never mistakes a half-written record for a complete one.
+        slot.state.store(sequence * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        slot.level = static_cast<int32_t>(level);
+        slot.category_length = copy_truncated(slot.category, FlightRecord::CATEGORY_CAPACITY, category);
+        slot.message_length = copy_truncated(slot.message, FlightRecord::MESSAGE_CAPACITY, message);
+
+        slot.state.store(sequence * 2 + 2, std::memory_order_release);
+    }
+
+    void flush()
+    {
+        flush_view();
+    }
+
+    void close()
+    {
+        remove_crash_handlers();
+        flush_view();
+
+        s_header = nullptr;
+        s_records = nullptr;
+        s_record_count = 0;
+
+        unmap_file();
+    }
+
+    bool for_each_record(const std::filesystem::path& path, const std::function<void(const FlightRecordEntry&)>& on_record)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        // Read a copy of the file rather than mapping it, so that a recording
+        // that is still being written by another process can be inspected.
+        const std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (contents.size() < RECORDS_OFFSET)
+        {
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const FlightRecorderHeader*>(contents.data());
+        if (memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+            || header->version != FILE_VERSION
+            || header->record_size != sizeof(FlightRecord)
+            || contents.size() < RECORDS_OFFSET + static_cast<size_t>(header->record_count) * sizeof(FlightRecord))
+        {
+            return false;
+        }
+
+        const auto* records = reinterpret_cast<const FlightRecord*>(contents.data() + RECORDS_OFFSET);
+
+        std::vector<FlightRecordEntry> entries;
+        entries.reserve(header->record_count);
+        for (uint32_t index = 0; index < header->record_count; ++index)
+        {
+            const FlightRecord& slot = records[index];
+            const uint64_t state = slot.state.load(std::memory_order_relaxed);
+
+            // Skip slots that were never written, and slots that were in the
+            // middle of being written when the copy was taken.
+            if (state == 0 || (state & 1) != 0)
+            {
+                continue;
+            }
+
+            FlightRecordEntry entry;
+            entry.sequence = (state - 2) / 2;
+            entry.timestamp_ms = slot.timestamp_ms;
+            entry.level = static_cast<EOS_ELogLevel>(slot.level);
+            entry.category.assign(slot.category, std::min<size_t>(slot.category_length, FlightRecord::CATEGORY_CAPACITY));
+            entry.message.assign(slot.message, std::min<size_t>(slot.message_length, FlightRecord::MESSAGE_CAPACITY));
+            entries.push_back(std::move(entry));
+        }
+
+        std::sort(entries.begin(), entries.end(),
+            [](const FlightRecordEntry& lhs, const FlightRecordEntry& rhs) { return lhs.sequence < rhs.sequence; });
+
+        for (const FlightRecordEntry& entry : entries)
+        {
+            on_record(entry);
+        }
+
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_FlightRecorder_Dump(const char* path, logging::log_flush_function_t log_flush_function)
+    {
+        if (path == nullptr || log_flush_function == nullptr)
+        {
+            return false;
+        }
+
+        return for_each_record(path, [log_flush_function](const FlightRecordEntry& entry)
+        {
+            const time_t raw_time = static_cast<time_t>(entry.timestamp_ms / 1000);
+            tm time_info = {};
+#if PLATFORM_WINDOWS
+            localtime_s(&time_info, &raw_time);
+#else
+            localtime_r(&raw_time, &time_info);
+#endif
+            char timestamp[32];
+            strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &time_info);
+
+            const char* level = logging::eos_loglevel_to_print_str(entry.level);
+
+            std::string line(64 + entry.category.size() + entry.message.size(), '\0');
+            const int length = snprintf(line.data(), line.size() + 1, "%s.%03d %s (%s): %s",
+                timestamp, static_cast<int>(entry.timestamp_ms % 1000), entry.category.c_str(),
+                level != nullptr ? level : "Unknown", entry.message.c_str());
+            if (length > 0)
+            {
+                line.resize(std::min(static_cast<size_t>(length), line.size()));
+                log_flush_function(line.c_str());
+            }
+        });
+    }
+}
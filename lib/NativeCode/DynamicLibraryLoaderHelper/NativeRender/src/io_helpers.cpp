@@ -23,9 +23,19 @@
 #include <pch.h>
 #include <filesystem>
 #include <string>
+#include <vector>
+
+#include "io_helpers.h"
+#include "string_helpers.h"
+
+#if PLATFORM_LINUX
+#include <dlfcn.h>
+#include <fstream>
+#endif
 
 namespace pew::eos::io_helpers
 {
+#if PLATFORM_WINDOWS
     TCHAR* get_path_to_module(HMODULE module)
     {
         DWORD module_path_length = 128;
@@ -85,4 +95,75 @@ namespace pew::eos::io_helpers
 
         return filename;
     }
+
+    std::vector<std::string> get_command_line_arguments()
+    {
+        std::vector<std::string> arguments;
+        string_helpers::for_each_word(GetCommandLineA(), [&arguments](std::string_view argument)
+        {
+            arguments.emplace_back(argument);
+        });
+        return arguments;
+    }
+#elif PLATFORM_LINUX
+    std::filesystem::path get_path_relative_to_current_module(const std::filesystem::path& relative_path)
+    {
+        std::error_code error;
+        std::filesystem::path module_path;
+
+        // dladdr names the shared object that contains this function, which
+        // is the plugin itself unless it was linked into the executable.
+        Dl_info module_info = {};
+        if (dladdr(reinterpret_cast<void*>(&get_path_relative_to_current_module), &module_info) != 0
+            && module_info.dli_fname != nullptr
+            && std::filesystem::path(module_info.dli_fname).is_absolute())
+        {
+            module_path = module_info.dli_fname;
+        }
+        else
+        {
+            module_path = std::filesystem::read_symlink("/proc/self/exe", error);
+            if (error)
+            {
+                return {};
+            }
+        }
+
+        return module_path.remove_filename() / relative_path;
+    }
+
+    std::string get_basename(const std::string& path)
+    {
+        return std::filesystem::path(path).stem().string();
+    }
+
+    std::vector<std::string> get_command_line_arguments()
+    {
+        // The arguments are stored separated by null characters.
+        std::ifstream command_line_file("/proc/self/cmdline", std::ios::binary);
+        std::vector<std::string> arguments;
+        std::string argument;
+        while (std::getline(command_line_file, argument, '\0'))
+        {
+            arguments.push_back(argument);
+        }
+        return arguments;
+    }
+#endif
+
+    FileStamp get_file_stamp(const std::filesystem::path& file_path)
+    {
+        FileStamp stamp;
+        std::error_code error;
+
+        stamp.last_write_time = std::filesystem::last_write_time(file_path, error);
+        if (error)
+        {
+            return stamp;
+        }
+
+        stamp.size = std::filesystem::file_size(file_path, error);
+        stamp.exists = !error;
+        return stamp;
+    }
 } // namespace pew::eos::io_helpers
@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pch.h>
+#include "json_reader.h"
+#include "json_scan.h"
+
+namespace pew::eos::json_helpers
+{
+    static bool is_digit(char character)
+    {
+        return character >= '0' && character <= '9';
+    }
+
+    static int hex_digit_value(char character)
+    {
+        if (character >= '0' && character <= '9') { return character - '0'; }
+        if (character >= 'a' && character <= 'f') { return character - 'a' + 10; }
+        if (character >= 'A' && character <= 'F') { return character - 'A' + 10; }
+        return -1;
+    }
+
+    static void append_utf8(std::string& output, uint32_t code_point)
+    {
+        if (code_point < 0x80)
+        {
+            output.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    JsonReader::JsonReader(std::string_view json) : _json(json)
+    {
+    }
+
+    JsonValueType JsonReader::peek()
+    {
+        skip_whitespace();
+        if (_failed || _position >= _json.size())
+        {
+            return JsonValueType::Invalid;
+        }
+
+        switch (_json[_position])
+        {
+        case '{': return JsonValueType::Object;
+        case '[': return JsonValueType::Array;
+        case '"': return JsonValueType::String;
+        case 't': return JsonValueType::True;
+        case 'f': return JsonValueType::False;
+        case 'n': return JsonValueType::Null;
+        default:
+            return (_json[_position] == '-' || is_digit(_json[_position])) ? JsonValueType::Number : JsonValueType::Invalid;
+        }
+    }
+
+    bool JsonReader::begin_object()
+    {
+        if (peek() != JsonValueType::Object)
+        {
+            return false;
+        }
+
+        if (_depth == MAX_DEPTH)
+        {
+            return fail();
+        }
+
+        ++_position;
+        ++_depth;
+        _at_container_start = true;
+        return true;
+    }
+
+    bool JsonReader::next_member(std::string_view& name)
+    {
+        skip_whitespace();
+        if (_failed || _position >= _json.size())
+        {
+            return fail();
+        }
+
+        if (_json[_position] == '}')
+        {
+            ++_position;
+            --_depth;
+            _at_container_start = false;
+            return false;
+        }
+
+        if (!_at_container_start)
+        {
+            if (!consume(','))
+            {
+                return fail();
+            }
+            skip_whitespace();
+        }
+        _at_container_start = false;
+
+        if (_position >= _json.size() || _json[_position] != '"' || !scan_string(_name_buffer, name))
+        {
+            return fail();
+        }
+
+        skip_whitespace();
+        if (!consume(':'))
+        {
+            return fail();
+        }
+
+        // Leave the reader at the start of the value, so that callers can
+        // tell whether the value was consumed by comparing offsets.
+        skip_whitespace();
+        return true;
+    }
+
+    bool JsonReader::begin_array()
+    {
+        if (peek() != JsonValueType::Array)
+        {
+            return false;
+        }
+
+        if (_depth == MAX_DEPTH)
+        {
+            return fail();
+        }
+
+        ++_position;
+        ++_depth;
+        _at_container_start = true;
+        return true;
+    }
+
+    bool JsonReader::next_element()
+    {
+        skip_whitespace();
+        if (_failed || _position >= _json.size())
+        {
+            return fail();
+        }
+
+        if (_json[_position] == ']')
+        {
+            ++_position;
+            --_depth;
+            _at_container_start = false;
+            return false;
+        }
+
+        if (!_at_container_start && !consume(','))
+        {
+            return fail();
+        }
+        _at_container_start = false;
+
+        // The element itself is checked by whatever reads it, but a trailing
+        // comma has to be caught here.
+        skip_whitespace();
+        if (_position >= _json.size() || _json[_position] == ']')
+        {
+            return fail();
+        }
+
+        return true;
+    }
+
+    bool JsonReader::read_string(std::string& value)
+    {
+        if (peek() != JsonValueType::String)
+        {
+            return false;
+        }
+
+        std::string_view contents;
+        if (!scan_string(value, contents))
+        {
+            return fail();
+        }
+
+        // Strings without escape sequences are not copied by scan_string.
+        if (contents.data() != value.data())
+        {
+            value.assign(contents);
+        }
+        return true;
+    }
+
+    bool JsonReader::read_string_view(std::string_view& value)
+    {
+        if (peek() != JsonValueType::String)
+        {
+            return false;
+        }
+
+        if (!scan_string(_value_buffer, value))
+        {
+            return fail();
+        }
+        return true;
+    }
+
+    bool JsonReader::read_bool(bool& value)
+    {
+        switch (peek())
+        {
+        case JsonValueType::True:
+            value = true;
+            return scan_literal("true");
+        case JsonValueType::False:
+            value = false;
+            return scan_literal("false");
+        default:
+            return false;
+        }
+    }
+
+    void JsonReader::skip_value()
+    {
+        switch (peek())
+        {
+        case JsonValueType::Object:
+        case JsonValueType::Array:
+        {
+            // Containers are skipped by matching brackets with the
+            // vectorized scanner rather than by parsing their contents.
+            const size_t end = find_container_end(_json, _position);
+            if (end == std::string_view::npos)
+            {
+                fail();
+            }
+            else
+            {
+                _position = end;
+            }
+            break;
+        }
+        case JsonValueType::String:
+        {
+            std::string scratch;
+            std::string_view contents;
+            if (!scan_string(scratch, contents))
+            {
+                fail();
+            }
+            break;
+        }
+        case JsonValueType::Number:
+        {
+            std::string_view token;
+            scan_number(token);
+            break;
+        }
+        case JsonValueType::True:
+            scan_literal("true");
+            break;
+        case JsonValueType::False:
+            scan_literal("false");
+            break;
+        case JsonValueType::Null:
+            scan_literal("null");
+            break;
+        case JsonValueType::Invalid:
+            fail();
+            break;
+        }
+    }
+
+    bool JsonReader::finish()
+    {
+        skip_whitespace();
+        if (_position != _json.size())
+        {
+            fail();
+        }
+        return !_failed;
+    }
+
+    void JsonReader::skip_whitespace()
+    {
+        while (_position < _json.size())
+        {
+            const char character = _json[_position];
+            if (character != ' ' && character != '\t' && character != '\n' && character != '\r')
+            {
+                break;
+            }
+            ++_position;
+        }
+    }
+
+    bool JsonReader::fail()
+    {
+        _failed = true;
+        return false;
+    }
+
+    bool JsonReader::consume(char expected)
+    {
+        if (_position < _json.size() && _json[_position] == expected)
+        {
+            ++_position;
+            return true;
+        }
+        return false;
+    }
+
+    bool JsonReader::scan_string(std::string& buffer, std::string_view& contents)
+    {
+        // Skip the opening quote.
+        const size_t start = ++_position;
+
+        // Fast path: find the end of a string that has no escape sequences,
+        // which can then be returned as a view of the input.
+        _position += find_string_special(_json.data() + _position, _json.size() - _position);
+        if (_position < _json.size())
+        {
+            const char character = _json[_position];
+            if (character == '"')
+            {
+                contents = _json.substr(start, _position - start);
+                ++_position;
+                return true;
+            }
+            if (character != '\\')
+            {
+                return false;
+            }
+        }
+
+        if (_position >= _json.size())
+        {
+            return false;
+        }
+
+        buffer.assign(_json.data() + start, _position - start);
+
+        while (_position < _json.size())
+        {
+            // Copy everything up to the next escape sequence at once.
+            const size_t run_length = find_string_special(_json.data() + _position, _json.size() - _position);
+            buffer.append(_json.data() + _position, run_length);
+            _position += run_length;
+            if (_position >= _json.size())
+            {
+                return false;
+            }
+
+            const char character = _json[_position++];
+            if (character == '"')
+            {
+                contents = buffer;
+                return true;
+            }
+            if (character != '\\')
+            {
+                return false;
+            }
+
+            if (_position >= _json.size())
+            {
+                return false;
+            }
+
+            switch (_json[_position++])
+            {
+            case '"': buffer.push_back('"'); break;
+            case '\\': buffer.push_back('\\'); break;
+            case '/': buffer.push_back('/'); break;
+            case 'b': buffer.push_back('\b'); break;
+            case 'f': buffer.push_back('\f'); break;
+            case 'n': buffer.push_back('\n'); break;
+            case 'r': buffer.push_back('\r'); break;
+            case 't': buffer.push_back('\t'); break;
+            case 'u':
+            {
+                const auto read_code_unit = [this](uint32_t& code_unit)
+                {
+                    if (_json.size() - _position < 4)
+                    {
+                        return false;
+                    }
+
+                    code_unit = 0;
+                    for (size_t index = 0; index < 4; ++index)
+                    {
+                        const int digit = hex_digit_value(_json[_position++]);
+                        if (digit < 0)
+                        {
+                            return false;
+                        }
+                        code_unit = (code_unit << 4) | static_cast<uint32_t>(digit);
+                    }
+                    return true;
+                };
+
+                uint32_t code_point;
+                if (!read_code_unit(code_point) || (code_point >= 0xDC00 && code_point <= 0xDFFF))
+                {
+                    return false;
+                }
+
+                // Characters outside of the basic multilingual plane are
+                // escaped as a surrogate pair.
+                if (code_point >= 0xD800 && code_point <= 0xDBFF)
+                {
+                    uint32_t low_surrogate;
+                    if (!consume('\\') || !consume('u') || !read_code_unit(low_surrogate) ||
+                        low_surrogate < 0xDC00 || low_surrogate > 0xDFFF)
+                    {
+                        return false;
+                    }
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+                }
+
+                append_utf8(buffer, code_point);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    bool JsonReader::scan_number(std::string_view& token)
+    {
+        if (peek() != JsonValueType::Number)
+        {
+            return false;
+        }
+
+        const size_t start = _position;
+        const auto skip_digits = [this]()
+        {
+            const size_t first_digit = _position;
+            while (_position < _json.size() && is_digit(_json[_position]))
+            {
+                ++_position;
+            }
+            return _position != first_digit;
+        };
+
+        consume('-');
+        if (!consume('0') && !skip_digits())
+        {
+            return fail();
+        }
+
+        if (consume('.') && !skip_digits())
+        {
+            return fail();
+        }
+
+        if (consume('e') || consume('E'))
+        {
+            if (!consume('+'))
+            {
+                consume('-');
+            }
+            if (!skip_digits())
+            {
+                return fail();
+            }
+        }
+
+        token = _json.substr(start, _position - start);
+        return true;
+    }
+
+    bool JsonReader::scan_literal(std::string_view literal)
+    {
+        if (_json.compare(_position, literal.size(), literal) != 0)
+        {
+            return fail();
+        }
+
+        _position += literal.size();
+        return true;
+    }
+}
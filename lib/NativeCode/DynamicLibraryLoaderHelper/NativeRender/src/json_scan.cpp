@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pch.h>
+#include "json_scan.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if !defined(PEW_EOS_JSON_SCAN_SCALAR)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SCAN_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define JSON_SCAN_NEON 1
+#endif
+#endif
+
+#if JSON_SCAN_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics in any function; GCC and Clang need the
+// function to be compiled for the instruction set.
+#define JSON_SCAN_TARGET_AVX2
+#else
+#define JSON_SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif JSON_SCAN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace pew::eos::json_helpers
+{
+    /**
+     * @brief Bit masks describing a 64 byte block of input, where bit i
+     * corresponds to byte i of the block.
+     */
+    struct BlockMasks
+    {
+        uint64_t quotes;
+        uint64_t backslashes;
+
+        // '{' and '['
+        uint64_t opening_brackets;
+
+        // '}' and ']'
+        uint64_t closing_brackets;
+    };
+
+    using ClassifyBlockFunction = void (*)(const char* block, BlockMasks& masks);
+
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    static unsigned count_trailing_zeros(uint64_t value)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<uint32_t>(value)))
+        {
+            return static_cast<unsigned>(index);
+        }
+        _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+        return static_cast<unsigned>(index) + 32;
+#else
+        return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+    }
+
+    [[maybe_unused]] static void classify_block_scalar(const char* block, BlockMasks& masks)
+    {
+        masks = {};
+        for (size_t index = 0; index < BLOCK_SIZE; ++index)
+        {
+            const uint64_t bit = uint64_t(1) << index;
+            switch (block[index])
+            {
+            case '"': masks.quotes |= bit; break;
+            case '\\': masks.backslashes |= bit; break;
+            case '{': case '[': masks.opening_brackets |= bit; break;
+            case '}': case ']': masks.closing_brackets |= bit; break;
+            default: break;
+            }
+        }
+    }
+
+#if JSON_SCAN_X86
+    // '[' and '{' (and likewise ']' and '}') only differ in the 0x20 bit, so
+    // both kinds of bracket are matched with a single comparison after that
+    // bit has been set.
+
+    static void classify_block_sse2(const char* block, BlockMasks& masks)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i opening_bracket = _mm_set1_epi8('{');
+        const __m128i closing_bracket = _mm_set1_epi8('}');
+
+        masks = {};
+        for (size_t offset = 0; offset < BLOCK_SIZE; offset += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + offset));
+            const __m128i folded = _mm_or_si128(chunk, case_bit);
+
+            masks.quotes |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << offset;
+            masks.backslashes |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << offset;
+            masks.opening_brackets |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, opening_bracket)))) << offset;
+            masks.closing_brackets |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, closing_bracket)))) << offset;
+        }
+    }
+
+    JSON_SCAN_TARGET_AVX2
+    static void classify_block_avx2(const char* block, BlockMasks& masks)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i case_bit = _mm256_set1_epi8(0x20);
+        const __m256i opening_bracket = _mm256_set1_epi8('{');
+        const __m256i closing_bracket = _mm256_set1_epi8('}');
+
+        masks = {};
+        for (size_t offset = 0; offset < BLOCK_SIZE; offset += 32)
+        {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + offset));
+            const __m256i folded = _mm256_or_si256(chunk, case_bit);
+
+            masks.quotes |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)))) << offset;
+            masks.backslashes |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)))) << offset;
+            masks.opening_brackets |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, opening_bracket)))) << offset;
+            masks.closing_brackets |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, closing_bracket)))) << offset;
+        }
+    }
+
+    static bool cpu_supports_avx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // The operating system must also save the upper halves of the YMM
+        // registers on a context switch.
+        __cpuid(info, 1);
+        const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+        if (!has_osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#elif JSON_SCAN_NEON
+    /**
+     * @brief Collects the top bit of each byte into a 16 bit mask, like
+     * _mm_movemask_epi8 (the bytes are comparison results, so every bit of a
+     * byte is the same).
+     */
+    static uint64_t movemask(uint8x16_t comparison)
+    {
+        static const uint8_t bit_weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        const uint8x16_t weighted = vandq_u8(comparison, vld1q_u8(bit_weights));
+        return uint64_t(vaddv_u8(vget_low_u8(weighted))) | (uint64_t(vaddv_u8(vget_high_u8(weighted))) << 8);
+    }
+
+    static void classify_block_neon(const char* block, BlockMasks& masks)
+    {
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t case_bit = vdupq_n_u8(0x20);
+        const uint8x16_t opening_bracket = vdupq_n_u8('{');
+        const uint8x16_t closing_bracket = vdupq_n_u8('}');
+
+        masks = {};
+        for (size_t offset = 0; offset < BLOCK_SIZE; offset += 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(block + offset));
+            const uint8x16_t folded = vorrq_u8(chunk, case_bit);
+
+            masks.quotes |= movemask(vceqq_u8(chunk, quote)) << offset;
+            masks.backslashes |= movemask(vceqq_u8(chunk, backslash)) << offset;
+            masks.opening_brackets |= movemask(vceqq_u8(folded, opening_bracket)) << offset;
+            masks.closing_brackets |= movemask(vceqq_u8(folded, closing_bracket)) << offset;
+        }
+    }
+#endif
+
+    static ClassifyBlockFunction get_classify_block_function()
+    {
+#if JSON_SCAN_X86
+        static const ClassifyBlockFunction classify_block = cpu_supports_avx2() ? classify_block_avx2 : classify_block_sse2;
+        return classify_block;
+#elif JSON_SCAN_NEON
+        return classify_block_neon;
+#else
+        return classify_block_scalar;
+#endif
+    }
+
+    /**
+     * @brief Determines which characters of a block are escaped by a
+     * backslash.
+     *
+     * @param backslashes The backslashes in the block.
+     * @param carry On input, 1 if the first character of the block is
+     * escaped by a backslash at the end of the previous block. On output,
+     * the same for the next block.
+     * @return The mask of escaped characters.
+     */
+    static uint64_t find_escaped(uint64_t backslashes, uint64_t& carry)
+    {
+        uint64_t escaped = carry;
+        carry = 0;
+
+        // Backslashes are rare enough in practice that walking them one at a
+        // time is cheaper than the branchless approach.
+        uint64_t escaping = backslashes & ~escaped;
+        while (escaping != 0)
+        {
+            const unsigned index = count_trailing_zeros(escaping);
+            if (index == BLOCK_SIZE - 1)
+            {
+                carry = 1;
+                break;
+            }
+
+            escaped |= uint64_t(2) << index;
+            escaping &= ~(uint64_t(3) << index);
+        }
+
+        return escaped;
+    }
+
+    /**
+     * @brief Computes, for every bit, the XOR of that bit and all of the
+     * bits below it. Applied to the unescaped quotes of a block, this yields
+     * the characters that are inside of a string.
+     */
+    static uint64_t prefix_xor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    size_t find_string_special(const char* data, size_t size)
+    {
+        size_t offset = 0;
+
+#if JSON_SCAN_X86
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control_max = _mm_set1_epi8(0x1F);
+
+        for (; offset + 16 <= size; offset += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+
+            // There is no unsigned comparison in SSE2, but a byte is a
+            // control character exactly when max(byte, 0x1F) is 0x1F.
+            const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max));
+
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return offset + count_trailing_zeros(mask);
+            }
+        }
+#elif JSON_SCAN_NEON
+        const uint8x16_t quote = vdupq_n_u8('"');
+        const uint8x16_t backslash = vdupq_n_u8('\\');
+        const uint8x16_t control_limit = vdupq_n_u8(0x20);
+
+        for (; offset + 16 <= size; offset += 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + offset));
+            const uint8x16_t special = vorrq_u8(
+                vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                vcltq_u8(chunk, control_limit));
+
+            const uint64_t mask = movemask(special);
+            if (mask != 0)
+            {
+                return offset + count_trailing_zeros(mask);
+            }
+        }
+#endif
+
+        for (; offset < size; ++offset)
+        {
+            const char character = data[offset];
+            if (character == '"' || character == '\\' || static_cast<unsigned char>(character) < 0x20)
+            {
+                break;
+            }
+        }
+
+        return offset;
+    }
+
+    size_t find_container_end(std::string_view json, size_t start)
+    {
+        const ClassifyBlockFunction classify_block = get_classify_block_function();
+
+        uint64_t escape_carry = 0;
+
+        // All ones while the previous block ended inside of a string.
+        uint64_t string_carry = 0;
+        size_t depth = 0;
+
+        for (size_t block_start = start; block_start < json.size(); block_start += BLOCK_SIZE)
+        {
+            BlockMasks masks;
+            const size_t remaining = json.size() - block_start;
+            if (remaining >= BLOCK_SIZE)
+            {
+                classify_block(json.data() + block_start, masks);
+            }
+            else
+            {
+                // Pad the last block with whitespace, which none of the masks
+                // match.
+                char padded[BLOCK_SIZE];
+                std::memset(padded, ' ', sizeof(padded));
+                std::memcpy(padded, json.data() + block_start, remaining);
+                classify_block(padded, masks);
+            }
+
+            const uint64_t quotes = masks.quotes & ~find_escaped(masks.backslashes, escape_carry);
+            const uint64_t in_string = prefix_xor(quotes) ^ string_carry;
+            string_carry = (in_string >> (BLOCK_SIZE - 1)) != 0 ? ~uint64_t(0) : 0;
+
+            uint64_t brackets = (masks.opening_brackets | masks.closing_brackets) & ~in_string;
+            while (brackets != 0)
+            {
+                const unsigned index = count_trailing_zeros(brackets);
+                brackets &= brackets - 1;
+
+                if ((masks.opening_brackets >> index) & 1)
+                {
+                    ++depth;
+                }
+                else if (--depth == 0)
+                {
+                    return block_start + index + 1;
+                }
+            }
+        }
+
+        return std::string_view::npos;
+    }
+}
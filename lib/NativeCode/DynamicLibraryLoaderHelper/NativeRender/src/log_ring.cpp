@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "log_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pew::eos::logging
+{
+    LogRing::LogRing(size_t capacity) :
+        // Every record is a multiple of four bytes, so the capacity must be as
+        // well for records to line up with the end of the buffer.
+        _buffer((std::max<size_t>(capacity, 64) + 3) & ~static_cast<size_t>(3))
+    {
+    }
+
+    bool LogRing::push(const char* text, size_t length)
+    {
+        std::lock_guard lock(_mutex);
+
+        const size_t capacity = _buffer.size();
+        length = std::min(length, capacity / 4);
+
+        const size_t record_size = get_record_size(length);
+        const size_t offset = static_cast<size_t>(_head % capacity);
+        const size_t space_to_end = capacity - offset;
+
+        // If the record does not fit before the end of the buffer, the space
+        // that is left there goes unused and the record starts at the
+        // beginning of the buffer instead.
+        const size_t wrap_padding = (record_size > space_to_end) ? space_to_end : 0;
+
+        if ((_head - _tail) + wrap_padding + record_size > capacity)
+        {
+            ++_dropped;
+            return false;
+        }
+
+        if (wrap_padding != 0)
+        {
+            _wrap_at = _head;
+            _head += wrap_padding;
+        }
+
+        char* record = _buffer.data() + (_head % capacity);
+        const uint32_t record_length = static_cast<uint32_t>(length);
+        memcpy(record, &record_length, RECORD_HEADER_SIZE);
+        memcpy(record + RECORD_HEADER_SIZE, text, length);
+        memset(record + RECORD_HEADER_SIZE + length, 0, record_size - RECORD_HEADER_SIZE - length);
+
+        _head += record_size;
+        return true;
+    }
+
+    void LogRing::skip_wrap()
+    {
+        if (_tail == _wrap_at)
+        {
+            _tail += _buffer.size() - (_wrap_at % _buffer.size());
+            _wrap_at = UINT64_MAX;
+        }
+    }
+
+    void LogRing::peek(const char** data, size_t* length)
+    {
+        std::lock_guard lock(_mutex);
+
+        skip_wrap();
+
+        // A batch ends at the gap left by the producer, or at the end of the
+        // buffer if a record happened to end exactly there.
+        const uint64_t end = (_wrap_at != UINT64_MAX) ? _wrap_at : _head;
+        const size_t offset = static_cast<size_t>(_tail % _buffer.size());
+        *length = std::min(static_cast<size_t>(end - _tail), _buffer.size() - offset);
+        *data = (*length == 0) ? nullptr : _buffer.data() + offset;
+    }
+
+    void LogRing::consume(size_t length)
+    {
+        std::lock_guard lock(_mutex);
+
+        const uint64_t end = (_wrap_at != UINT64_MAX) ? _wrap_at : _head;
+        _tail += std::min<uint64_t>(length, end - _tail);
+
+        skip_wrap();
+    }
+
+    uint64_t LogRing::for_each(const std::function<void(const char*, size_t)>& on_line, uint64_t from_position)
+    {
+        std::lock_guard lock(_mutex);
+
+        // Positions at or after the tail are always at the start of a record,
+        // or at the gap left by the producer.
+        uint64_t position = std::min(std::max(_tail, from_position), _head);
+        while (position != _head)
+        {
+            if (position == _wrap_at)
+            {
+                position += _buffer.size() - (_wrap_at % _buffer.size());
+                continue;
+            }
+
+            const char* record = _buffer.data() + (position % _buffer.size());
+            uint32_t record_length = 0;
+            memcpy(&record_length, record, RECORD_HEADER_SIZE);
+
+            on_line(record + RECORD_HEADER_SIZE, record_length);
+
+            position += get_record_size(record_length);
+        }
+
+        return position;
+    }
+
+    uint64_t LogRing::get_head_position()
+    {
+        std::lock_guard lock(_mutex);
+        return _head;
+    }
+
+    void LogRing::clear()
+    {
+        std::lock_guard lock(_mutex);
+
+        _tail = _head;
+        _wrap_at = UINT64_MAX;
+    }
+
+    uint64_t LogRing::get_dropped_count()
+    {
+        std::lock_guard lock(_mutex);
+        return _dropped;
+    }
+}
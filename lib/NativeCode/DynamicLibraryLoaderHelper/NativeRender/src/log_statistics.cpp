@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "log_statistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace pew::eos::logging
+{
+    /**
+     * @brief Live counters of a single category.
+     */
+    struct CategoryCounters
+    {
+        char category[LOG_STATISTICS_CATEGORY_CAPACITY];
+        std::atomic<uint64_t> message_count[LOG_STATISTICS_LEVEL_COUNT];
+        std::atomic<uint64_t> byte_count[LOG_STATISTICS_LEVEL_COUNT];
+        std::atomic<uint64_t> dropped_count;
+    };
+
+    // The last slot is reserved for the "Other" category, which collects the
+    // messages of categories that did not get a slot of their own.
+    constexpr size_t OTHER_CATEGORY_INDEX = LOG_STATISTICS_MAX_CATEGORIES - 1;
+
+    CategoryCounters s_category_counters[LOG_STATISTICS_MAX_CATEGORIES];
+
+    // Number of slots whose category name has been set. Slots below this count
+    // are never modified again (other than their counters), so they can be
+    // searched without holding the mutex.
+    std::atomic<size_t> s_category_count = 0;
+    std::mutex s_category_mutex;
+
+    static bool category_matches(const CategoryCounters& counters, const char* category)
+    {
+        return strncmp(counters.category, category, LOG_STATISTICS_CATEGORY_CAPACITY - 1) == 0;
+    }
+
+    static CategoryCounters& find_or_add_category(const char* category)
+    {
+        size_t count = s_category_count.load(std::memory_order_acquire);
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (category_matches(s_category_counters[index], category))
+            {
+                return s_category_counters[index];
+            }
+        }
+
+        std::lock_guard lock(s_category_mutex);
+
+        // Another thread may have added the category while the lock was being
+        // acquired.
+        const size_t locked_count = s_category_count.load(std::memory_order_relaxed);
+        for (size_t index = count; index < locked_count; ++index)
+        {
+            if (category_matches(s_category_counters[index], category))
+            {
+                return s_category_counters[index];
+            }
+        }
+
+        if (locked_count >= OTHER_CATEGORY_INDEX)
+        {
+            return s_category_counters[OTHER_CATEGORY_INDEX];
+        }
+
+        CategoryCounters& counters = s_category_counters[locked_count];
+        strncpy(counters.category, category, LOG_STATISTICS_CATEGORY_CAPACITY - 1);
+        counters.category[LOG_STATISTICS_CATEGORY_CAPACITY - 1] = '\0';
+        s_category_count.store(locked_count + 1, std::memory_order_release);
+
+        return counters;
+    }
+
+    void record_log_statistics(const char* category, EOS_ELogLevel level, size_t bytes, bool dropped)
+    {
+        CategoryCounters& counters = find_or_add_category(category != nullptr ? category : "");
+
+        const size_t level_index = std::min(static_cast<size_t>(std::max(static_cast<int>(level), 0)) / 100, LOG_STATISTICS_LEVEL_COUNT - 1);
+        counters.message_count[level_index].fetch_add(1, std::memory_order_relaxed);
+        counters.byte_count[level_index].fetch_add(bytes, std::memory_order_relaxed);
+        if (dropped)
+        {
+            counters.dropped_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void copy_counters(const CategoryCounters& counters, LogCategoryStatistics& statistics)
+    {
+        memcpy(statistics.category, counters.category, LOG_STATISTICS_CATEGORY_CAPACITY);
+        for (size_t level_index = 0; level_index < LOG_STATISTICS_LEVEL_COUNT; ++level_index)
+        {
+            statistics.message_count[level_index] = counters.message_count[level_index].load(std::memory_order_relaxed);
+            statistics.byte_count[level_index] = counters.byte_count[level_index].load(std::memory_order_relaxed);
+        }
+        statistics.dropped_count = counters.dropped_count.load(std::memory_order_relaxed);
+    }
+
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_GetLogStatistics(LogCategoryStatistics* statistics, uint32_t capacity)
+    {
+        const size_t count = s_category_count.load(std::memory_order_acquire);
+
+        // Only report the "Other" category once something has been counted in
+        // it.
+        const CategoryCounters& other = s_category_counters[OTHER_CATEGORY_INDEX];
+        bool has_other = other.dropped_count.load(std::memory_order_relaxed) != 0;
+        for (size_t level_index = 0; level_index < LOG_STATISTICS_LEVEL_COUNT && !has_other; ++level_index)
+        {
+            has_other = other.message_count[level_index].load(std::memory_order_relaxed) != 0;
+        }
+
+        const size_t total = count + (has_other ? 1 : 0);
+        for (size_t index = 0; index < total && index < capacity; ++index)
+        {
+            copy_counters(index < count ? s_category_counters[index] : other, statistics[index]);
+            if (index >= count)
+            {
+                strncpy(statistics[index].category, "Other", LOG_STATISTICS_CATEGORY_CAPACITY);
+            }
+        }
+
+        return static_cast<uint32_t>(total);
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_ResetLogStatistics()
+    {
+        // The categories themselves are kept, so that slots can still be
+        // searched without a lock.
+        for (CategoryCounters& counters : s_category_counters)
+        {
+            for (size_t level_index = 0; level_index < LOG_STATISTICS_LEVEL_COUNT; ++level_index)
+            {
+                counters.message_count[level_index].store(0, std::memory_order_relaxed);
+                counters.byte_count[level_index].store(0, std::memory_order_relaxed);
+            }
+            counters.dropped_count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -25,16 +25,27 @@
 #include <eos_logging.h>
 #include <iostream>
 
+#include "flight_recorder.h"
+#include "log_ring.h"
+#include "log_statistics.h"
+#include "mapped_log_file.h"
 #include "string_helpers.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstring>
 #include <unordered_map>
 #include <iostream>
 
 namespace pew::eos::logging
 {
-    FILE* s_log_file = nullptr;
-    std::vector<std::string> buffered_output;
+    MappedLogFile s_log_file;
+    LogRing s_log_ring;
     bool s_mirror_to_stdout = false;
 
+    // Position in the log ring up to which the lines have been written to the
+    // log file, so that opening the file again does not write them twice.
+    std::atomic<uint64_t> s_file_written_position = 0;
+
     const std::unordered_map<std::string, EOS_ELogLevel> LOGLEVEL_STR_MAP =
     {
         {"Off",EOS_ELogLevel::EOS_LOG_Off},
@@ -71,16 +82,35 @@ namespace pew::eos::logging
 
     PEW_EOS_API_FUNC(void) global_log_flush_with_function(const log_flush_function_t log_flush_function)
     {
-        if (!buffered_output.empty())
+        const char* batch = nullptr;
+        size_t batch_length = 0;
+
+        // Records are null-terminated in the ring, so each line can be handed
+        // to the function without being copied.
+        for (global_log_peek_batch(&batch, &batch_length); batch_length != 0; global_log_peek_batch(&batch, &batch_length))
         {
-            for (const std::string& str : buffered_output)
+            size_t offset = 0;
+            while (offset < batch_length)
             {
-                log_flush_function(str.c_str());
+                uint32_t line_length = 0;
+                memcpy(&line_length, batch + offset, LogRing::RECORD_HEADER_SIZE);
+                log_flush_function(batch + offset + LogRing::RECORD_HEADER_SIZE);
+                offset += LogRing::get_record_size(line_length);
             }
-            buffered_output.clear();
+            global_log_consume_batch(batch_length);
         }
     }
 
+    PEW_EOS_API_FUNC(void) global_log_peek_batch(const char** data, size_t* length)
+    {
+        s_log_ring.peek(data, length);
+    }
+
+    PEW_EOS_API_FUNC(void) global_log_consume_batch(size_t length)
+    {
+        s_log_ring.consume(length);
+    }
+
     EOS_ELogLevel eos_loglevel_str_to_enum(const std::string& str)
     {
         auto it = LOGLEVEL_STR_MAP.find(str);
@@ -110,87 +140,157 @@ namespace pew::eos::logging
 
     void global_log_close()
     {
-        if (s_log_file)
+        if (s_log_file.is_open())
         {
-            fclose(s_log_file);
-            s_log_file = nullptr;
-            buffered_output.clear();
+            s_log_file.close();
+            s_log_ring.clear();
         }
     }
 
-    void global_logf(const char* format, ...)
+    /**
+     * @brief Formats a log line and writes it to the log file and the log
+     * ring.
+     *
+     * @param dropped Set to `true` if the line could not be added to the log
+     * ring because it was full.
+     * @param format The format string for the log line.
+     * @param arg_list Arguments for the format string.
+     * @return The length of the formatted line, in bytes.
+     */
+    static size_t global_vlogf(bool& dropped, const char* format, va_list arg_list)
     {
-        if (s_log_file != nullptr)
+        // Most log lines fit in this buffer, which avoids a heap allocation
+        // for every line that is logged.
+        constexpr size_t stack_buffer_len = 1024;
+        char stack_buffer[stack_buffer_len];
+        std::vector<char> heap_buffer;
+        const char* line = stack_buffer;
+
+        va_list arg_list_copy;
+        va_copy(arg_list_copy, arg_list);
+        const int printed_length = vsnprintf(stack_buffer, stack_buffer_len, format, arg_list);
+
+        if (printed_length >= static_cast<int>(stack_buffer_len))
         {
-            va_list arg_list;
-            va_start(arg_list, format);
-            vfprintf(s_log_file, format, arg_list);
-            va_end(arg_list);
+            heap_buffer.resize(static_cast<size_t>(printed_length) + 1);
+            vsnprintf(heap_buffer.data(), heap_buffer.size(), format, arg_list_copy);
+            line = heap_buffer.data();
+        }
+        va_end(arg_list_copy);
 
-            fprintf(s_log_file, "\n");
-            fflush(s_log_file);
+        dropped = false;
+        if (printed_length < 0)
+        {
+            return 0;
         }
-        else
+
+        const bool is_file_open = s_log_file.is_open();
+        if (is_file_open)
         {
-            va_list arg_list;
-            va_start(arg_list, format);
-            va_list arg_list_copy;
-            va_copy(arg_list_copy, arg_list);
-            const size_t printed_length = vsnprintf(nullptr, 0, format, arg_list) + 1;
-            va_end(arg_list);
+            s_log_file.write_line(line, static_cast<size_t>(printed_length));
+        }
+        dropped = !s_log_ring.push(line, static_cast<size_t>(printed_length));
 
-            std::vector<char> buffer(printed_length);
-            vsnprintf(buffer.data(), printed_length, format, arg_list_copy);
-            va_end(arg_list_copy);
-            buffered_output.emplace_back(std::string(buffer.data(), printed_length));
+        if (is_file_open)
+        {
+            s_file_written_position = s_log_ring.get_head_position();
         }
+
+        return static_cast<size_t>(printed_length);
+    }
+
+    /**
+     * @brief Writes a formatted log line and counts it in the log statistics
+     * of the given category.
+     */
+    static void global_logf_with_statistics(const char* category, EOS_ELogLevel level, const char* format, ...)
+    {
+        bool dropped = false;
+
+        va_list arg_list;
+        va_start(arg_list, format);
+        const size_t length = global_vlogf(dropped, format, arg_list);
+        va_end(arg_list);
+
+        record_log_statistics(category, level, length, dropped);
+    }
+
+    void global_logf(const char* format, ...)
+    {
+        bool dropped = false;
+
+        va_list arg_list;
+        va_start(arg_list, format);
+        global_vlogf(dropped, format, arg_list);
+        va_end(arg_list);
     }
 
     PEW_EOS_API_FUNC(void) EOS_CALL eos_log_callback(const EOS_LogMessage* message)
     {
+        flight_recorder::record(message->Level, message->Category, message->Message);
+
         constexpr size_t final_timestamp_len = 32;
         char final_timestamp[final_timestamp_len] = { 0 };
 
         if (string_helpers::create_timestamp_str(final_timestamp, final_timestamp_len))
         {
-            global_logf("%s %s (%s): %s", final_timestamp, message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
+            global_logf_with_statistics(message->Category, message->Level, "%s %s (%s): %s",
+                final_timestamp, message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
         }
         else
         {
-            global_logf("%s (%s): %s", message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
+            global_logf_with_statistics(message->Category, message->Level, "%s (%s): %s",
+                message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
         }
     }
 
-    void global_log_open(const char* filename)
+    void global_log_open(const char* filename, size_t segment_size, size_t max_segments)
     {
-        if (s_log_file != nullptr)
+        s_log_file.open(filename, segment_size, max_segments);
+
+        // Lines logged while no file was open have only reached the ring so
+        // far, so they are written to the file as well. They stay in the ring
+        // until managed code drains it.
+        if (s_log_file.is_open())
         {
-            fclose(s_log_file);
-            s_log_file = nullptr;
+            s_file_written_position = s_log_ring.for_each([](const char* line, size_t length)
+            {
+                s_log_file.write_line(line, length);
+            }, s_file_written_position);
         }
-        fopen_s(&s_log_file, filename, "w");
+    }
 
-        if (buffered_output.size() > 0)
+    /**
+     * @brief Maps the header used by log_base to the closest EOS log level, so
+     * that native messages can be recorded alongside the EOS SDK messages.
+     */
+    static EOS_ELogLevel header_to_loglevel(const char* header)
+    {
+        if (strcmp(header, "ERROR") == 0)
         {
-            for (const std::string& str : buffered_output)
-            {
-                global_logf(str.c_str());
-            }
-            buffered_output.clear();
+            return EOS_ELogLevel::EOS_LOG_Error;
         }
+        if (strcmp(header, "WARNING") == 0)
+        {
+            return EOS_ELogLevel::EOS_LOG_Warning;
+        }
+        return EOS_ELogLevel::EOS_LOG_Info;
     }
 
     void log_base(const char* header, const char* message)
     {
+        const EOS_ELogLevel level = header_to_loglevel(header);
+        flight_recorder::record(level, "NativePlugin", message);
+
         constexpr size_t final_timestamp_len = 32;
         char final_timestamp[final_timestamp_len] = { };
         if (string_helpers::create_timestamp_str(final_timestamp, final_timestamp_len))
         {
-            global_logf("%s NativePlugin (%s): %s", final_timestamp, header, message);
+            global_logf_with_statistics("NativePlugin", level, "%s NativePlugin (%s): %s", final_timestamp, header, message);
         }
         else
         {
-            global_logf("NativePlugin (%s): %s", header, message);
+            global_logf_with_statistics("NativePlugin", level, "NativePlugin (%s): %s", header, message);
         }
 
         if (s_mirror_to_stdout)
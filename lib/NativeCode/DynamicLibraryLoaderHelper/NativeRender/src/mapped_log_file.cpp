@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "mapped_log_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if !PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pew::eos::logging
+{
+    MappedLogFile::~MappedLogFile()
+    {
+        close();
+    }
+
+    bool MappedLogFile::open(const std::filesystem::path& path, size_t segment_size, size_t max_segments)
+    {
+        std::lock_guard lock(_mutex);
+
+        unmap_segment();
+
+        _path = path;
+        _segment_size = segment_size;
+        _max_segments = std::max<size_t>(max_segments, 1);
+
+        if (!map_segment())
+        {
+            return false;
+        }
+
+        // If the existing file already fills the segment, start a new one.
+        if (_offset >= _segment_size)
+        {
+            rotate();
+        }
+
+        return is_open();
+    }
+
+    bool MappedLogFile::is_open() const
+    {
+        return _view != nullptr;
+    }
+
+    void MappedLogFile::write_line(const char* text, size_t length)
+    {
+        std::lock_guard lock(_mutex);
+
+        if (_view == nullptr)
+        {
+            return;
+        }
+
+        // Leave room for the trailing newline, and never let a single line be
+        // larger than an entire segment.
+        length = std::min(length, _segment_size - 1);
+
+        if (_offset + length + 1 > _segment_size)
+        {
+            rotate();
+
+            // Rotation can fail to free up space (for instance if the old
+            // segment could not be renamed), in which case the line is lost.
+            if (_view == nullptr || _offset + length + 1 > _segment_size)
+            {
+                return;
+            }
+        }
+
+        memcpy(_view + _offset, text, length);
+        _offset += length;
+        _view[_offset++] = '\n';
+    }
+
+    void MappedLogFile::close()
+    {
+        std::lock_guard lock(_mutex);
+        unmap_segment();
+    }
+
+    bool MappedLogFile::map_segment()
+    {
+#if PLATFORM_WINDOWS
+        const HANDLE file = CreateFileW(_path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        _file = reinterpret_cast<intptr_t>(file);
+
+        LARGE_INTEGER existing_size = {};
+        GetFileSizeEx(file, &existing_size);
+        _offset = static_cast<size_t>(existing_size.QuadPart);
+
+        // Creating a mapping larger than the file grows the file to that size.
+        _view_size = std::max(_segment_size, _offset);
+        ULARGE_INTEGER mapping_size = {};
+        mapping_size.QuadPart = _view_size;
+        _mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, mapping_size.HighPart, mapping_size.LowPart, nullptr);
+        if (_mapping != nullptr)
+        {
+            _view = static_cast<char*>(MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, 0));
+        }
+#else
+        const int file = ::open(_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (file < 0)
+        {
+            return false;
+        }
+        _file = file;
+
+        struct stat file_status = {};
+        fstat(file, &file_status);
+        _offset = static_cast<size_t>(file_status.st_size);
+
+        _view_size = std::max(_segment_size, _offset);
+        if (ftruncate(file, static_cast<off_t>(_view_size)) == 0)
+        {
+            void* view = mmap(nullptr, _view_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            _view = (view == MAP_FAILED) ? nullptr : static_cast<char*>(view);
+        }
+#endif
+
+        if (_view == nullptr)
+        {
+            unmap_segment();
+            return false;
+        }
+
+        // A segment that was not finalized (for instance because the process
+        // was terminated) is still padded with zeroes up to the segment size.
+        // Resume writing directly after the last character that was logged.
+        while (_offset > 0 && _view[_offset - 1] == '\0')
+        {
+            --_offset;
+        }
+
+        return true;
+    }
+
+    void MappedLogFile::unmap_segment()
+    {
+#if PLATFORM_WINDOWS
+        if (_view != nullptr)
+        {
+            UnmapViewOfFile(_view);
+        }
+        if (_mapping != nullptr)
+        {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+        if (_file != -1)
+        {
+            const HANDLE file = reinterpret_cast<HANDLE>(_file);
+
+            // Trim the padding that was added when the segment was mapped.
+            LARGE_INTEGER final_size = {};
+            final_size.QuadPart = static_cast<LONGLONG>(_offset);
+            SetFilePointerEx(file, final_size, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+
+            CloseHandle(file);
+            _file = -1;
+        }
+#else
+        if (_view != nullptr)
+        {
+            munmap(_view, _view_size);
+        }
+        if (_file != -1)
+        {
+            const int file = static_cast<int>(_file);
+
+            // Trim the padding that was added when the segment was mapped. A
+            // failure here cannot be reported through the logger itself, and
+            // only leaves zero padding that is skipped on the next open.
+            const int truncate_result = ftruncate(file, static_cast<off_t>(_offset));
+            (void)truncate_result;
+
+            ::close(file);
+            _file = -1;
+        }
+#endif
+        _view = nullptr;
+        _view_size = 0;
+        _offset = 0;
+    }
+
+    void MappedLogFile::rotate()
+    {
+        unmap_segment();
+
+        std::error_code error;
+
+        // Drop the oldest segment, then shift every remaining one up by one.
+        std::filesystem::remove(get_segment_path(_max_segments - 1), error);
+        for (size_t index = _max_segments - 1; index > 0; --index)
+        {
+            std::filesystem::rename(get_segment_path(index - 1), get_segment_path(index), error);
+        }
+
+        map_segment();
+    }
+
+    std::filesystem::path MappedLogFile::get_segment_path(size_t index) const
+    {
+        if (index == 0)
+        {
+            return _path;
+        }
+
+        std::filesystem::path segment_path = _path;
+        segment_path.replace_filename(_path.stem().string() + "." + std::to_string(index) + _path.extension().string());
+        return segment_path;
+    }
+}
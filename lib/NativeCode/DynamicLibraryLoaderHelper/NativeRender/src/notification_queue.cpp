@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "notification_queue.h"
+
+#include <atomic>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "eos_library_helpers.h"
+#include "platform_registry.h"
+
+namespace pew::eos::notification_queue
+{
+    using namespace eos_library_helpers;
+
+    enum class SubscriptionKind
+    {
+        PeerConnectionRequests,
+        Lobby,
+        Presence,
+        RTCParticipantStatus
+    };
+
+    /**
+     * @brief The notifications registered for one subscription. Lobby
+     * subscriptions register three notifications, the others one.
+     */
+    struct Subscription
+    {
+        SubscriptionKind kind;
+        EOS_HPlatform platform;
+        EOS_NotificationId notification_ids[3];
+    };
+
+    std::mutex s_subscription_mutex;
+    std::unordered_map<uint64_t, Subscription> s_subscriptions;
+    uint64_t s_next_subscription_id = 1;
+
+    // Records are written into the pending buffer by the notification
+    // handlers. A drain swaps it with the drained buffer, whose records stay
+    // valid until the next drain; the capacity of both buffers is reused, so
+    // once they have grown queuing notifications does not allocate.
+    std::mutex s_queue_mutex;
+    std::vector<uint8_t> s_pending_records;
+    uint32_t s_pending_count = 0;
+    std::vector<uint8_t> s_drained_records;
+    std::atomic<uint64_t> s_dropped_count = 0;
+
+    static std::string_view to_view(const char* str)
+    {
+        return str != nullptr ? std::string_view(str) : std::string_view();
+    }
+
+    /**
+     * @brief Appends a record to the pending buffer.
+     *
+     * @param record The struct of the record. Its header and the string
+     * members listed in strings are filled in here.
+     * @param type The type of the record.
+     * @param strings The string members of the record, and their values.
+     */
+    template <typename T>
+    static void enqueue(T record, NotificationType type, std::initializer_list<std::pair<NotificationString T::*, std::string_view>> strings)
+    {
+        size_t size = sizeof(T);
+        for (const auto& [member, value] : strings)
+        {
+            size += value.size() + 1;
+        }
+        size = (size + NOTIFICATION_RECORD_ALIGNMENT - 1) & ~static_cast<size_t>(NOTIFICATION_RECORD_ALIGNMENT - 1);
+
+        std::lock_guard lock(s_queue_mutex);
+
+        if (s_pending_records.size() + size > MAX_QUEUED_NOTIFICATION_BYTES)
+        {
+            s_dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Resizing zeroes the new bytes, which also null-terminates the
+        // strings and clears the padding.
+        const size_t record_offset = s_pending_records.size();
+        s_pending_records.resize(record_offset + size);
+        uint8_t* const record_start = s_pending_records.data() + record_offset;
+
+        record.header = { type, static_cast<uint32_t>(size) };
+
+        uint32_t string_offset = sizeof(T);
+        for (const auto& [member, value] : strings)
+        {
+            record.*member = { string_offset, static_cast<uint32_t>(value.size()) };
+            memcpy(record_start + string_offset, value.data(), value.size());
+            string_offset += static_cast<uint32_t>(value.size()) + 1;
+        }
+
+        memcpy(record_start, &record, sizeof(T));
+        ++s_pending_count;
+    }
+
+    static void EOS_CALL on_peer_connection_request(const EOS_P2P_OnIncomingConnectionRequestInfo* data)
+    {
+        PeerConnectionRequestNotification record = {};
+        record.local_user_id = data->LocalUserId;
+        record.remote_user_id = data->RemoteUserId;
+
+        const std::string_view socket_name = data->SocketId != nullptr ? to_view(data->SocketId->SocketName) : std::string_view();
+        enqueue(record, NotificationType::PeerConnectionRequest, {
+            { &PeerConnectionRequestNotification::socket_name, socket_name },
+        });
+    }
+
+    static void EOS_CALL on_lobby_update(const EOS_Lobby_LobbyUpdateReceivedCallbackInfo* data)
+    {
+        enqueue(LobbyUpdateNotification{}, NotificationType::LobbyUpdate, {
+            { &LobbyUpdateNotification::lobby_id, to_view(data->LobbyId) },
+        });
+    }
+
+    static void EOS_CALL on_lobby_member_update(const EOS_Lobby_LobbyMemberUpdateReceivedCallbackInfo* data)
+    {
+        LobbyMemberUpdateNotification record = {};
+        record.target_user_id = data->TargetUserId;
+
+        enqueue(record, NotificationType::LobbyMemberUpdate, {
+            { &LobbyMemberUpdateNotification::lobby_id, to_view(data->LobbyId) },
+        });
+    }
+
+    static void EOS_CALL on_lobby_member_status(const EOS_Lobby_LobbyMemberStatusReceivedCallbackInfo* data)
+    {
+        LobbyMemberStatusNotification record = {};
+        record.target_user_id = data->TargetUserId;
+        record.current_status = static_cast<int32_t>(data->CurrentStatus);
+
+        enqueue(record, NotificationType::LobbyMemberStatus, {
+            { &LobbyMemberStatusNotification::lobby_id, to_view(data->LobbyId) },
+        });
+    }
+
+    static void EOS_CALL on_rtc_participant_status(const EOS_RTC_ParticipantStatusChangedCallbackInfo* data)
+    {
+        RTCParticipantStatusNotification record = {};
+        record.local_user_id = data->LocalUserId;
+        record.participant_id = data->ParticipantId;
+        record.participant_status = static_cast<int32_t>(data->ParticipantStatus);
+        record.is_in_blocklist = data->bParticipantInBlocklist == EOS_TRUE ? 1 : 0;
+
+        // Metadata only comes with the first notification of a participant
+        // that joined, so building it here is rare. The buffer keeps its
+        // capacity between notifications.
+        thread_local std::string metadata;
+        metadata.clear();
+        if (data->ParticipantMetadata != nullptr)
+        {
+            for (uint32_t index = 0; index < data->ParticipantMetadataCount; ++index)
+            {
+                metadata.append(to_view(data->ParticipantMetadata[index].Key)).push_back('\0');
+                metadata.append(to_view(data->ParticipantMetadata[index].Value)).push_back('\0');
+            }
+            record.metadata_count = data->ParticipantMetadataCount;
+        }
+
+        // The metadata string ends with the null terminator of the last
+        // value, which enqueue adds.
+        enqueue(record, NotificationType::RTCParticipantStatus, {
+            { &RTCParticipantStatusNotification::room_name, to_view(data->RoomName) },
+            { &RTCParticipantStatusNotification::metadata, metadata.empty() ? std::string_view() : std::string_view(metadata.data(), metadata.size() - 1) },
+        });
+    }
+
+    static void EOS_CALL on_presence_changed(const EOS_Presence_PresenceChangedCallbackInfo* data)
+    {
+        PresenceChangedNotification record = {};
+        record.local_user_id = data->LocalUserId;
+        record.presence_user_id = data->PresenceUserId;
+
+        enqueue(record, NotificationType::PresenceChanged, {});
+    }
+
+    static uint64_t add_subscription(const Subscription& subscription)
+    {
+        std::lock_guard lock(s_subscription_mutex);
+        const uint64_t subscription_id = s_next_subscription_id++;
+        s_subscriptions.emplace(subscription_id, subscription);
+        return subscription_id;
+    }
+
+    static void remove_notifications(const Subscription& subscription)
+    {
+        const EOS_NotificationId* const ids = subscription.notification_ids;
+
+        switch (subscription.kind)
+        {
+        case SubscriptionKind::PeerConnectionRequests:
+        {
+            const EOS_HP2P p2p = EOS_Platform_GetP2PInterface_ptr(subscription.platform);
+            EOS_P2P_RemoveNotifyPeerConnectionRequest_ptr(p2p, ids[0]);
+            break;
+        }
+        case SubscriptionKind::Lobby:
+        {
+            const EOS_HLobby lobby = EOS_Platform_GetLobbyInterface_ptr(subscription.platform);
+            if (ids[0] != EOS_INVALID_NOTIFICATIONID) EOS_Lobby_RemoveNotifyLobbyUpdateReceived_ptr(lobby, ids[0]);
+            if (ids[1] != EOS_INVALID_NOTIFICATIONID) EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_ptr(lobby, ids[1]);
+            if (ids[2] != EOS_INVALID_NOTIFICATIONID) EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_ptr(lobby, ids[2]);
+            break;
+        }
+        case SubscriptionKind::Presence:
+        {
+            const EOS_HPresence presence = EOS_Platform_GetPresenceInterface_ptr(subscription.platform);
+            EOS_Presence_RemoveNotifyOnPresenceChanged_ptr(presence, ids[0]);
+            break;
+        }
+        case SubscriptionKind::RTCParticipantStatus:
+        {
+            const EOS_HRTC rtc = EOS_Platform_GetRTCInterface_ptr(subscription.platform);
+            EOS_RTC_RemoveNotifyParticipantStatusChanged_ptr(rtc, ids[0]);
+            break;
+        }
+        }
+    }
+
+    void remove_all()
+    {
+        std::lock_guard lock(s_subscription_mutex);
+        for (const auto& [subscription_id, subscription] : s_subscriptions)
+        {
+            remove_notifications(subscription);
+        }
+        s_subscriptions.clear();
+    }
+
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueuePeerConnectionRequests(EOS_ProductUserId local_user_id, const char* socket_name)
+    {
+        const EOS_HPlatform platform = platform_registry::get_default();
+        if (platform == nullptr || EOS_Platform_GetP2PInterface_ptr == nullptr
+            || EOS_P2P_AddNotifyPeerConnectionRequest_ptr == nullptr || EOS_P2P_RemoveNotifyPeerConnectionRequest_ptr == nullptr)
+        {
+            return 0;
+        }
+
+        EOS_P2P_SocketId socket_id = {};
+        socket_id.ApiVersion = EOS_P2P_SOCKETID_API_LATEST;
+        if (socket_name != nullptr)
+        {
+            snprintf(socket_id.SocketName, sizeof(socket_id.SocketName), "%s", socket_name);
+        }
+
+        EOS_P2P_AddNotifyPeerConnectionRequestOptions options = {};
+        options.ApiVersion = EOS_P2P_ADDNOTIFYPEERCONNECTIONREQUEST_API_LATEST;
+        options.LocalUserId = local_user_id;
+        options.SocketId = socket_name != nullptr ? &socket_id : nullptr;
+
+        Subscription subscription = { SubscriptionKind::PeerConnectionRequests, platform, {} };
+        subscription.notification_ids[0] = EOS_P2P_AddNotifyPeerConnectionRequest_ptr(EOS_Platform_GetP2PInterface_ptr(platform), &options, nullptr, on_peer_connection_request);
+        if (subscription.notification_ids[0] == EOS_INVALID_NOTIFICATIONID)
+        {
+            return 0;
+        }
+
+        return add_subscription(subscription);
+    }
+
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueueLobbyNotifications()
+    {
+        const EOS_HPlatform platform = platform_registry::get_default();
+        if (platform == nullptr || EOS_Platform_GetLobbyInterface_ptr == nullptr
+            || EOS_Lobby_AddNotifyLobbyUpdateReceived_ptr == nullptr || EOS_Lobby_RemoveNotifyLobbyUpdateReceived_ptr == nullptr
+            || EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_ptr == nullptr || EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived_ptr == nullptr
+            || EOS_Lobby_AddNotifyLobbyMemberStatusReceived_ptr == nullptr || EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived_ptr == nullptr)
+        {
+            return 0;
+        }
+
+        const EOS_HLobby lobby = EOS_Platform_GetLobbyInterface_ptr(platform);
+        Subscription subscription = { SubscriptionKind::Lobby, platform, {} };
+
+        EOS_Lobby_AddNotifyLobbyUpdateReceivedOptions update_options = {};
+        update_options.ApiVersion = EOS_LOBBY_ADDNOTIFYLOBBYUPDATERECEIVED_API_LATEST;
+        subscription.notification_ids[0] = EOS_Lobby_AddNotifyLobbyUpdateReceived_ptr(lobby, &update_options, nullptr, on_lobby_update);
+
+        EOS_Lobby_AddNotifyLobbyMemberUpdateReceivedOptions member_update_options = {};
+        member_update_options.ApiVersion = EOS_LOBBY_ADDNOTIFYLOBBYMEMBERUPDATERECEIVED_API_LATEST;
+        subscription.notification_ids[1] = EOS_Lobby_AddNotifyLobbyMemberUpdateReceived_ptr(lobby, &member_update_options, nullptr, on_lobby_member_update);
+
+        EOS_Lobby_AddNotifyLobbyMemberStatusReceivedOptions member_status_options = {};
+        member_status_options.ApiVersion = EOS_LOBBY_ADDNOTIFYLOBBYMEMBERSTATUSRECEIVED_API_LATEST;
+        subscription.notification_ids[2] = EOS_Lobby_AddNotifyLobbyMemberStatusReceived_ptr(lobby, &member_status_options, nullptr, on_lobby_member_status);
+
+        // Either all three notifications are queued, or none.
+        for (const EOS_NotificationId notification_id : subscription.notification_ids)
+        {
+            if (notification_id == EOS_INVALID_NOTIFICATIONID)
+            {
+                remove_notifications(subscription);
+                return 0;
+            }
+        }
+
+        return add_subscription(subscription);
+    }
+
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueuePresenceNotifications()
+    {
+        const EOS_HPlatform platform = platform_registry::get_default();
+        if (platform == nullptr || EOS_Platform_GetPresenceInterface_ptr == nullptr
+            || EOS_Presence_AddNotifyOnPresenceChanged_ptr == nullptr || EOS_Presence_RemoveNotifyOnPresenceChanged_ptr == nullptr)
+        {
+            return 0;
+        }
+
+        EOS_Presence_AddNotifyOnPresenceChangedOptions options = {};
+        options.ApiVersion = EOS_PRESENCE_ADDNOTIFYONPRESENCECHANGED_API_LATEST;
+
+        Subscription subscription = { SubscriptionKind::Presence, platform, {} };
+        subscription.notification_ids[0] = EOS_Presence_AddNotifyOnPresenceChanged_ptr(EOS_Platform_GetPresenceInterface_ptr(platform), &options, nullptr, on_presence_changed);
+        if (subscription.notification_ids[0] == EOS_INVALID_NOTIFICATIONID)
+        {
+            return 0;
+        }
+
+        return add_subscription(subscription);
+    }
+
+    PEW_EOS_API_FUNC(uint64_t) PEW_EOS_QueueRTCParticipantStatus(EOS_ProductUserId local_user_id, const char* room_name)
+    {
+        const EOS_HPlatform platform = platform_registry::get_default();
+        if (platform == nullptr || room_name == nullptr || EOS_Platform_GetRTCInterface_ptr == nullptr
+            || EOS_RTC_AddNotifyParticipantStatusChanged_ptr == nullptr || EOS_RTC_RemoveNotifyParticipantStatusChanged_ptr == nullptr)
+        {
+            return 0;
+        }
+
+        // The RTC interface is null when the platform was created without
+        // RTC options.
+        const EOS_HRTC rtc = EOS_Platform_GetRTCInterface_ptr(platform);
+        if (rtc == nullptr)
+        {
+            return 0;
+        }
+
+        EOS_RTC_AddNotifyParticipantStatusChangedOptions options = {};
+        options.ApiVersion = EOS_RTC_ADDNOTIFYPARTICIPANTSTATUSCHANGED_API_LATEST;
+        options.LocalUserId = local_user_id;
+        options.RoomName = room_name;
+
+        Subscription subscription = { SubscriptionKind::RTCParticipantStatus, platform, {} };
+        subscription.notification_ids[0] = EOS_RTC_AddNotifyParticipantStatusChanged_ptr(rtc, &options, nullptr, on_rtc_participant_status);
+        if (subscription.notification_ids[0] == EOS_INVALID_NOTIFICATIONID)
+        {
+            return 0;
+        }
+
+        return add_subscription(subscription);
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_RemoveQueuedNotifications(uint64_t subscription_id)
+    {
+        std::lock_guard lock(s_subscription_mutex);
+
+        const auto subscription = s_subscriptions.find(subscription_id);
+        if (subscription == s_subscriptions.end())
+        {
+            return;
+        }
+
+        remove_notifications(subscription->second);
+        s_subscriptions.erase(subscription);
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_DrainNotifications(NotificationBatch* batch)
+    {
+        if (batch == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard lock(s_queue_mutex);
+
+        // The records handed out by the previous drain are no longer in use.
+        s_drained_records.clear();
+        std::swap(s_drained_records, s_pending_records);
+
+        batch->data = s_drained_records.empty() ? nullptr : s_drained_records.data();
+        batch->length = static_cast<uint32_t>(s_drained_records.size());
+        batch->count = s_pending_count;
+        batch->dropped_count = s_dropped_count.load(std::memory_order_relaxed);
+
+        s_pending_count = 0;
+    }
+}
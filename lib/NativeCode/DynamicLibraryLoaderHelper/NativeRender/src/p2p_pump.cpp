@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pch.h>
+#include "p2p_pump.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "eos_library_helpers.h"
+#include "platform_registry.h"
+
+namespace pew::eos::p2p_pump
+{
+    using namespace eos_library_helpers;
+
+    /**
+     * @brief The number of channels a packet can be sent on.
+     */
+    constexpr uint32_t CHANNEL_COUNT = 256;
+
+    /**
+     * @brief A packet, as EOS_P2P_ReceivePacket writes it.
+     */
+    struct ReceivedPacket
+    {
+        EOS_ProductUserId peer_id;
+        EOS_P2P_SocketId socket_id;
+        uint32_t size;
+        uint8_t channel;
+        uint8_t data[EOS_P2P_MAX_PACKET_SIZE];
+    };
+
+    /**
+     * @brief Single-producer single-consumer ring of the packets received on
+     * one channel. Each slot has a buffer of its own for the payload, so
+     * pushing and popping packets never allocates.
+     */
+    class ChannelRing
+    {
+    public:
+        ChannelRing() : _payloads(static_cast<size_t>(PACKETS_PER_CHANNEL) * EOS_P2P_MAX_PACKET_SIZE)
+        {
+        }
+
+        /**
+         * @brief Copies a packet into the ring. Called by the producer only.
+         *
+         * @return `false` if the ring is full.
+         */
+        bool try_push(const ReceivedPacket& packet)
+        {
+            const uint32_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head.load(std::memory_order_acquire) == PACKETS_PER_CHANNEL)
+            {
+                return false;
+            }
+
+            Slot& slot = _slots[tail % PACKETS_PER_CHANNEL];
+            slot.peer_id = packet.peer_id;
+            slot.size = packet.size;
+            memcpy(slot.socket_name, packet.socket_id.SocketName, sizeof(slot.socket_name));
+            slot.socket_name[sizeof(slot.socket_name) - 1] = '\0';
+            memcpy(get_payload(tail), packet.data, packet.size);
+
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Calls the given function for each packet in the ring, in the
+         * order they were pushed, and empties the ring. Called by the
+         * consumer only.
+         */
+        template <typename Consumer>
+        void pop_all(Consumer&& consume)
+        {
+            const uint32_t head = _head.load(std::memory_order_relaxed);
+            const uint32_t tail = _tail.load(std::memory_order_acquire);
+            if (head == tail)
+            {
+                return;
+            }
+
+            for (uint32_t index = head; index != tail; ++index)
+            {
+                const Slot& slot = _slots[index % PACKETS_PER_CHANNEL];
+                consume(slot.peer_id, slot.socket_name, get_payload(index), slot.size);
+            }
+
+            _head.store(tail, std::memory_order_release);
+        }
+
+    private:
+        struct Slot
+        {
+            EOS_ProductUserId peer_id;
+            uint32_t size;
+            char socket_name[EOS_P2P_SOCKETID_SOCKETNAME_SIZE];
+        };
+
+        uint8_t* get_payload(uint32_t index)
+        {
+            return _payloads.data() + static_cast<size_t>(index % PACKETS_PER_CHANNEL) * EOS_P2P_MAX_PACKET_SIZE;
+        }
+
+        std::vector<uint8_t> _payloads;
+        Slot _slots[PACKETS_PER_CHANNEL];
+
+        // The indices only ever increase, and wrap around together. They are
+        // kept on separate cache lines, since each is written by a different
+        // thread.
+        alignas(64) std::atomic<uint32_t> _head = 0;
+        alignas(64) std::atomic<uint32_t> _tail = 0;
+    };
+
+    // The producer state: whichever thread ticks the default platform
+    // receives packets while holding the mutex, so the rings always see a
+    // single producer at a time. The platform is also kept in an atomic, so
+    // that ticks of other platforms can be skipped without locking.
+    std::mutex s_pump_mutex;
+    std::atomic<EOS_HPlatform> s_pumped_platform = nullptr;
+    EOS_HP2P s_p2p_handle = nullptr;
+    EOS_ProductUserId s_local_user_id = nullptr;
+    std::vector<std::unique_ptr<ChannelRing>> s_ring_storage;
+
+    // A packet that was received, but did not fit into the ring of its
+    // channel. It is pushed before any other packet is received.
+    ReceivedPacket s_held_packet;
+    bool s_is_packet_held = false;
+
+    // The ring of each channel, created by the producer when the channel
+    // first receives a packet.
+    std::atomic<ChannelRing*> s_rings[CHANNEL_COUNT] = {};
+
+    // The consumer state. The batch stays valid until the next drain; the
+    // capacity of the buffers is reused, so once they have grown draining
+    // does not allocate.
+    std::mutex s_drain_mutex;
+    std::vector<PacketDescriptor> s_descriptors;
+    std::vector<uint8_t> s_payload_arena;
+    std::vector<uint32_t> s_socket_name_offsets;
+
+    /**
+     * @brief Gets the ring of a channel, creating it if needed. The caller
+     * must hold s_pump_mutex.
+     */
+    static ChannelRing& get_ring(uint8_t channel)
+    {
+        ChannelRing* ring = s_rings[channel].load(std::memory_order_relaxed);
+        if (ring == nullptr)
+        {
+            ring = s_ring_storage.emplace_back(std::make_unique<ChannelRing>()).get();
+            s_rings[channel].store(ring, std::memory_order_release);
+        }
+        return *ring;
+    }
+
+    /**
+     * @brief Receives packets until the SDK holds none, or until the ring of
+     * a channel is full. The caller must hold s_pump_mutex.
+     */
+    static void receive_packets()
+    {
+        if (s_is_packet_held)
+        {
+            if (!get_ring(s_held_packet.channel).try_push(s_held_packet))
+            {
+                return;
+            }
+            s_is_packet_held = false;
+        }
+
+        if (s_p2p_handle == nullptr)
+        {
+            return;
+        }
+
+        EOS_P2P_ReceivePacketOptions options = {};
+        options.ApiVersion = EOS_P2P_RECEIVEPACKET_API_LATEST;
+        options.LocalUserId = s_local_user_id;
+        options.MaxDataSizeBytes = EOS_P2P_MAX_PACKET_SIZE;
+        options.RequestedChannel = nullptr;
+
+        while (EOS_P2P_ReceivePacket_ptr(s_p2p_handle, &options, &s_held_packet.peer_id, &s_held_packet.socket_id,
+            &s_held_packet.channel, s_held_packet.data, &s_held_packet.size) == EOS_EResult::EOS_Success)
+        {
+            if (!get_ring(s_held_packet.channel).try_push(s_held_packet))
+            {
+                s_is_packet_held = true;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the offset of the given socket name in the payload
+     * arena, adding it if it is not in the arena yet.
+     */
+    static uint32_t add_socket_name(const char* socket_name)
+    {
+        // A batch rarely holds packets of more than a few sockets.
+        for (const uint32_t offset : s_socket_name_offsets)
+        {
+            if (strcmp(reinterpret_cast<const char*>(s_payload_arena.data() + offset), socket_name) == 0)
+            {
+                return offset;
+            }
+        }
+
+        const auto offset = static_cast<uint32_t>(s_payload_arena.size());
+        s_payload_arena.insert(s_payload_arena.end(), socket_name, socket_name + strlen(socket_name) + 1);
+        s_socket_name_offsets.push_back(offset);
+        return offset;
+    }
+
+    void pump(EOS_HPlatform platform)
+    {
+        if (platform == nullptr || s_pumped_platform.load(std::memory_order_relaxed) != platform)
+        {
+            return;
+        }
+
+        std::lock_guard lock(s_pump_mutex);
+        if (s_pumped_platform.load(std::memory_order_relaxed) == platform)
+        {
+            receive_packets();
+        }
+    }
+
+    void stop()
+    {
+        std::lock_guard lock(s_pump_mutex);
+        s_pumped_platform.store(nullptr, std::memory_order_relaxed);
+        s_p2p_handle = nullptr;
+        s_local_user_id = nullptr;
+        s_is_packet_held = false;
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_P2P_StartReceivePump(EOS_ProductUserId local_user_id)
+    {
+        const EOS_HPlatform platform = platform_registry::get_default();
+        if (local_user_id == nullptr || platform == nullptr
+            || EOS_Platform_GetP2PInterface_ptr == nullptr || EOS_P2P_ReceivePacket_ptr == nullptr)
+        {
+            return false;
+        }
+
+        const EOS_HP2P p2p_handle = EOS_Platform_GetP2PInterface_ptr(platform);
+        if (p2p_handle == nullptr)
+        {
+            return false;
+        }
+
+        std::lock_guard lock(s_pump_mutex);
+        s_p2p_handle = p2p_handle;
+        s_local_user_id = local_user_id;
+        s_pumped_platform.store(platform, std::memory_order_relaxed);
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_P2P_StopReceivePump()
+    {
+        stop();
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_P2P_PumpAfterTick()
+    {
+        pump(s_pumped_platform.load(std::memory_order_relaxed));
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_P2P_DrainBatch(PacketBatch* batch)
+    {
+        if (batch == nullptr)
+        {
+            return;
+        }
+
+        // Only the rings are read here. The SDK is called by the thread that
+        // ticks the platform, after the tick, and may be inside a tick now.
+        std::lock_guard lock(s_drain_mutex);
+
+        // The packets handed out by the previous drain are no longer in use.
+        s_descriptors.clear();
+        s_payload_arena.clear();
+        s_socket_name_offsets.clear();
+
+        for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+        {
+            ChannelRing* ring = s_rings[channel].load(std::memory_order_acquire);
+            if (ring == nullptr)
+            {
+                continue;
+            }
+
+            ring->pop_all([channel](EOS_ProductUserId peer_id, const char* socket_name, const uint8_t* payload, uint32_t size)
+            {
+                PacketDescriptor descriptor = {};
+                descriptor.peer_id = peer_id;
+                descriptor.socket_name_offset = add_socket_name(socket_name);
+                descriptor.payload_offset = static_cast<uint32_t>(s_payload_arena.size());
+                descriptor.payload_size = size;
+                descriptor.channel = static_cast<uint8_t>(channel);
+                s_descriptors.push_back(descriptor);
+
+                s_payload_arena.insert(s_payload_arena.end(), payload, payload + size);
+            });
+        }
+
+        batch->descriptors = s_descriptors.empty() ? nullptr : s_descriptors.data();
+        batch->descriptor_count = static_cast<uint32_t>(s_descriptors.size());
+        batch->payload_arena = s_payload_arena.empty() ? nullptr : s_payload_arena.data();
+        batch->payload_size = static_cast<uint32_t>(s_payload_arena.size());
+    }
+}
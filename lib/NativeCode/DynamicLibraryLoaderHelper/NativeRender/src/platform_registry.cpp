@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "platform_registry.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "eos_helpers.h"
+#include "eos_library_helpers.h"
+#include "logging.h"
+#include "notification_queue.h"
+#include "p2p_pump.h"
+#include "shutdown.h"
+#include "tick_driver.h"
+#include "Config/NativePlatformConfig.hpp"
+#include "Config/ProductConfig.hpp"
+
+namespace pew::eos::platform_registry
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct PlatformInstance
+    {
+        EOS_HPlatform handle;
+
+        /**
+         * @brief Time between two ticks, or zero if the platform is not
+         * ticked by the registry.
+         */
+        Clock::duration tick_interval;
+        Clock::time_point next_tick_time;
+    };
+
+    std::mutex s_registry_mutex;
+    std::unordered_map<PlatformId, PlatformInstance> s_platforms;
+    PlatformId s_next_platform_id = DEFAULT_PLATFORM_ID + 1;
+
+    // The platforms that are being ticked, on any thread. A platform is not
+    // released until it is no longer in the list; s_tick_done_condition is
+    // notified whenever a tick ends.
+    std::vector<EOS_HPlatform> s_ticking_platforms;
+    std::condition_variable s_tick_done_condition;
+
+    // The platform the current thread is ticking, so that releasing it from
+    // one of its own callbacks can be refused instead of waiting forever.
+    thread_local EOS_HPlatform t_ticking_platform = nullptr;
+
+    static Clock::duration get_tick_interval(uint32_t ticks_per_second)
+    {
+        if (ticks_per_second == 0)
+        {
+            return Clock::duration::zero();
+        }
+
+        ticks_per_second = std::min(ticks_per_second, tick_driver::MAX_TICKS_PER_SECOND);
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1'000'000'000 / ticks_per_second));
+    }
+
+    static EOS_HPlatform create_platform(const config_snapshot::ConfigSnapshot& snapshot)
+    {
+        const auto platform_config = config::Config::get<config::NativePlatformConfig>();
+        const auto product_config = config::Config::get<config::ProductConfig>();
+        if (platform_config == nullptr || product_config == nullptr)
+        {
+            logging::log_error("Could not read the configs to create an additional EOS SDK Platform.");
+            return nullptr;
+        }
+
+        // The configs supply what the snapshot does not carry, such as the
+        // RTC and integrated platform options; the snapshot decides the rest.
+        EOS_Platform_Options platform_options = get_create_options(*platform_config, *product_config);
+
+        const auto get_string = [&snapshot](config_snapshot::ConfigSnapshotString value)
+        {
+            return config_snapshot::get_string(snapshot, value).data();
+        };
+        const auto get_optional_string = [&snapshot](config_snapshot::ConfigSnapshotString value)
+        {
+            return value.length > 0 ? config_snapshot::get_string(snapshot, value).data() : nullptr;
+        };
+
+        platform_options.bIsServer = snapshot.is_server != 0 ? EOS_TRUE : EOS_FALSE;
+        platform_options.Flags = static_cast<uint64_t>(snapshot.platform_options_flags);
+        platform_options.CacheDirectory = get_string(snapshot.cache_directory);
+        platform_options.EncryptionKey = get_string(snapshot.encryption_key);
+        platform_options.OverrideCountryCode = get_optional_string(snapshot.override_country_code);
+        platform_options.OverrideLocaleCode = get_optional_string(snapshot.override_locale_code);
+        platform_options.ProductId = get_string(snapshot.product_id);
+        platform_options.SandboxId = get_string(snapshot.sandbox_id);
+        platform_options.DeploymentId = get_string(snapshot.deployment_id);
+        platform_options.ClientCredentials.ClientId = get_string(snapshot.client_id);
+        platform_options.ClientCredentials.ClientSecret = get_string(snapshot.client_secret);
+        platform_options.TickBudgetInMilliseconds = static_cast<uint32_t>(std::max(snapshot.tick_budget_in_milliseconds, 0));
+
+        delete platform_options.TaskNetworkTimeoutSeconds;
+        platform_options.TaskNetworkTimeoutSeconds = snapshot.task_network_timeout_seconds > 0 ? new double(snapshot.task_network_timeout_seconds) : nullptr;
+
+        const EOS_HPlatform platform = eos_library_helpers::EOS_Platform_Create_ptr(&platform_options);
+
+        release_create_options(platform_options);
+
+        return platform;
+    }
+
+    bool set_default(EOS_HPlatform platform)
+    {
+        std::lock_guard lock(s_registry_mutex);
+        return s_platforms.emplace(DEFAULT_PLATFORM_ID, PlatformInstance{ platform, Clock::duration::zero(), Clock::time_point() }).second;
+    }
+
+    PlatformId create(const config_snapshot::ConfigSnapshot& snapshot, uint32_t ticks_per_second)
+    {
+        if (eos_library_helpers::EOS_Platform_Create_ptr == nullptr || shutdown::is_shutting_down())
+        {
+            return 0;
+        }
+
+        const EOS_HPlatform platform = create_platform(snapshot);
+        if (platform == nullptr)
+        {
+            logging::log_error("Failed to create an additional EOS SDK Platform.");
+            return 0;
+        }
+
+        const Clock::duration tick_interval = get_tick_interval(ticks_per_second);
+
+        std::lock_guard lock(s_registry_mutex);
+        const PlatformId platform_id = s_next_platform_id++;
+        s_platforms.emplace(platform_id, PlatformInstance{ platform, tick_interval, Clock::now() });
+
+        logging::log_inform("Created EOS SDK Platform " + std::to_string(platform_id) + (snapshot.is_server != 0 ? " (server)." : "."));
+        return platform_id;
+    }
+
+    EOS_HPlatform get(PlatformId platform_id)
+    {
+        std::lock_guard lock(s_registry_mutex);
+        const auto platform = s_platforms.find(platform_id);
+        return platform != s_platforms.end() ? platform->second.handle : nullptr;
+    }
+
+    EOS_HPlatform get_default()
+    {
+        return get(DEFAULT_PLATFORM_ID);
+    }
+
+    bool set_tick_rate(PlatformId platform_id, uint32_t ticks_per_second)
+    {
+        std::lock_guard lock(s_registry_mutex);
+        const auto platform = s_platforms.find(platform_id);
+        if (platform == s_platforms.end())
+        {
+            return false;
+        }
+
+        platform->second.tick_interval = get_tick_interval(ticks_per_second);
+        platform->second.next_tick_time = Clock::now();
+        return true;
+    }
+
+    /**
+     * @brief Ticks the given platforms, skipping the ones that were released
+     * in the meantime. The lock is not held during a tick, so that SDK
+     * callbacks can use the registry; instead, the platform is marked as
+     * being ticked, and release waits for the tick to end.
+     */
+    static void tick_platforms(const std::vector<PlatformId>& platform_ids)
+    {
+        if (eos_library_helpers::EOS_Platform_Tick_ptr == nullptr)
+        {
+            return;
+        }
+
+        for (const PlatformId platform_id : platform_ids)
+        {
+            EOS_HPlatform platform = nullptr;
+            {
+                std::lock_guard lock(s_registry_mutex);
+                const auto instance = s_platforms.find(platform_id);
+                if (instance == s_platforms.end())
+                {
+                    continue;
+                }
+
+                platform = instance->second.handle;
+                s_ticking_platforms.push_back(platform);
+            }
+
+            t_ticking_platform = platform;
+            eos_library_helpers::EOS_Platform_Tick_ptr(platform);
+            p2p_pump::pump(platform);
+            t_ticking_platform = nullptr;
+
+            {
+                std::lock_guard lock(s_registry_mutex);
+                s_ticking_platforms.erase(std::find(s_ticking_platforms.begin(), s_ticking_platforms.end(), platform));
+            }
+            s_tick_done_condition.notify_all();
+        }
+    }
+
+    Clock::time_point tick_due()
+    {
+        // The list keeps its capacity between calls.
+        thread_local std::vector<PlatformId> due_platforms;
+        due_platforms.clear();
+
+        Clock::time_point next_due_time = Clock::time_point::max();
+        {
+            std::lock_guard lock(s_registry_mutex);
+            const Clock::time_point now = Clock::now();
+
+            for (auto& [platform_id, platform] : s_platforms)
+            {
+                if (platform.tick_interval == Clock::duration::zero())
+                {
+                    continue;
+                }
+
+                if (platform.next_tick_time <= now)
+                {
+                    due_platforms.push_back(platform_id);
+
+                    platform.next_tick_time += platform.tick_interval;
+                    if (platform.next_tick_time <= now)
+                    {
+                        const auto missed_ticks = (now - platform.next_tick_time) / platform.tick_interval + 1;
+                        platform.next_tick_time += missed_ticks * platform.tick_interval;
+                    }
+                }
+
+                next_due_time = std::min(next_due_time, platform.next_tick_time);
+            }
+        }
+
+        tick_platforms(due_platforms);
+        return next_due_time;
+    }
+
+    void tick_all()
+    {
+        thread_local std::vector<PlatformId> platform_ids;
+        platform_ids.clear();
+        {
+            std::lock_guard lock(s_registry_mutex);
+            for (const auto& [platform_id, platform] : s_platforms)
+            {
+                platform_ids.push_back(platform_id);
+            }
+        }
+
+        tick_platforms(platform_ids);
+    }
+
+    bool release(PlatformId platform_id)
+    {
+        EOS_HPlatform platform = nullptr;
+        {
+            std::unique_lock lock(s_registry_mutex);
+            const auto instance = s_platforms.find(platform_id);
+            if (instance == s_platforms.end())
+            {
+                return false;
+            }
+
+            platform = instance->second.handle;
+            if (platform == t_ticking_platform)
+            {
+                logging::log_error("EOS SDK Platform " + std::to_string(platform_id) + " cannot be released from one of its own callbacks.");
+                return false;
+            }
+
+            // Once the platform is out of the map no new tick can start, but
+            // one may be running on another thread.
+            s_platforms.erase(instance);
+            s_tick_done_condition.wait(lock, [platform]
+            {
+                return std::find(s_ticking_platforms.begin(), s_ticking_platforms.end(), platform) == s_ticking_platforms.end();
+            });
+        }
+
+        // Nothing may use the default platform once it is released.
+        if (platform_id == DEFAULT_PLATFORM_ID)
+        {
+            tick_driver::stop();
+            notification_queue::remove_all();
+            p2p_pump::stop();
+        }
+
+        if (eos_library_helpers::EOS_Platform_Release_ptr != nullptr)
+        {
+            eos_library_helpers::EOS_Platform_Release_ptr(platform);
+        }
+
+        logging::log_inform("Released EOS SDK Platform " + std::to_string(platform_id) + ".");
+        return true;
+    }
+
+    void release_created()
+    {
+        std::vector<PlatformId> platform_ids;
+        {
+            std::lock_guard lock(s_registry_mutex);
+            for (const auto& [platform_id, platform] : s_platforms)
+            {
+                if (platform_id != DEFAULT_PLATFORM_ID)
+                {
+                    platform_ids.push_back(platform_id);
+                }
+            }
+        }
+
+        for (const PlatformId platform_id : platform_ids)
+        {
+            release(platform_id);
+        }
+    }
+
+    void release_all()
+    {
+        release_created();
+        release(DEFAULT_PLATFORM_ID);
+    }
+
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_CreatePlatform(const config_snapshot::ConfigSnapshot* snapshot, uint32_t ticks_per_second)
+    {
+        if (!config_snapshot::is_valid(snapshot))
+        {
+            logging::log_error("Cannot create an EOS SDK Platform from an invalid config snapshot.");
+            return 0;
+        }
+
+        return create(*snapshot, ticks_per_second);
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_ReleasePlatform(uint32_t platform_id)
+    {
+        return release(platform_id);
+    }
+
+    PEW_EOS_API_FUNC(void*) PEW_EOS_GetPlatform(uint32_t platform_id)
+    {
+        return get(platform_id);
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_SetPlatformTickRate(uint32_t platform_id, uint32_t ticks_per_second)
+    {
+        return set_tick_rate(platform_id, ticks_per_second);
+    }
+
+    PEW_EOS_API_FUNC(uint32_t) PEW_EOS_TickPlatforms()
+    {
+        const Clock::time_point next_due_time = tick_due();
+        if (next_due_time == Clock::time_point::max())
+        {
+            return UINT32_MAX;
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(next_due_time - Clock::now()).count();
+        return static_cast<uint32_t>(std::clamp<decltype(wait)>(wait, 0, UINT32_MAX - 1));
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "shutdown.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "config_watcher.h"
+#include "eos_library_helpers.h"
+#include "flight_recorder.h"
+#include "logging.h"
+#include "platform_registry.h"
+#include "tick_driver.h"
+
+namespace pew::eos::shutdown
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Time between two ticks while waiting for pending requests.
+     */
+    constexpr std::chrono::milliseconds DRAIN_TICK_INTERVAL(1);
+
+    std::atomic<bool> s_shutting_down = false;
+    std::atomic<uint32_t> s_pending_request_count = 0;
+
+    static uint64_t to_microseconds(Clock::duration duration)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
+    static std::string to_milliseconds_string(uint64_t microseconds)
+    {
+        return std::to_string(microseconds / 1000) + "." + std::to_string(microseconds / 100 % 10) + " ms";
+    }
+
+    bool is_shutting_down()
+    {
+        return s_shutting_down.load(std::memory_order_relaxed);
+    }
+
+    bool run(uint32_t deadline_in_milliseconds, bool shutdown_sdk, ShutdownReport* report)
+    {
+        if (s_shutting_down.exchange(true))
+        {
+            return false;
+        }
+
+        logging::log_inform("Shutting down EOS.");
+
+        ShutdownReport result = {};
+        const Clock::time_point shutdown_start = Clock::now();
+        Clock::time_point stage_start = shutdown_start;
+
+        const auto end_stage = [&stage_start](uint64_t& stage_microseconds)
+        {
+            const Clock::time_point now = Clock::now();
+            stage_microseconds = to_microseconds(now - stage_start);
+            stage_start = now;
+        };
+
+        // Nothing may tick the platforms behind the shutdown's back, or
+        // recreate anything while the platforms are released.
+        tick_driver::stop();
+        config_watcher::stop();
+        end_stage(result.stop_requests_microseconds);
+
+        // Tick at least once, so that work queued by the last frame is sent.
+        const Clock::time_point deadline = stage_start + std::chrono::milliseconds(deadline_in_milliseconds);
+        while (true)
+        {
+            platform_registry::tick_all();
+            ++result.drain_tick_count;
+
+            if (s_pending_request_count.load(std::memory_order_acquire) == 0)
+            {
+                break;
+            }
+
+            if (Clock::now() + DRAIN_TICK_INTERVAL > deadline)
+            {
+                result.timed_out = 1;
+                break;
+            }
+
+            std::this_thread::sleep_for(DRAIN_TICK_INTERVAL);
+        }
+        result.pending_request_count = s_pending_request_count.load(std::memory_order_acquire);
+        end_stage(result.drain_microseconds);
+
+        flight_recorder::flush();
+        end_stage(result.flush_log_microseconds);
+
+        platform_registry::release_all();
+        end_stage(result.release_platforms_microseconds);
+
+        if (shutdown_sdk && eos_library_helpers::EOS_Shutdown_ptr != nullptr)
+        {
+            eos_library_helpers::EOS_Shutdown_ptr();
+            result.sdk_shut_down = 1;
+        }
+        end_stage(result.shutdown_sdk_microseconds);
+
+        result.total_microseconds = to_microseconds(stage_start - shutdown_start);
+
+        if (result.timed_out)
+        {
+            logging::log_warn(std::to_string(result.pending_request_count) + " pending request(s) did not complete before the shutdown deadline.");
+        }
+
+        logging::log_inform("Shut down EOS in " + to_milliseconds_string(result.total_microseconds) +
+            " (stopping requests " + to_milliseconds_string(result.stop_requests_microseconds) +
+            ", draining " + to_milliseconds_string(result.drain_microseconds) + " over " + std::to_string(result.drain_tick_count) + " tick(s)" +
+            ", flushing the log " + to_milliseconds_string(result.flush_log_microseconds) +
+            ", releasing platforms " + to_milliseconds_string(result.release_platforms_microseconds) +
+            ", shutting down the SDK " + to_milliseconds_string(result.shutdown_sdk_microseconds) + ").");
+
+        if (report != nullptr)
+        {
+            *report = result;
+        }
+
+        // Once EOS_Shutdown has been called the SDK cannot be used again, so
+        // the shutdown stays in effect. Otherwise only the platforms are gone,
+        // and new ones may be created (for instance to host the next match).
+        if (!result.sdk_shut_down)
+        {
+            s_pending_request_count.store(0, std::memory_order_release);
+            s_shutting_down.store(false);
+        }
+
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_BeginPendingRequest()
+    {
+        if (is_shutting_down())
+        {
+            return false;
+        }
+
+        s_pending_request_count.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_EndPendingRequest()
+    {
+        uint32_t pending_request_count = s_pending_request_count.load(std::memory_order_relaxed);
+        while (pending_request_count > 0
+            && !s_pending_request_count.compare_exchange_weak(pending_request_count, pending_request_count - 1, std::memory_order_acq_rel))
+        {
+        }
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_Shutdown(uint32_t deadline_in_milliseconds, bool shutdown_sdk, ShutdownReport* report)
+    {
+        return run(deadline_in_milliseconds, shutdown_sdk, report);
+    }
+}
@@ -22,46 +22,47 @@
 
 #include <pch.h>
 #include <algorithm>
-#include <codecvt>
+#include <climits>
+#include <cmath>
+#include <cstring>
 #include <ctime>
-#include <locale>
-#include <sstream>
+#include <cwchar>
 #include <filesystem>
 #include "string_helpers.h"
+#include "utf_transcode.h"
 
 namespace pew::eos::string_helpers
 {
     std::string trim(const std::string& str)
     {
-        const auto start = std::find_if_not(str.begin(), str.end(), ::isspace);
-        const auto end = std::find_if_not(str.rbegin(), str.rend(), ::isspace).base();
-
-        if (start < end)
-        {
-            return std::basic_string<char>(start, end);
-        }
-        else
-        {
-            return "";
-        }
+        return std::string(trim_view(str));
     }
 
     std::vector<std::string> split_and_trim(const std::string& input, char delimiter)
     {
         std::vector<std::string> result;
-        std::stringstream ss(input);
-        std::string item;
+        for_each_token(input, delimiter, [&result](std::string_view token)
+        {
+            result.emplace_back(token);
+        });
 
-        while (std::getline(ss, item, delimiter))
+        return result;
+    }
+
+    std::string_view trim_view(std::string_view str)
+    {
+        const auto is_space = [](char character) { return std::isspace(static_cast<unsigned char>(character)) != 0; };
+
+        while (!str.empty() && is_space(str.front()))
         {
-            std::string trimmedItem = trim(item);
-            if (!trimmedItem.empty())
-            {
-                result.push_back(trimmedItem);
-            }
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && is_space(str.back()))
+        {
+            str.remove_suffix(1);
         }
 
-        return result;
+        return str;
     }
 
     bool create_timestamp_str(char* final_timestamp, size_t final_timestamp_len)
@@ -79,7 +80,11 @@ namespace pew::eos::string_helpers
 
         timespec time_spec = { 0 };
         timespec_get(&time_spec, TIME_UTC);
+#if PLATFORM_WINDOWS
         localtime_s(&time_info, &raw_time);
+#else
+        localtime_r(&raw_time, &time_info);
+#endif
 
         strftime(buffer, buffer_len, "%Y-%m-%dT%H:%M:%S", &time_info);
         long milliseconds = (long)round(time_spec.tv_nsec / 1.0e6);
@@ -90,14 +95,10 @@ namespace pew::eos::string_helpers
 
     size_t utf8_str_bytes_required_for_wide_str(const wchar_t* wide_str, int wide_str_len)
     {
-        int bytes_required = WideCharToMultiByte(CP_UTF8, 0, wide_str, wide_str_len, NULL, 0, NULL, NULL);
-
-        if (bytes_required < 0)
-        {
-            return 0;
-        }
-
-        return bytes_required;
+        // Like WideCharToMultiByte, a negative length converts the whole
+        // null-terminated string, including the terminator.
+        const size_t length = wide_str_len < 0 ? wcslen(wide_str) + 1 : static_cast<size_t>(wide_str_len);
+        return wide_to_utf8(wide_str, length, nullptr, 0).written;
     }
 
     // wide_str must be null terminated if wide_str_len is passed
@@ -108,21 +109,21 @@ namespace pew::eos::string_helpers
             return false;
         }
 
-        WideCharToMultiByte(CP_UTF8, 0, wide_str, wide_str_len, utf8_str, (int)utf8_str_len, NULL, NULL);
-
-        return true;
+        const size_t length = wide_str_len < 0 ? wcslen(wide_str) + 1 : static_cast<size_t>(wide_str_len);
+        return wide_to_utf8(wide_str, length, utf8_str, utf8_str_len).read == length;
     }
 
     char* create_utf8_str_from_wide_str(const wchar_t* wide_str)
     {
-        const int wide_str_len = (int)wcslen(wide_str) + 1;
-        int bytes_required = (int)utf8_str_bytes_required_for_wide_str(wide_str, wide_str_len);
-        char* to_return = (char*)malloc(bytes_required);
+        // Sizing the buffer for the worst case lets the string be converted
+        // in a single pass.
+        const size_t wide_str_len = wcslen(wide_str) + 1;
+        const size_t capacity = max_utf8_length_for_wide(wide_str_len);
+        char* to_return = (char*)malloc(capacity);
 
-        if (!copy_to_utf8_str_from_wide_str(to_return, bytes_required, wide_str, wide_str_len))
+        if (to_return != NULL)
         {
-            free(to_return);
-            to_return = NULL;
+            wide_to_utf8(wide_str, wide_str_len, to_return, capacity);
         }
 
         return to_return;
@@ -130,26 +131,35 @@ namespace pew::eos::string_helpers
 
     wchar_t* create_wide_str_from_utf8_str(const char* utf8_str)
     {
-        int chars_required = MultiByteToWideChar(CP_UTF8, 0, utf8_str, -1, NULL, 0);
-        wchar_t* to_return = (wchar_t*)malloc(chars_required * sizeof(wchar_t));
-        int utf8_str_len = (int)strlen(utf8_str);
+        const size_t utf8_str_len = strlen(utf8_str) + 1;
+        const size_t capacity = max_wide_length_for_utf8(utf8_str_len);
+        wchar_t* to_return = (wchar_t*)malloc(capacity * sizeof(wchar_t));
 
-        MultiByteToWideChar(CP_UTF8, 0, utf8_str, utf8_str_len, to_return, chars_required);
+        if (to_return != NULL)
+        {
+            utf8_to_wide(utf8_str, utf8_str_len, to_return, capacity);
+        }
 
         return to_return;
     }
 
     std::string to_utf8_str(const std::wstring& wide_str)
     {
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-        std::string utf8_str = converter.to_bytes(wide_str);
+        std::string utf8_str(max_utf8_length_for_wide(wide_str.size()), '\0');
+        const TranscodeResult result = wide_to_utf8(wide_str.data(), wide_str.size(), utf8_str.data(), utf8_str.size());
+        utf8_str.resize(result.written);
 
         return utf8_str;
     }
 
     std::string to_utf8_str(const std::filesystem::path& path)
     {
+#if PLATFORM_WINDOWS
         return to_utf8_str(path.native());
+#else
+        // Paths are already stored as (UTF-8) narrow strings.
+        return path.native();
+#endif
     }
 
     bool is_empty_or_whitespace(const char* str)
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "tick_controller.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "eos_library_helpers.h"
+#include "p2p_pump.h"
+#include "platform_registry.h"
+#include "tick_driver.h"
+
+namespace pew::eos::tick_controller
+{
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    /**
+     * @brief Weight of the newest sample in the smoothed frame and tick
+     * times.
+     */
+    constexpr double SMOOTHING_FACTOR = 0.125;
+
+    /**
+     * @brief The allowance only grows while the smoothed frame time is below
+     * this share of the frame budget, so that it does not oscillate around
+     * the budget.
+     */
+    constexpr double GROWTH_THRESHOLD = 0.9;
+
+    // Settings, which may be changed from any thread.
+    std::atomic<float> s_frame_budget_in_milliseconds = 0.0f;
+    std::atomic<uint32_t> s_tick_budget_in_milliseconds = 0;
+    std::atomic<bool> s_is_loading = false;
+
+    // State of the feedback loop, which is only touched by the thread that
+    // ticks the platform.
+    Clock::time_point s_previous_frame_start;
+    bool s_has_previous_frame = false;
+    double s_allowance_in_milliseconds = 0.0;
+    double s_smoothed_frame_time_in_milliseconds = 0.0;
+    double s_smoothed_tick_time_in_milliseconds = 0.0;
+
+    // Copy of the state that is handed out by
+    // PEW_EOS_GetTickControllerStatistics.
+    std::mutex s_statistics_mutex;
+    TickControllerStatistics s_statistics = {};
+
+    static double smooth(double smoothed_value, double sample)
+    {
+        return smoothed_value == 0.0 ? sample : smoothed_value + (sample - smoothed_value) * SMOOTHING_FACTOR;
+    }
+
+    void configure(float frame_budget_in_milliseconds, uint32_t tick_budget_in_milliseconds)
+    {
+        set_frame_budget(frame_budget_in_milliseconds);
+        s_tick_budget_in_milliseconds.store(tick_budget_in_milliseconds);
+    }
+
+    void set_frame_budget(float frame_budget_in_milliseconds)
+    {
+        s_frame_budget_in_milliseconds.store(std::max(frame_budget_in_milliseconds, 0.0f));
+    }
+
+    void set_loading(bool is_loading)
+    {
+        s_is_loading.store(is_loading);
+    }
+
+    /**
+     * @brief Measures the time since the previous frame started, and adjusts
+     * the allowance to it.
+     *
+     * @return `true` if the frame was a hitch.
+     */
+    static bool update_allowance(Clock::time_point frame_start, double frame_budget, double tick_budget, bool is_loading)
+    {
+        bool is_hitch = false;
+        if (s_has_previous_frame)
+        {
+            const double frame_time = Milliseconds(frame_start - s_previous_frame_start).count();
+            is_hitch = frame_time > frame_budget * HITCH_FRAME_BUDGET_MULTIPLE;
+            if (!is_hitch && !is_loading)
+            {
+                s_smoothed_frame_time_in_milliseconds = smooth(s_smoothed_frame_time_in_milliseconds, frame_time);
+            }
+        }
+        s_previous_frame_start = frame_start;
+        s_has_previous_frame = true;
+
+        // The allowance never drops below a single tick.
+        const double min_allowance = tick_budget;
+        const double max_allowance = std::max(frame_budget * MAX_FRAME_BUDGET_SHARE, min_allowance);
+
+        if (is_loading || is_hitch)
+        {
+            // Whatever the frame spends, it is not spent on gameplay.
+            s_allowance_in_milliseconds = std::max(frame_budget, min_allowance);
+        }
+        else if (s_smoothed_frame_time_in_milliseconds > frame_budget)
+        {
+            s_allowance_in_milliseconds *= 0.5;
+        }
+        else if (s_smoothed_frame_time_in_milliseconds < frame_budget * GROWTH_THRESHOLD)
+        {
+            s_allowance_in_milliseconds += tick_budget;
+        }
+
+        if (!is_loading && !is_hitch)
+        {
+            s_allowance_in_milliseconds = std::clamp(s_allowance_in_milliseconds, min_allowance, max_allowance);
+        }
+
+        return is_hitch;
+    }
+
+    bool tick(EOS_HPlatform platform)
+    {
+        const double frame_budget = s_frame_budget_in_milliseconds.load();
+        if (frame_budget <= 0.0 || platform == nullptr || eos_library_helpers::EOS_Platform_Tick_ptr == nullptr)
+        {
+            return false;
+        }
+
+        const double tick_budget = s_tick_budget_in_milliseconds.load();
+        const bool is_loading = s_is_loading.load();
+
+        const Clock::time_point frame_start = Clock::now();
+        const bool is_hitch = update_allowance(frame_start, frame_budget, tick_budget, is_loading);
+
+        uint32_t tick_count = 0;
+        double time_spent = 0.0;
+        while (true)
+        {
+            const Clock::time_point tick_start = Clock::now();
+            eos_library_helpers::EOS_Platform_Tick_ptr(platform);
+            const double tick_time = Milliseconds(Clock::now() - tick_start).count();
+
+            ++tick_count;
+            time_spent += tick_time;
+            s_smoothed_tick_time_in_milliseconds = smooth(s_smoothed_tick_time_in_milliseconds, tick_time);
+
+            // Without a tick budget, a tick does all the work that is queued.
+            // With one, a tick that ends well within it has run out of work.
+            if (tick_budget <= 0.0 || tick_time < tick_budget * 0.5)
+            {
+                break;
+            }
+
+            if (tick_count == MAX_TICKS_PER_FRAME || time_spent + s_smoothed_tick_time_in_milliseconds > s_allowance_in_milliseconds)
+            {
+                break;
+            }
+        }
+
+        p2p_pump::pump(platform);
+
+        std::lock_guard lock(s_statistics_mutex);
+        s_statistics.is_enabled = 1;
+        s_statistics.is_loading = is_loading ? 1 : 0;
+        s_statistics.frame_budget_in_milliseconds = static_cast<float>(frame_budget);
+        s_statistics.allowance_in_milliseconds = static_cast<float>(s_allowance_in_milliseconds);
+        s_statistics.smoothed_frame_time_in_milliseconds = static_cast<float>(s_smoothed_frame_time_in_milliseconds);
+        s_statistics.smoothed_tick_time_in_milliseconds = static_cast<float>(s_smoothed_tick_time_in_milliseconds);
+        s_statistics.last_frame_tick_count = tick_count;
+        s_statistics.frame_count += 1;
+        s_statistics.tick_count += tick_count;
+        s_statistics.hitch_count += is_hitch ? 1 : 0;
+
+        return true;
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_TickWithinFrameBudget()
+    {
+        if (tick_driver::is_running())
+        {
+            return false;
+        }
+
+        return tick(platform_registry::get_default());
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_SetLoadingScreenActive(bool is_loading)
+    {
+        set_loading(is_loading);
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_GetTickControllerStatistics(TickControllerStatistics* statistics)
+    {
+        if (statistics == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard lock(s_statistics_mutex);
+        *statistics = s_statistics;
+        statistics->is_enabled = s_frame_budget_in_milliseconds.load() > 0.0f ? 1 : 0;
+        statistics->is_loading = s_is_loading.load() ? 1 : 0;
+    }
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pch.h>
+#include "tick_driver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "eos_library_helpers.h"
+#include "logging.h"
+#include "p2p_pump.h"
+#include "platform_registry.h"
+#include "Config/NativePlatformConfig.hpp"
+
+namespace pew::eos::tick_driver
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Live counters behind TickDriverStatistics. The counters are
+     * only written by the driver thread, and reset by
+     * PEW_EOS_ResetTickDriverStatistics.
+     */
+    struct LiveStatistics
+    {
+        std::atomic<uint32_t> is_running;
+        std::atomic<uint32_t> ticks_per_second;
+        std::atomic<uint64_t> overrun_threshold_microseconds;
+        std::atomic<uint64_t> tick_count;
+        std::atomic<uint64_t> overrun_count;
+        std::atomic<uint64_t> missed_tick_count;
+        std::atomic<uint64_t> total_tick_microseconds;
+        std::atomic<uint64_t> max_tick_microseconds;
+        std::atomic<uint64_t> max_jitter_microseconds;
+        std::atomic<uint64_t> duration_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+        std::atomic<uint64_t> jitter_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+        std::atomic<uint64_t> overrun_histogram[TICK_HISTOGRAM_BUCKET_COUNT];
+    };
+
+    LiveStatistics s_statistics;
+
+    // Serializes starting and stopping the driver.
+    std::mutex s_driver_mutex;
+    std::thread s_driver_thread;
+    std::atomic<bool> s_is_allowed = false;
+
+    // Used to wake the driver thread early when it is asked to stop.
+    std::mutex s_stop_mutex;
+    std::condition_variable s_stop_condition;
+    bool s_stop_requested = false;
+
+    static uint64_t to_microseconds(Clock::duration duration)
+    {
+        const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        return microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0;
+    }
+
+    static size_t get_histogram_bucket(uint64_t microseconds)
+    {
+        size_t bucket = 0;
+        for (uint64_t bucket_end = 32; bucket + 1 < TICK_HISTOGRAM_BUCKET_COUNT && microseconds >= bucket_end; bucket_end *= 2)
+        {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    static void increment(std::atomic<uint64_t>& counter, uint64_t amount = 1)
+    {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    static void update_max(std::atomic<uint64_t>& maximum, uint64_t value)
+    {
+        if (value > maximum.load(std::memory_order_relaxed))
+        {
+            maximum.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static void record_tick(Clock::duration jitter, Clock::duration duration, Clock::duration overrun_threshold)
+    {
+        const uint64_t jitter_microseconds = to_microseconds(jitter);
+        const uint64_t duration_microseconds = to_microseconds(duration);
+
+        increment(s_statistics.tick_count);
+        increment(s_statistics.total_tick_microseconds, duration_microseconds);
+        update_max(s_statistics.max_tick_microseconds, duration_microseconds);
+        update_max(s_statistics.max_jitter_microseconds, jitter_microseconds);
+        increment(s_statistics.duration_histogram[get_histogram_bucket(duration_microseconds)]);
+        increment(s_statistics.jitter_histogram[get_histogram_bucket(jitter_microseconds)]);
+
+        if (duration > overrun_threshold)
+        {
+            increment(s_statistics.overrun_count);
+            increment(s_statistics.overrun_histogram[get_histogram_bucket(to_microseconds(duration - overrun_threshold))]);
+        }
+    }
+
+    static void run(EOS_HPlatform platform, Clock::duration interval, Clock::duration overrun_threshold)
+    {
+        Clock::time_point scheduled_time = Clock::now();
+
+        std::unique_lock lock(s_stop_mutex);
+        while (!s_stop_condition.wait_until(lock, scheduled_time, [] { return s_stop_requested; }))
+        {
+            lock.unlock();
+
+            const Clock::time_point start_time = Clock::now();
+            eos_library_helpers::EOS_Platform_Tick_ptr(platform);
+            p2p_pump::pump(platform);
+            const Clock::time_point end_time = Clock::now();
+
+            record_tick(start_time - scheduled_time, end_time - start_time, overrun_threshold);
+
+            // The next tick is due one interval after this one was. If the
+            // driver has fallen behind by more than that, skip the ticks that
+            // were missed instead of running them back to back.
+            scheduled_time += interval;
+            if (scheduled_time < end_time)
+            {
+                const auto missed_ticks = (end_time - scheduled_time) / interval;
+                scheduled_time += missed_ticks * interval;
+                increment(s_statistics.missed_tick_count, static_cast<uint64_t>(missed_ticks));
+            }
+
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Stops the driver thread. The caller must hold s_driver_mutex.
+     */
+    static void stop_driver_thread()
+    {
+        if (!s_driver_thread.joinable())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock(s_stop_mutex);
+            s_stop_requested = true;
+        }
+        s_stop_condition.notify_all();
+        s_driver_thread.join();
+
+        s_statistics.is_running.store(0, std::memory_order_relaxed);
+        logging::log_inform("Stopped ticking the EOS platform natively.");
+    }
+
+    bool start(EOS_HPlatform platform, uint32_t ticks_per_second, uint32_t tick_budget_in_milliseconds)
+    {
+        std::lock_guard driver_lock(s_driver_mutex);
+
+        stop_driver_thread();
+
+        if (!s_is_allowed.load())
+        {
+            logging::log_warn("The tick driver is not allowed in this host, the EOS platform is not ticked natively.");
+            return false;
+        }
+
+        if (platform == nullptr || ticks_per_second == 0 || eos_library_helpers::EOS_Platform_Tick_ptr == nullptr)
+        {
+            return false;
+        }
+
+        ticks_per_second = std::min(ticks_per_second, MAX_TICKS_PER_SECOND);
+        const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1'000'000'000 / ticks_per_second));
+        const auto overrun_threshold = tick_budget_in_milliseconds > 0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::milliseconds(tick_budget_in_milliseconds))
+            : interval;
+
+        s_statistics.ticks_per_second.store(ticks_per_second, std::memory_order_relaxed);
+        s_statistics.overrun_threshold_microseconds.store(to_microseconds(overrun_threshold), std::memory_order_relaxed);
+
+        {
+            std::lock_guard lock(s_stop_mutex);
+            s_stop_requested = false;
+        }
+        s_driver_thread = std::thread(run, platform, interval, overrun_threshold);
+        s_statistics.is_running.store(1, std::memory_order_relaxed);
+
+        logging::log_inform("Ticking the EOS platform natively, " + std::to_string(ticks_per_second) + " times per second.");
+        return true;
+    }
+
+    void stop()
+    {
+        std::lock_guard driver_lock(s_driver_mutex);
+        stop_driver_thread();
+    }
+
+    bool is_allowed()
+    {
+        return s_is_allowed.load();
+    }
+
+    bool is_running()
+    {
+        return s_statistics.is_running.load(std::memory_order_relaxed) != 0;
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_AllowTickDriver(bool is_allowed)
+    {
+        std::lock_guard driver_lock(s_driver_mutex);
+        s_is_allowed = is_allowed;
+        if (!is_allowed)
+        {
+            stop_driver_thread();
+        }
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_StartTickDriver(uint32_t ticks_per_second)
+    {
+        const auto platform_config = config::Config::get<config::NativePlatformConfig>();
+        const int tick_budget_in_milliseconds = platform_config != nullptr ? platform_config->tick_budget_in_milliseconds : 0;
+
+        return start(platform_registry::get_default(), ticks_per_second, static_cast<uint32_t>(std::max(tick_budget_in_milliseconds, 0)));
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_StopTickDriver()
+    {
+        stop();
+    }
+
+    PEW_EOS_API_FUNC(bool) PEW_EOS_IsTickDriverRunning()
+    {
+        return is_running();
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_GetTickDriverStatistics(TickDriverStatistics* statistics)
+    {
+        if (statistics == nullptr)
+        {
+            return;
+        }
+
+        const auto load = [](const std::atomic<uint64_t>& counter) { return counter.load(std::memory_order_relaxed); };
+
+        statistics->is_running = s_statistics.is_running.load(std::memory_order_relaxed);
+        statistics->ticks_per_second = s_statistics.ticks_per_second.load(std::memory_order_relaxed);
+        statistics->overrun_threshold_microseconds = load(s_statistics.overrun_threshold_microseconds);
+        statistics->tick_count = load(s_statistics.tick_count);
+        statistics->overrun_count = load(s_statistics.overrun_count);
+        statistics->missed_tick_count = load(s_statistics.missed_tick_count);
+        statistics->total_tick_microseconds = load(s_statistics.total_tick_microseconds);
+        statistics->max_tick_microseconds = load(s_statistics.max_tick_microseconds);
+        statistics->max_jitter_microseconds = load(s_statistics.max_jitter_microseconds);
+
+        for (size_t bucket = 0; bucket < TICK_HISTOGRAM_BUCKET_COUNT; ++bucket)
+        {
+            statistics->duration_histogram[bucket] = load(s_statistics.duration_histogram[bucket]);
+            statistics->jitter_histogram[bucket] = load(s_statistics.jitter_histogram[bucket]);
+            statistics->overrun_histogram[bucket] = load(s_statistics.overrun_histogram[bucket]);
+        }
+    }
+
+    PEW_EOS_API_FUNC(void) PEW_EOS_ResetTickDriverStatistics()
+    {
+        const auto reset = [](std::atomic<uint64_t>& counter) { counter.store(0, std::memory_order_relaxed); };
+
+        reset(s_statistics.tick_count);
+        reset(s_statistics.overrun_count);
+        reset(s_statistics.missed_tick_count);
+        reset(s_statistics.total_tick_microseconds);
+        reset(s_statistics.max_tick_microseconds);
+        reset(s_statistics.max_jitter_microseconds);
+
+        for (size_t bucket = 0; bucket < TICK_HISTOGRAM_BUCKET_COUNT; ++bucket)
+        {
+            reset(s_statistics.duration_histogram[bucket]);
+            reset(s_statistics.jitter_histogram[bucket]);
+            reset(s_statistics.overrun_histogram[bucket]);
+        }
+    }
+}
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2024 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <pch.h>
+#include "utf_transcode.h"
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF_TRANSCODE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UTF_TRANSCODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pew::eos::string_helpers
+{
+    static constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+    /**
+     * @brief Converts the whole blocks of ASCII at the start of the input to
+     * UTF-8.
+     *
+     * @param output The buffer to write to, or `nullptr` to only count.
+     * @return The number of code units converted, which is a multiple of 8.
+     */
+    template <typename Unit>
+    static size_t convert_ascii_to_utf8(const Unit* input, size_t length, char* output, size_t capacity)
+    {
+        size_t index = 0;
+
+        if (output != nullptr && capacity < length)
+        {
+            length = capacity;
+        }
+
+#if UTF_TRANSCODE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; index + 8 <= length; index += 8)
+        {
+            __m128i narrowed;
+            if constexpr (sizeof(Unit) == 2)
+            {
+                const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16(static_cast<short>(0xFF80))), zero)) != 0xFFFF)
+                {
+                    break;
+                }
+                narrowed = _mm_packus_epi16(units, units);
+            }
+            else
+            {
+                const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+                const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index + 4));
+                const __m128i non_ascii = _mm_set1_epi32(static_cast<int>(0xFFFFFF80u));
+                const __m128i ascii = _mm_and_si128(
+                    _mm_cmpeq_epi32(_mm_and_si128(low, non_ascii), zero),
+                    _mm_cmpeq_epi32(_mm_and_si128(high, non_ascii), zero));
+                if (_mm_movemask_epi8(ascii) != 0xFFFF)
+                {
+                    break;
+                }
+                const __m128i words = _mm_packs_epi32(low, high);
+                narrowed = _mm_packus_epi16(words, words);
+            }
+
+            if (output != nullptr)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(output + index), narrowed);
+            }
+        }
+#elif UTF_TRANSCODE_NEON
+        for (; index + 8 <= length; index += 8)
+        {
+            uint8x8_t narrowed;
+            if constexpr (sizeof(Unit) == 2)
+            {
+                const uint16x8_t units = vld1q_u16(reinterpret_cast<const uint16_t*>(input + index));
+                if (vmaxvq_u16(units) >= 0x80)
+                {
+                    break;
+                }
+                narrowed = vmovn_u16(units);
+            }
+            else
+            {
+                const uint32x4_t low = vld1q_u32(reinterpret_cast<const uint32_t*>(input + index));
+                const uint32x4_t high = vld1q_u32(reinterpret_cast<const uint32_t*>(input + index + 4));
+                if (vmaxvq_u32(vorrq_u32(low, high)) >= 0x80)
+                {
+                    break;
+                }
+                narrowed = vmovn_u16(vcombine_u16(vmovn_u32(low), vmovn_u32(high)));
+            }
+
+            if (output != nullptr)
+            {
+                vst1_u8(reinterpret_cast<uint8_t*>(output + index), narrowed);
+            }
+        }
+#endif
+
+        return index;
+    }
+
+    /**
+     * @brief Converts the whole blocks of ASCII at the start of the input
+     * from UTF-8.
+     *
+     * @param output The buffer to write to, or `nullptr` to only count.
+     * @return The number of code units converted, which is a multiple of 16.
+     */
+    template <typename Unit>
+    static size_t convert_ascii_from_utf8(const char* input, size_t length, Unit* output, size_t capacity)
+    {
+        size_t index = 0;
+
+        if (output != nullptr && capacity < length)
+        {
+            length = capacity;
+        }
+
+#if UTF_TRANSCODE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; index + 16 <= length; index += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+            if (_mm_movemask_epi8(bytes) != 0)
+            {
+                break;
+            }
+
+            if (output == nullptr)
+            {
+                continue;
+            }
+
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            __m128i* destination = reinterpret_cast<__m128i*>(output + index);
+            if constexpr (sizeof(Unit) == 2)
+            {
+                _mm_storeu_si128(destination, low);
+                _mm_storeu_si128(destination + 1, high);
+            }
+            else
+            {
+                _mm_storeu_si128(destination, _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(destination + 1, _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(destination + 2, _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(destination + 3, _mm_unpackhi_epi16(high, zero));
+            }
+        }
+#elif UTF_TRANSCODE_NEON
+        for (; index + 16 <= length; index += 16)
+        {
+            const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(input + index));
+            if (vmaxvq_u8(bytes) >= 0x80)
+            {
+                break;
+            }
+
+            if (output == nullptr)
+            {
+                continue;
+            }
+
+            const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+            if constexpr (sizeof(Unit) == 2)
+            {
+                uint16_t* destination = reinterpret_cast<uint16_t*>(output + index);
+                vst1q_u16(destination, low);
+                vst1q_u16(destination + 8, high);
+            }
+            else
+            {
+                uint32_t* destination = reinterpret_cast<uint32_t*>(output + index);
+                vst1q_u32(destination, vmovl_u16(vget_low_u16(low)));
+                vst1q_u32(destination + 4, vmovl_u16(vget_high_u16(low)));
+                vst1q_u32(destination + 8, vmovl_u16(vget_low_u16(high)));
+                vst1q_u32(destination + 12, vmovl_u16(vget_high_u16(high)));
+            }
+        }
+#endif
+
+        return index;
+    }
+
+    /**
+     * @brief Reads one code point of UTF-16 or UTF-32.
+     *
+     * @param length Receives the number of code units that were read.
+     * @return The code point, or REPLACEMENT_CHARACTER with `valid` cleared
+     * if the input is not a valid code point.
+     */
+    template <typename Unit>
+    static char32_t decode_wide_code_point(const Unit* input, size_t available, size_t& length, bool& valid)
+    {
+        const char32_t unit = static_cast<char32_t>(input[0]);
+        length = 1;
+
+        if constexpr (sizeof(Unit) == 2)
+        {
+            if (unit < 0xD800 || unit > 0xDFFF)
+            {
+                return unit;
+            }
+
+            if (unit <= 0xDBFF && available > 1)
+            {
+                const char32_t low_surrogate = static_cast<char32_t>(input[1]);
+                if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF)
+                {
+                    length = 2;
+                    return 0x10000 + ((unit - 0xD800) << 10) + (low_surrogate - 0xDC00);
+                }
+            }
+        }
+        else if (unit < 0xD800 || (unit > 0xDFFF && unit <= 0x10FFFF))
+        {
+            return unit;
+        }
+
+        valid = false;
+        return REPLACEMENT_CHARACTER;
+    }
+
+    /**
+     * @brief Reads one code point of UTF-8. An invalid sequence is consumed
+     * up to the first byte that cannot continue it (its "maximal subpart"),
+     * so that it is replaced by a single U+FFFD.
+     */
+    static char32_t decode_utf8_code_point(const unsigned char* input, size_t available, size_t& length, bool& valid)
+    {
+        const unsigned char lead = input[0];
+        length = 1;
+
+        if (lead < 0x80)
+        {
+            return lead;
+        }
+
+        size_t continuation_count;
+        char32_t code_point;
+
+        // The first continuation byte is restricted further for some lead
+        // bytes, which rules out overlong encodings, surrogates and code
+        // points above U+10FFFF.
+        unsigned char lower = 0x80;
+        unsigned char upper = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            continuation_count = 1;
+            code_point = lead & 0x1F;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            continuation_count = 2;
+            code_point = lead & 0x0F;
+            if (lead == 0xE0) { lower = 0xA0; }
+            if (lead == 0xED) { upper = 0x9F; }
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            continuation_count = 3;
+            code_point = lead & 0x07;
+            if (lead == 0xF0) { lower = 0x90; }
+            if (lead == 0xF4) { upper = 0x8F; }
+        }
+        else
+        {
+            valid = false;
+            return REPLACEMENT_CHARACTER;
+        }
+
+        for (size_t index = 0; index < continuation_count; ++index)
+        {
+            if (length >= available || input[length] < lower || input[length] > upper)
+            {
+                valid = false;
+                return REPLACEMENT_CHARACTER;
+            }
+
+            code_point = (code_point << 6) | (input[length] & 0x3F);
+            ++length;
+            lower = 0x80;
+            upper = 0xBF;
+        }
+
+        return code_point;
+    }
+
+    template <typename Unit>
+    static TranscodeResult transcode_to_utf8(const Unit* input, size_t length, char* output, size_t capacity)
+    {
+        TranscodeResult result = { 0, 0, true };
+
+        while (result.read < length)
+        {
+            const size_t ascii_length = convert_ascii_to_utf8(input + result.read, length - result.read,
+                output != nullptr ? output + result.written : nullptr, capacity - result.written);
+            result.read += ascii_length;
+            result.written += ascii_length;
+
+            if (result.read >= length)
+            {
+                break;
+            }
+
+            size_t code_point_length;
+            const char32_t code_point = decode_wide_code_point(input + result.read, length - result.read, code_point_length, result.valid);
+
+            char encoded[4];
+            size_t encoded_length;
+            if (code_point < 0x80)
+            {
+                encoded[0] = static_cast<char>(code_point);
+                encoded_length = 1;
+            }
+            else if (code_point < 0x800)
+            {
+                encoded[0] = static_cast<char>(0xC0 | (code_point >> 6));
+                encoded[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+                encoded_length = 2;
+            }
+            else if (code_point < 0x10000)
+            {
+                encoded[0] = static_cast<char>(0xE0 | (code_point >> 12));
+                encoded[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                encoded[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+                encoded_length = 3;
+            }
+            else
+            {
+                encoded[0] = static_cast<char>(0xF0 | (code_point >> 18));
+                encoded[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                encoded[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                encoded[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+                encoded_length = 4;
+            }
+
+            if (output != nullptr)
+            {
+                if (capacity - result.written < encoded_length)
+                {
+                    break;
+                }
+
+                for (size_t index = 0; index < encoded_length; ++index)
+                {
+                    output[result.written + index] = encoded[index];
+                }
+            }
+
+            result.read += code_point_length;
+            result.written += encoded_length;
+        }
+
+        return result;
+    }
+
+    template <typename Unit>
+    static TranscodeResult transcode_from_utf8(const char* input, size_t length, Unit* output, size_t capacity)
+    {
+        TranscodeResult result = { 0, 0, true };
+
+        while (result.read < length)
+        {
+            const size_t ascii_length = convert_ascii_from_utf8(input + result.read, length - result.read,
+                output != nullptr ? output + result.written : nullptr, capacity - result.written);
+            result.read += ascii_length;
+            result.written += ascii_length;
+
+            if (result.read >= length)
+            {
+                break;
+            }
+
+            size_t code_point_length;
+            const char32_t code_point = decode_utf8_code_point(reinterpret_cast<const unsigned char*>(input + result.read),
+                length - result.read, code_point_length, result.valid);
+
+            Unit encoded[2];
+            size_t encoded_length = 1;
+            if constexpr (sizeof(Unit) == 2)
+            {
+                if (code_point >= 0x10000)
+                {
+                    encoded[0] = static_cast<Unit>(0xD800 + ((code_point - 0x10000) >> 10));
+                    encoded[1] = static_cast<Unit>(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+                    encoded_length = 2;
+                }
+                else
+                {
+                    encoded[0] = static_cast<Unit>(code_point);
+                }
+            }
+            else
+            {
+                encoded[0] = static_cast<Unit>(code_point);
+            }
+
+            if (output != nullptr)
+            {
+                if (capacity - result.written < encoded_length)
+                {
+                    break;
+                }
+
+                output[result.written] = encoded[0];
+                if (encoded_length == 2)
+                {
+                    output[result.written + 1] = encoded[1];
+                }
+            }
+
+            result.read += code_point_length;
+            result.written += encoded_length;
+        }
+
+        return result;
+    }
+
+    TranscodeResult utf16_to_utf8(const char16_t* input, size_t length, char* output, size_t capacity)
+    {
+        return transcode_to_utf8(input, length, output, capacity);
+    }
+
+    TranscodeResult utf32_to_utf8(const char32_t* input, size_t length, char* output, size_t capacity)
+    {
+        return transcode_to_utf8(input, length, output, capacity);
+    }
+
+    TranscodeResult wide_to_utf8(const wchar_t* input, size_t length, char* output, size_t capacity)
+    {
+        return transcode_to_utf8(input, length, output, capacity);
+    }
+
+    TranscodeResult utf8_to_utf16(const char* input, size_t length, char16_t* output, size_t capacity)
+    {
+        return transcode_from_utf8(input, length, output, capacity);
+    }
+
+    TranscodeResult utf8_to_utf32(const char* input, size_t length, char32_t* output, size_t capacity)
+    {
+        return transcode_from_utf8(input, length, output, capacity);
+    }
+
+    TranscodeResult utf8_to_wide(const char* input, size_t length, wchar_t* output, size_t capacity)
+    {
+        return transcode_from_utf8(input, length, output, capacity);
+    }
+}